@@ -0,0 +1,105 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "../src/config.h"
+#include "../src/escenario.h"
+#include "escenarios.h"
+
+static double ahoraMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Uso: bench_config [monstruos] [repeticiones]
+int main(int argc, char **argv) {
+    int monstruos = (argc > 1) ? atoi(argv[1]) : 50000;
+    int reps = (argc > 2) ? atoi(argv[2]) : 5;
+    const char *ruta = "/tmp/t2_bench_config.txt";
+    if (reps < 1) reps = 1;
+
+    ParamsEscenario p = { 1000, 1000, 5, monstruos, MAX_PATH, 42, 0, 0 };
+    if (generarEscenario(ruta, &p) != 0) return 1;
+
+    struct stat st;
+    stat(ruta, &st);
+    double mb = st.st_size / (1024.0 * 1024.0);
+
+    double mejor = 1e30, total = 0;
+    GameConfig cfg;
+    for (int r = 0; r < reps; ++r) {
+        double t0 = ahoraMs();
+        if (leerConfig(ruta, &cfg) != 0) return 1;
+        double dt = ahoraMs() - t0;
+
+        if (cfg.monster_count != monstruos || cfg.heroes[0].path_len != MAX_PATH) {
+            printf("[ERROR] Config leida no coincide (%d monstruos, path %d)\n",
+                   cfg.monster_count, cfg.heroes[0].path_len);
+            liberarConfig(&cfg);
+            return 1;
+        }
+        liberarConfig(&cfg);
+
+        total += dt;
+        if (dt < mejor) mejor = dt;
+    }
+
+    printf("=== bench_config ===\n");
+    printf("Archivo: %s (%.2f MB, %d heroes, %d monstruos, path %d)\n",
+           ruta, mb, p.heroes, monstruos, p.path_len);
+    printf("leerConfig (texto): mejor %.2f ms, promedio %.2f ms (%d reps), %.1f MB/s\n",
+           mejor, total / reps, reps, mb / (mejor / 1e3));
+
+    // Mismo escenario convertido a binario
+    const char *rutaBin = "/tmp/t2_bench_config.bin";
+    if (leerConfig(ruta, &cfg) != 0) return 1;
+    int r = guardarEscenario(rutaBin, &cfg);
+    liberarConfig(&cfg);
+    remove(ruta);
+    if (r != 0) return 1;
+
+    mejor = 1e30;
+    total = 0;
+    for (int i = 0; i < reps; ++i) {
+        double t0 = ahoraMs();
+        if (leerConfig(rutaBin, &cfg) != 0) return 1;
+        double dt = ahoraMs() - t0;
+        if (cfg.monster_count != monstruos) {
+            printf("[ERROR] Escenario binario no coincide (%d monstruos)\n", cfg.monster_count);
+            liberarConfig(&cfg);
+            return 1;
+        }
+        liberarConfig(&cfg);
+
+        total += dt;
+        if (dt < mejor) mejor = dt;
+    }
+    stat(rutaBin, &st);
+    printf("leerConfig (binario, %.2f MB): mejor %.3f ms, promedio %.3f ms\n",
+           st.st_size / (1024.0 * 1024.0), mejor, total / reps);
+
+    remove(rutaBin);
+
+    // Raid: muchos heroes en grupos que comparten path
+    ParamsEscenario raid = { 1000, 1000, 0, 0, MAX_PATH, 7, 100, 1000 };
+    if (generarEscenario(ruta, &raid) != 0) return 1;
+    double t0 = ahoraMs();
+    if (leerConfig(ruta, &cfg) != 0) return 1;
+    double dt = ahoraMs() - t0;
+    remove(ruta);
+
+    size_t mem = (size_t)cfg.hero_count * sizeof(Hero) + (size_t)cfg.ruta_count * sizeof(Ruta) +
+                 (size_t)cfg.seg_count * sizeof(Segmento);
+    size_t inline_ = (size_t)cfg.hero_count * (sizeof(Hero) + MAX_PATH * sizeof(Point));
+    printf("Raid: %d heroes en %d grupos, %d rutas, %d tramos (%.1f puntos/tramo), leida en %.2f ms\n",
+           cfg.hero_count, raid.grupos, cfg.ruta_count, cfg.seg_count,
+           cfg.seg_count ? (double)raid.grupos * MAX_PATH / cfg.seg_count : 0.0, dt);
+    printf("      heroes + rutas: %.2f MB (con el path dentro de cada heroe serian %.2f MB)\n",
+           mem / (1024.0 * 1024.0), inline_ / (1024.0 * 1024.0));
+    int r2 = cfg.hero_count != raid.grupos * raid.por_grupo;
+    if (r2) printf("[ERROR] Raid leida con %d heroes\n", cfg.hero_count);
+    liberarConfig(&cfg);
+    return r2;
+}
@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/config.h"
+#include "../src/flujo.h"
+
+static double ahoraMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static unsigned semilla = 7;
+static unsigned azar(void) {
+    semilla = semilla * 1103515245u + 12345u;
+    return (semilla >> 8) & 0xffffff;
+}
+
+// ---- A* individual (lo que haria cada monstruo sin campo compartido) ----
+
+typedef struct { uint32_t f; int celda; } NodoHeap;
+
+typedef struct {
+    int w, h;
+    const uint8_t *terreno;
+    uint32_t *g;
+    uint32_t *marca;       // generacion en que g es valido (evita limpiar todo)
+    uint32_t gen;
+    NodoHeap *heap;
+    int nheap, capheap;
+} AEstrella;
+
+static void heapPush(AEstrella *a, uint32_t f, int celda) {
+    if (a->nheap == a->capheap) {
+        a->capheap = a->capheap ? a->capheap * 2 : 4096;
+        a->heap = realloc(a->heap, (size_t)a->capheap * sizeof(NodoHeap));
+    }
+    int i = a->nheap++;
+    while (i > 0 && a->heap[(i - 1) / 2].f > f) { a->heap[i] = a->heap[(i - 1) / 2]; i = (i - 1) / 2; }
+    a->heap[i].f = f;
+    a->heap[i].celda = celda;
+}
+
+static NodoHeap heapPop(AEstrella *a) {
+    NodoHeap top = a->heap[0], ult = a->heap[--a->nheap];
+    int i = 0;
+    for (;;) {
+        int h = 2 * i + 1;
+        if (h >= a->nheap) break;
+        if (h + 1 < a->nheap && a->heap[h + 1].f < a->heap[h].f) h++;
+        if (a->heap[h].f >= ult.f) break;
+        a->heap[i] = a->heap[h];
+        i = h;
+    }
+    if (a->nheap > 0) a->heap[i] = ult;
+    return top;
+}
+
+static int manhattan(int w, int a, int b) {
+    return abs(a % w - b % w) + abs(a / w - b / w);
+}
+
+// Devuelve el costo del camino (o UINT32_MAX), solo para medir el tiempo
+static uint32_t buscarAEstrella(AEstrella *a, int desde, int hasta) {
+    a->gen++;
+    a->nheap = 0;
+    a->g[desde] = 0;
+    a->marca[desde] = a->gen;
+    heapPush(a, (uint32_t)manhattan(a->w, desde, hasta), desde);
+
+    while (a->nheap > 0) {
+        NodoHeap n = heapPop(a);
+        int v = n.celda;
+        if (v == hasta) return a->g[v];
+        uint32_t gv = a->g[v];
+        if (n.f != gv + (uint32_t)manhattan(a->w, v, hasta)) continue;
+
+        int x = v % a->w, y = v / a->w;
+        int vec[4] = { x + 1 < a->w ? v + 1 : -1, x > 0 ? v - 1 : -1,
+                       y + 1 < a->h ? v + a->w : -1, y > 0 ? v - a->w : -1 };
+        for (int k = 0; k < 4; ++k) {
+            int u = vec[k];
+            if (u < 0 || a->terreno[u] == 0) continue;
+            uint32_t ng = gv + a->terreno[u];
+            if (a->marca[u] != a->gen || ng < a->g[u]) {
+                a->g[u] = ng;
+                a->marca[u] = a->gen;
+                heapPush(a, ng + (uint32_t)manhattan(a->w, u, hasta), u);
+            }
+        }
+    }
+    return UINT32_MAX;
+}
+
+// ---------------------------------------------------------------------------
+
+static int celdaLibre(const uint8_t *terreno, int w, int h) {
+    for (;;) {
+        int c = (int)(azar() % (unsigned)(w * h));
+        if (terreno[c] != 0) return c;
+    }
+}
+
+static void correr(int lado, int monstruos, int pasos, int muestrasAE) {
+    GameConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.width = cfg.height = lado;
+    cfg.hero_count = 1;
+
+    size_t celdas = (size_t)lado * (size_t)lado;
+    cfg.terreno = malloc(celdas);
+    memset(cfg.terreno, 1, celdas);
+
+    // ~20% de muros en segmentos cortos y algo de terreno caro
+    for (size_t i = 0; i < celdas / 40; ++i) {
+        int x = (int)(azar() % (unsigned)lado), y = (int)(azar() % (unsigned)lado);
+        int largo = 4 + (int)(azar() % 12), horizontal = azar() % 2;
+        for (int k = 0; k < largo; ++k) {
+            int cx = horizontal ? x + k : x, cy = horizontal ? y : y + k;
+            if (cx < lado && cy < lado) cfg.terreno[(size_t)cy * lado + cx] = 0;
+        }
+    }
+    for (size_t i = 0; i < celdas / 20; ++i) {
+        size_t c = azar() % celdas;
+        if (cfg.terreno[c]) cfg.terreno[c] = (uint8_t)(2 + azar() % 4);
+    }
+
+    Point *pos = malloc((size_t)monstruos * sizeof(Point));
+    for (int i = 0; i < monstruos; ++i) {
+        int c = celdaLibre(cfg.terreno, lado, lado);
+        pos[i].x = c % lado;
+        pos[i].y = c / lado;
+    }
+    int hc = celdaLibre(cfg.terreno, lado, lado);
+    Point heroe = { hc % lado, hc / lado };
+
+    // Campo de flujo: el heroe se mueve cada tick y todos los monstruos dan un paso
+    Flujos f;
+    iniciarFlujos(&f, &cfg);
+    double t0 = ahoraMs(), tReconstruir = 0;
+    for (int t = 0; t < pasos; ++t) {
+        Point sig = heroe;
+        for (int intento = 0; intento < 8; ++intento) {
+            Point q = heroe;
+            switch (azar() % 4) { case 0: q.x++; break; case 1: q.x--; break; case 2: q.y++; break; default: q.y--; }
+            if (q.x >= 0 && q.y >= 0 && q.x < lado && q.y < lado && cfg.terreno[(size_t)q.y * lado + q.x]) { sig = q; break; }
+        }
+        heroe = sig;
+
+        double r0 = ahoraMs();
+        pasoFlujo(&f, heroe, pos[0]);          // primera consulta paga la reconstruccion
+        tReconstruir += ahoraMs() - r0;
+        for (int i = 0; i < monstruos; ++i) pos[i] = pasoFlujo(&f, heroe, pos[i]);
+    }
+    double tFlujo = ahoraMs() - t0;
+    double tConsultas = tFlujo - tReconstruir;
+
+    // A* individual para una muestra de monstruos
+    AEstrella a = { lado, lado, cfg.terreno, NULL, NULL, 0, NULL, 0, 0 };
+    a.g = malloc(celdas * sizeof(uint32_t));
+    a.marca = calloc(celdas, sizeof(uint32_t));
+    int muestras = muestrasAE < monstruos ? muestrasAE : monstruos;
+    int hcelda = heroe.y * lado + heroe.x;
+    double a0 = ahoraMs();
+    for (int i = 0; i < muestras; ++i) buscarAEstrella(&a, pos[i].y * lado + pos[i].x, hcelda);
+    double porBusqueda = (ahoraMs() - a0) / (muestras > 0 ? muestras : 1);
+
+    printf("%5dx%-5d %8d %10.2f %12.3f %12.1f %14.3f %14.1f\n",
+           lado, lado, monstruos,
+           tFlujo / pasos, tReconstruir / pasos,
+           tConsultas * 1e6 / ((double)pasos * monstruos),
+           porBusqueda, porBusqueda * monstruos);
+
+    free(a.g); free(a.marca); free(a.heap);
+    liberarFlujos(&f);
+    free(pos);
+    free(cfg.terreno);
+}
+
+// Uso: bench_flujo [monstruos] [ticks]
+int main(int argc, char **argv) {
+    int monstruos = (argc > 1) ? atoi(argv[1]) : 10000;
+    int pasos = (argc > 2) ? atoi(argv[2]) : 20;
+    if (pasos < 1) pasos = 1;
+
+    printf("=== bench_flujo: %d monstruos persiguiendo a 1 heroe, %d ticks ===\n", monstruos, pasos);
+    printf("%-11s %8s %10s %12s %12s %14s %14s\n", "grilla", "monstr.",
+           "ms/tick", "rearmar(ms)", "ns/consulta", "A* (ms/busq)", "A* (ms/tick)");
+    int lados[] = { 256, 1024, 2048 };
+    for (size_t i = 0; i < sizeof(lados) / sizeof(lados[0]); ++i) correr(lados[i], monstruos, pasos, 50);
+    return 0;
+}
@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../src/config.h"
+#include "../src/escenario.h"
+#include "../src/eventos.h"
+#include "../src/motor.h"
+#include "../src/perfil.h"
+#include "../src/ejecucion.h"
+#include "escenarios.h"
+
+typedef struct {
+    double ms;
+    uint64_t ticks;
+    uint64_t ops;
+    uint64_t locks;
+    uint64_t contendidos;
+} Resultado;
+
+// Corre el escenario desde cero; hilos == 0 es el modo determinista (sin lock)
+static int correr(const char *ruta, int hilos, uint32_t ticks, FILE *nulo,
+                  Resultado *res, int mostrarPerfil) {
+    GameConfig cfg;
+    if (leerConfig(ruta, &cfg) != 0) return 1;
+    cfg.juegoActivo = 1;
+    pthread_mutex_init(&cfg.mutex, NULL);
+
+    RegistroEventos eventos;
+    Motor mt;
+    Perfil perfil;
+    int r = iniciarEventos(&eventos, LOG_SILENCIOSO, nulo, cfg.hero_count + cfg.monster_count,
+                           hilos > 0 ? hilos : 1);
+    if (r == 0) {
+        r = iniciarMotor(&mt, &cfg, &eventos);
+        if (r == 0) r = iniciarPerfil(&perfil, hilos > 0 ? hilos : 1);
+        if (r == 0) {
+            mt.perfil = &perfil;
+            if (hilos > 0) r = correrPool(&mt, hilos, ticks);
+            else correrDeterminista(&mt, ticks);
+            perfil.fin_ns = perfilAhora();
+
+            PerfilHilo total;
+            sumarPerfil(&perfil, &total);
+            res->ms = (perfil.fin_ns - perfil.inicio_ns) / 1e6;
+            res->ticks = perfil.rondas;
+            res->ops = mt.ops;
+            res->locks = total.locks;
+            res->contendidos = total.contendidos;
+            if (mostrarPerfil) imprimirPerfil(&perfil, mt.ops, stdout);
+            liberarPerfil(&perfil);
+        }
+        liberarMotor(&mt);
+        terminarEventos(&eventos);
+    }
+    pthread_mutex_destroy(&cfg.mutex);
+    liberarConfig(&cfg);
+    return r;
+}
+
+// Uso: bench_motor [ticks] [hilos_max]
+int main(int argc, char **argv) {
+    uint32_t ticks = (argc > 1) ? (uint32_t)atoi(argv[1]) : 50;
+    int hilosMax = (argc > 2) ? atoi(argv[2]) : 8;
+    if (hilosMax < 1) hilosMax = 1;
+
+    // misma densidad aproximada de monstruos en los tres primeros; el ultimo
+    // es un raid de 20 grupos de 250 heroes con path compartido
+    const struct { int entidades; int lado; int grupos; int por_grupo; } tamanios[] = {
+        { 10, 32, 0, 0 }, { 1000, 200, 0, 0 }, { 100000, 1000, 0, 0 }, { 6000, 200, 20, 250 }
+    };
+    const char *rutaTxt = "/tmp/t2_bench_motor.txt";
+    const char *rutaBin = "/tmp/t2_bench_motor.bin";
+
+    FILE *nulo = fopen("/dev/null", "w");
+    if (!nulo) return 1;
+
+    printf("=== bench_motor (%u ticks, %ld CPUs) ===\n", ticks, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%10s %6s %7s %11s %11s %12s %8s %11s\n",
+           "entidades", "hilos", "ticks", "tiempo ms", "ticks/s", "ops/s", "speedup", "contencion");
+
+    for (size_t t = 0; t < sizeof(tamanios) / sizeof(tamanios[0]); ++t) {
+        int sueltos = tamanios[t].grupos ? 0 : 5;
+        int heroes = sueltos + tamanios[t].grupos * tamanios[t].por_grupo;
+        ParamsEscenario p = { tamanios[t].lado, tamanios[t].lado, sueltos,
+                              tamanios[t].entidades - heroes, MAX_PATH, 42,
+                              tamanios[t].grupos, tamanios[t].por_grupo };
+        if (generarEscenario(rutaTxt, &p) != 0) return 1;
+
+        // se corre desde el binario: cada corrida vuelve a mapear el estado inicial
+        GameConfig cfg;
+        if (leerConfig(rutaTxt, &cfg) != 0) return 1;
+        int r = guardarEscenario(rutaBin, &cfg);
+        liberarConfig(&cfg);
+        remove(rutaTxt);
+        if (r != 0) return 1;
+
+        Resultado base;
+        if (correr(rutaBin, 0, ticks, nulo, &base, 0) != 0) return 1;
+        printf("%10d %6s %7llu %11.2f %11.1f %12.0f %8s %11s\n", tamanios[t].entidades, "det",
+               (unsigned long long)base.ticks, base.ms, base.ticks / (base.ms / 1e3),
+               base.ops / (base.ms / 1e3), "-", "-");
+
+        double ms1 = 0;
+        for (int h = 1; h <= hilosMax; h *= 2) {
+            Resultado res;
+            if (correr(rutaBin, h, ticks, nulo, &res, 0) != 0) return 1;
+            if (h == 1) ms1 = res.ms;
+            printf("%10d %6d %7llu %11.2f %11.1f %12.0f %7.2fx %10.2f%%\n", tamanios[t].entidades, h,
+                   (unsigned long long)res.ticks, res.ms, res.ticks / (res.ms / 1e3),
+                   res.ops / (res.ms / 1e3), ms1 / res.ms,
+                   res.locks ? 100.0 * res.contendidos / res.locks : 0.0);
+        }
+    }
+
+    // desglose por fase del ultimo escenario con un hilo
+    size_t ult = sizeof(tamanios) / sizeof(tamanios[0]) - 1;
+    printf("\nDesglose por fase, %d entidades (%d grupos de %d heroes), 1 hilo:\n",
+           tamanios[ult].entidades, tamanios[ult].grupos, tamanios[ult].por_grupo);
+    Resultado res;
+    int r = correr(rutaBin, 1, ticks, nulo, &res, 1);
+    remove(rutaBin);
+    fclose(nulo);
+    return r;
+}
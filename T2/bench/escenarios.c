@@ -0,0 +1,70 @@
+#include "escenarios.h"
+
+static unsigned siguiente(unsigned *s) {
+    *s = *s * 1103515245u + 12345u;
+    return (*s >> 16) & 0x7fff;
+}
+
+static void escribirPath(FILE *f, const ParamsEscenario *p, unsigned *s, int x, int y) {
+    for (int i = 0; i < p->path_len; ++i) {
+        if (siguiente(s) % 2) x += (x + 1 < p->width) ? 1 : -1;
+        else y += (y + 1 < p->height) ? 1 : -1;
+        fprintf(f, (i % 16 == 15) ? " (%d,%d)\n" : " (%d,%d)", x, y);
+    }
+    fprintf(f, "\n\n");
+}
+
+// Alterna entre los formatos HERO_1_HP y HERO 1 HP para ejercitar ambos
+void escribirEscenario(FILE *f, const ParamsEscenario *p) {
+    unsigned s = p->semilla;
+
+    fprintf(f, "# escenario sintetico: %d heroes, %d monstruos\n", p->heroes, p->monsters);
+    fprintf(f, "GRID_SIZE %d %d\n", p->width, p->height);
+    fprintf(f, "MONSTER_COUNT %d\n\n", p->monsters);
+
+    for (int h = 1; h <= p->heroes; ++h) {
+        int x = (int)(siguiente(&s) % (unsigned)p->width);
+        int y = (int)(siguiente(&s) % (unsigned)p->height);
+        const char *sep = (h % 2) ? "_" : " ";
+
+        fprintf(f, "HERO%s%d%sHP %d\n", sep, h, sep, 100 + (int)(siguiente(&s) % 100));
+        fprintf(f, "HERO%s%d%sATTACK_DAMAGE %d\n", sep, h, sep, 10 + (int)(siguiente(&s) % 20));
+        fprintf(f, "HERO%s%d%sATTACK_RANGE %d\n", sep, h, sep, 1 + (int)(siguiente(&s) % 3));
+        fprintf(f, "HERO%s%d%sSTART %d %d\n", sep, h, sep, x, y);
+        fprintf(f, "HERO%s%d%sPATH", sep, h, sep);
+        escribirPath(f, p, &s, x, y);
+    }
+
+    for (int g = 1; g <= p->grupos; ++g) {
+        int x = (int)(siguiente(&s) % (unsigned)p->width);
+        int y = (int)(siguiente(&s) % (unsigned)p->height);
+        fprintf(f, "GROUP_%d_COUNT %d\n", g, p->por_grupo);
+        fprintf(f, "GROUP_%d_HP %d\n", g, 100 + (int)(siguiente(&s) % 100));
+        fprintf(f, "GROUP_%d_ATTACK_DAMAGE %d\n", g, 10 + (int)(siguiente(&s) % 20));
+        fprintf(f, "GROUP_%d_ATTACK_RANGE %d\n", g, 1 + (int)(siguiente(&s) % 3));
+        fprintf(f, "GROUP_%d_START %d %d\n", g, x, y);
+        fprintf(f, "GROUP_%d_PATH", g);
+        escribirPath(f, p, &s, x, y);
+    }
+
+    for (int m = 1; m <= p->monsters; ++m) {
+        const char *sep = (m % 2) ? "_" : " ";
+        fprintf(f, "MONSTER%s%d%sHP %d\n", sep, m, sep, 40 + (int)(siguiente(&s) % 60));
+        fprintf(f, "MONSTER%s%d%sATTACK_DAMAGE %d\n", sep, m, sep, 5 + (int)(siguiente(&s) % 15));
+        fprintf(f, "MONSTER%s%d%sVISION_RANGE %d\n", sep, m, sep, 2 + (int)(siguiente(&s) % 6));
+        fprintf(f, "MONSTER%s%d%sATTACK_RANGE %d\n", sep, m, sep, 1 + (int)(siguiente(&s) % 2));
+        fprintf(f, "MONSTER%s%d%sCOORDS %d %d\n", sep, m, sep,
+                (int)(siguiente(&s) % (unsigned)p->width), (int)(siguiente(&s) % (unsigned)p->height));
+    }
+}
+
+int generarEscenario(const char *ruta, const ParamsEscenario *p) {
+    FILE *f = fopen(ruta, "w");
+    if (!f) {
+        printf("No se pudo crear el escenario: %s\n", ruta);
+        return 1;
+    }
+    escribirEscenario(f, p);
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef ESCENARIOS_H
+#define ESCENARIOS_H
+
+#include <stdio.h>
+
+// Parametros de un escenario sintetico para benchmarks
+typedef struct {
+    int width;
+    int height;
+    int heroes;
+    int monsters;
+    int path_len;
+    unsigned semilla;
+    int grupos;        // grupos de heroes con path compartido (ademas de 'heroes')
+    int por_grupo;
+} ParamsEscenario;
+
+void escribirEscenario(FILE *f, const ParamsEscenario *p);
+int generarEscenario(const char *ruta, const ParamsEscenario *p);
+
+#endif
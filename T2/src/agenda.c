@@ -0,0 +1,128 @@
+#include "agenda.h"
+#include <stdlib.h>
+#include <string.h>
+
+int iniciarAgenda(Agenda *a, const GameConfig *cfg, int nentidades) {
+    memset(a, 0, sizeof(*a));
+    a->nentidades = nentidades;
+    a->nmonstruos = cfg->monster_count;
+    a->width = cfg->width;
+    a->height = cfg->height;
+
+    // sin grilla todo cae en una sola zona
+    a->lado = AGENDA_ZONA;
+    do {
+        a->zw = a->width > 0 ? (a->width + a->lado - 1) / a->lado : 1;
+        a->zh = a->height > 0 ? (a->height + a->lado - 1) / a->lado : 1;
+        if ((size_t)a->zw * (size_t)a->zh <= AGENDA_MAX_ZONAS) break;
+        a->lado *= 2;
+    } while (1);
+
+    size_t n = (size_t)(nentidades > 0 ? nentidades : 1);
+    size_t nm = (size_t)(a->nmonstruos > 0 ? a->nmonstruos : 1);
+    a->listos = calloc((n + 63) / 64, sizeof(uint64_t));
+    a->zonas = calloc((size_t)a->zw * (size_t)a->zh, sizeof(Zona));
+    a->gen = calloc(nm, sizeof(uint32_t));
+    a->dormido_en = malloc(n * sizeof(uint32_t));
+    if (!a->listos || !a->zonas || !a->gen || !a->dormido_en) {
+        printf("Sin memoria para la agenda de entidades.\n");
+        liberarAgenda(a);
+        return 1;
+    }
+    for (size_t i = 0; i < n; ++i) a->dormido_en[i] = SIN_DORMIR;
+    return 0;
+}
+
+void liberarAgenda(Agenda *a) {
+    if (a->zonas)
+        for (size_t z = 0; z < (size_t)a->zw * (size_t)a->zh; ++z) free(a->zonas[z].v);
+    free(a->listos);
+    free(a->zonas);
+    free(a->gen);
+    free(a->dormido_en);
+    a->listos = NULL;
+    a->zonas = NULL;
+    a->gen = NULL;
+    a->dormido_en = NULL;
+}
+
+// Escriben con cfg->mutex tomado; el pool lee los bits sin el lock y vuelve
+// a mirar el estado de la entidad ya con el lock
+void marcarListo(Agenda *a, int entidad, int listo) {
+    uint64_t bit = 1ull << (entidad & 63);
+    if (listo) atomic_fetch_or_explicit(&a->listos[entidad >> 6], bit, memory_order_relaxed);
+    else atomic_fetch_and_explicit(&a->listos[entidad >> 6], ~bit, memory_order_relaxed);
+}
+
+int siguienteListo(const Agenda *a, int desde) {
+    if (desde >= a->nentidades) return -1;
+    int nw = (a->nentidades + 63) / 64;
+    int w = desde >> 6;
+    uint64_t bits = atomic_load_explicit(&a->listos[w], memory_order_relaxed) & (~0ull << (desde & 63));
+    while (!bits) {
+        if (++w >= nw) return -1;
+        bits = atomic_load_explicit(&a->listos[w], memory_order_relaxed);
+    }
+    return w * 64 + __builtin_ctzll(bits);
+}
+
+static int zonaCoord(int v, int max, int lado) {
+    if (max <= 0) return 0;
+    if (v < 0) v = 0;
+    if (v >= max) v = max - 1;
+    return v / lado;
+}
+
+Zona *zonaDe(Agenda *a, Point p) {
+    int zx = zonaCoord(p.x, a->width, a->lado);
+    int zy = zonaCoord(p.y, a->height, a->lado);
+    return &a->zonas[(size_t)zy * (size_t)a->zw + (size_t)zx];
+}
+
+// antes de crecer se tiran las anotaciones de monstruos que ya despertaron
+static int anotar(Agenda *a, Zona *z, Suscripcion s) {
+    if (z->n == z->cap) {
+        int k = 0;
+        for (int i = 0; i < z->n; ++i)
+            if (z->v[i].gen == a->gen[z->v[i].monstruo]) z->v[k++] = z->v[i];
+        z->n = k;
+    }
+    if (z->n == z->cap) {
+        int cap = z->cap ? z->cap * 2 : 16;
+        Suscripcion *nuevo = realloc(z->v, (size_t)cap * sizeof(Suscripcion));
+        if (!nuevo) return 1;
+        z->v = nuevo;
+        z->cap = cap;
+    }
+    z->v[z->n++] = s;
+    return 0;
+}
+
+// Anota al monstruo en las zonas del cuadrado que encierra su rombo de vision.
+// Si falta memoria anula lo anotado y devuelve 1 (el monstruo sigue despierto).
+int suscribir(Agenda *a, const Monster *m, int idx) {
+    if (m->vision < 0) return 0;
+    long long v = m->vision;
+    int x0 = zonaCoord((int)(m->pos.x - v < INT32_MIN ? INT32_MIN : m->pos.x - v), a->width, a->lado);
+    int x1 = zonaCoord((int)(m->pos.x + v > INT32_MAX ? INT32_MAX : m->pos.x + v), a->width, a->lado);
+    int y0 = zonaCoord((int)(m->pos.y - v < INT32_MIN ? INT32_MIN : m->pos.y - v), a->height, a->lado);
+    int y1 = zonaCoord((int)(m->pos.y + v > INT32_MAX ? INT32_MAX : m->pos.y + v), a->height, a->lado);
+
+    Suscripcion s = { idx, a->gen[idx] };
+    for (int zy = y0; zy <= y1; ++zy) {
+        for (int zx = x0; zx <= x1; ++zx) {
+            if (anotar(a, &a->zonas[(size_t)zy * (size_t)a->zw + (size_t)zx], s)) {
+                a->gen[idx]++;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+void imprimirAgenda(const Agenda *a, FILE *out) {
+    fprintf(out, "Agenda: %llu veces se durmio un monstruo, %llu despertares, "
+                 "%llu suscripciones revisadas (zonas de %dx%d)\n",
+            (unsigned long long)a->dormidas, (unsigned long long)a->despertares,
+            (unsigned long long)a->revisadas, a->lado, a->lado);
+}
@@ -0,0 +1,59 @@
+#ifndef AGENDA_H
+#define AGENDA_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "config.h"
+
+// Lado (en celdas) de las zonas donde se anotan los monstruos dormidos;
+// crece si el mapa tendria demasiadas zonas
+#define AGENDA_ZONA 8
+#define AGENDA_MAX_ZONAS (1 << 20)
+#define SIN_DORMIR UINT32_MAX
+
+// Un monstruo dormido se anota en cada zona que toca su rombo de vision. La
+// anotacion vale mientras gen coincida con la del monstruo: al despertarlo
+// se incrementa y las viejas se descartan cuando se recorre la zona.
+typedef struct {
+    int32_t monstruo;
+    uint32_t gen;
+} Suscripcion;
+
+typedef struct {
+    Suscripcion *v;
+    int n;
+    int cap;
+} Zona;
+
+typedef struct {
+    _Atomic uint64_t *listos;  // un bit por entidad ACTIVA (las que actuan en la ronda)
+    int nentidades;
+    int nmonstruos;
+
+    Zona *zonas;
+    int lado;
+    int zw, zh;
+    int width, height;
+    uint32_t *gen;             // por monstruo
+    uint32_t *dormido_en;      // por entidad: tick_global al dormirse, SIN_DORMIR si esta despierta
+    pthread_cond_t *conds;     // por entidad, solo en el modo un hilo por entidad
+
+    uint64_t dormidas;
+    uint64_t despertares;
+    uint64_t revisadas;        // suscripciones miradas al entrar heroes a una zona
+} Agenda;
+
+int iniciarAgenda(Agenda *a, const GameConfig *cfg, int nentidades);
+void liberarAgenda(Agenda *a);
+
+void marcarListo(Agenda *a, int entidad, int listo);
+int siguienteListo(const Agenda *a, int desde);   // -1 si no queda ninguna
+
+Zona *zonaDe(Agenda *a, Point p);
+int suscribir(Agenda *a, const Monster *m, int idx);
+
+void imprimirAgenda(const Agenda *a, FILE *out);
+
+#endif
@@ -1,203 +1,632 @@
+#define _DEFAULT_SOURCE
 #include "config.h"
+#include "escenario.h"
+#include "ruta.h"
+#include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Grupo de heroes iguales que comparten una ruta (GROUP_<g>_...)
+typedef struct {
+    Hero plantilla;
+    int cantidad;
+} Grupo;
+
+// Cursor sobre el archivo completo (mapeado en memoria)
+typedef struct {
+    const char *p;
+    const char *fin;
+    Grupo *grupos;     // se expanden a heroes al terminar de leer
+    int ngrupos;
+    int capgrupos;
+    int desborde;      // un numero no entraba en int: la lectura termina con error
+} Lector;
+
+typedef enum {
+    CAMPO_DESCONOCIDO,
+    CAMPO_HP,
+    CAMPO_ATTACK_DAMAGE,
+    CAMPO_ATTACK_RANGE,
+    CAMPO_VISION_RANGE,
+    CAMPO_START,
+    CAMPO_PATH,
+    CAMPO_COORDS,
+    CAMPO_COUNT,
+    CAMPO_SIZE
+} Campo;
 
 static void init_cfg(GameConfig *cfg) {
     cfg->width = 0;
     cfg->height = 0;
     cfg->monster_count = 0;
+    cfg->monster_cap = 0;
+    cfg->monsters = NULL;
     cfg->hero_count = 0;
+    cfg->hero_cap = 0;
+    cfg->heroes = NULL;
+    cfg->ruta_count = 0;
+    cfg->ruta_cap = 0;
+    cfg->rutas = NULL;
+    cfg->seg_count = 0;
+    cfg->seg_cap = 0;
+    cfg->segmentos = NULL;
+    cfg->mapa = NULL;
+    cfg->mapa_len = 0;
+    cfg->terreno = NULL;
+}
 
-    for (int i = 0; i < MAX_HEROES; ++i) {
-        Hero *h = &cfg->heroes[i];
-        h->id = i + 1;
-        h->hp = 0;
-        h->attack = 0;
-        h->range = 0;
-        h->start.x = h->start.y = 0;
-        h->posActual = h->start;
-        h->path_len = 0;
-        h->path_step = 0;
-        h->en_combate = 0;
-        h->path_finished = 0;
-        h->escapado = 0;
-    }
-    for (int i = 0; i < MAX_MONSTERS; ++i) {
-        Monster *m = &cfg->monsters[i];
-        m->id = i + 1;
-        m->hp = 0;
-        m->attack = 0;
-        m->vision = 0;
-        m->range = 0;
-        m->pos.x = m->pos.y = 0;
-        m->alertado = 0;
-        m->target_hero_id = -1;
-    }
-}
-
-// Lee coordenadas tipo (x,y) (x,y) ...
-static void parse_path_multiline(FILE *f, Point *arr, int *len, int max, int width, int height) {
-    int x, y;
-    char token[128];
+// en cero completo (incluido el relleno) para que la huella sea estable
+static void init_heroe(Hero *h, int id) {
+    memset(h, 0, sizeof(*h));
+    h->id = id;
+    h->ruta = -1;
+}
+
+// Crece el arreglo de heroes (doblando) hasta tener espacio para n
+int reservarHeroes(GameConfig *cfg, int n) {
+    if (n <= cfg->hero_cap) return 0;
+    int cap = cfg->hero_cap ? cfg->hero_cap * 2 : 8;
+    if (cap < n) cap = n;
+    if (cap > MAX_HEROES) cap = MAX_HEROES;
+
+    Hero *nuevo = realloc(cfg->heroes, (size_t)cap * sizeof(Hero));
+    if (!nuevo) {
+        printf("Sin memoria para %d heroes\n", cap);
+        return 1;
+    }
+    for (int i = cfg->hero_cap; i < cap; ++i) init_heroe(&nuevo[i], i + 1);
+    cfg->heroes = nuevo;
+    cfg->hero_cap = cap;
+    return 0;
+}
+
+static void init_monstruo(Monster *m, int id) {
+    m->id = id;
+    m->hp = 0;
+    m->attack = 0;
+    m->vision = 0;
+    m->range = 0;
+    m->pos.x = m->pos.y = 0;
+    m->alertado = 0;
+    m->target_hero_id = -1;
+}
+
+// Crece el arreglo de monstruos (doblando) hasta tener espacio para n
+static int reservarMonstruos(GameConfig *cfg, int n) {
+    if (n <= cfg->monster_cap) return 0;
+    int cap = cfg->monster_cap ? cfg->monster_cap * 2 : 32;
+    if (cap < n) cap = n;
+    if (cap > MAX_MONSTERS) cap = MAX_MONSTERS;
+
+    Monster *nuevo = realloc(cfg->monsters, (size_t)cap * sizeof(Monster));
+    if (!nuevo) {
+        printf("Sin memoria para %d monstruos\n", cap);
+        return 1;
+    }
+    for (int i = cfg->monster_cap; i < cap; ++i) init_monstruo(&nuevo[i], i + 1);
+    cfg->monsters = nuevo;
+    cfg->monster_cap = cap;
+    return 0;
+}
+
+// La grilla de terreno se crea con el primer WALL/TERRAIN (todo costo 1)
+static int reservarTerreno(GameConfig *cfg) {
+    if (cfg->terreno) return 0;
+    if (cfg->width <= 0 || cfg->height <= 0) {
+        printf("[WARN] WALL/TERRAIN antes de GRID_SIZE, se ignora\n");
+        return 1;
+    }
+    size_t celdas = (size_t)cfg->width * (size_t)cfg->height;
+    cfg->terreno = malloc(celdas);
+    if (!cfg->terreno) {
+        printf("Sin memoria para el terreno de %dx%d\n", cfg->width, cfg->height);
+        return 1;
+    }
+    memset(cfg->terreno, 1, celdas);
+    return 0;
+}
+
+static void marcarTerreno(GameConfig *cfg, int x0, int y0, int x1, int y1, int costo) {
+    if (reservarTerreno(cfg) != 0) return;
+    if (x0 > x1) { int t = x0; x0 = x1; x1 = t; }
+    if (y0 > y1) { int t = y0; y0 = y1; y1 = t; }
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= cfg->width) x1 = cfg->width - 1;
+    if (y1 >= cfg->height) y1 = cfg->height - 1;
+    if (costo < 0) costo = 0;
+    if (costo > TERRENO_COSTO_MAX) costo = TERRENO_COSTO_MAX;
+
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+            cfg->terreno[(size_t)y * (size_t)cfg->width + (size_t)x] = (uint8_t)costo;
+}
+
+static int es_blanco(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static void saltarLinea(Lector *l) {
+    const char *nl = memchr(l->p, '\n', (size_t)(l->fin - l->p));
+    l->p = nl ? nl + 1 : l->fin;
+}
+
+static void saltarBlancos(Lector *l) {
+    while (l->p < l->fin && es_blanco(*l->p)) l->p++;
+}
+
+// Salta blancos y comentarios (# hasta fin de linea)
+static void saltarBlancosYComentarios(Lector *l) {
+    for (;;) {
+        saltarBlancos(l);
+        if (l->p < l->fin && *l->p == '#') saltarLinea(l);
+        else return;
+    }
+}
+
+// Palabra = secuencia de caracteres no blancos (igual que %s)
+static size_t leerPalabra(Lector *l, const char **ini) {
+    *ini = l->p;
+    while (l->p < l->fin && !es_blanco(*l->p)) l->p++;
+    return (size_t)(l->p - *ini);
+}
+
+static int leerEntero(Lector *l, int *out) {
+    saltarBlancos(l);
+    const char *p = l->p;
+    int neg = 0;
+    if (p < l->fin && (*p == '-' || *p == '+')) { neg = (*p == '-'); ++p; }
+    if (p >= l->fin || (unsigned)(*p - '0') > 9) return 0;
+
+    const char *ini = p;
+    int v = 0;
+    while (p < l->fin && (unsigned)(*p - '0') <= 9) {
+        int d = *p - '0';
+        if (v > (INT_MAX - d) / 10) {
+            while (p < l->fin && (unsigned)(*p - '0') <= 9) ++p;
+            printf("[ERROR] Numero fuera de rango: %.*s\n", (int)(p - ini), ini);
+            l->desborde = 1;
+            l->p = p;
+            return 0;
+        }
+        v = v * 10 + d;
+        ++p;
+    }
+    *out = neg ? -v : v;
+    l->p = p;
+    return 1;
+}
+
+// Compara s[0..n) contra lit ignorando guiones bajos en s
+static int igualSinGuiones(const char *s, size_t n, const char *lit) {
+    size_t i = 0;
+    for (; i < n; ++i) {
+        if (s[i] == '_') continue;
+        if (*lit != s[i]) return 0;
+        ++lit;
+    }
+    return *lit == '\0';
+}
+
+// Consume el prefijo lit desde *s (ignorando guiones bajos), 1 si calza
+static int consumirPrefijo(const char **s, const char *fin, const char *lit) {
+    const char *p = *s;
+    while (*lit) {
+        while (p < fin && *p == '_') ++p;
+        if (p >= fin || *p != *lit) return 0;
+        ++p; ++lit;
+    }
+    while (p < fin && *p == '_') ++p;
+    *s = p;
+    return 1;
+}
+
+// Despacho por (largo sin guiones, primera letra) y confirmacion exacta
+static Campo clasificarCampo(const char *s, size_t n) {
+    size_t largo = 0;
+    char primera = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (s[i] == '_') continue;
+        if (!largo) primera = s[i];
+        ++largo;
+    }
+
+    switch (largo) {
+    case 2:
+        if (igualSinGuiones(s, n, "HP")) return CAMPO_HP;
+        break;
+    case 4:
+        if (primera == 'P' && igualSinGuiones(s, n, "PATH")) return CAMPO_PATH;
+        if (primera == 'S' && igualSinGuiones(s, n, "SIZE")) return CAMPO_SIZE;
+        break;
+    case 5:
+        if (primera == 'S' && igualSinGuiones(s, n, "START")) return CAMPO_START;
+        if (primera == 'C' && igualSinGuiones(s, n, "COUNT")) return CAMPO_COUNT;
+        break;
+    case 6:
+        if (igualSinGuiones(s, n, "COORDS")) return CAMPO_COORDS;
+        break;
+    case 11:
+        if (primera == 'A' && igualSinGuiones(s, n, "ATTACKRANGE")) return CAMPO_ATTACK_RANGE;
+        if (primera == 'V' && igualSinGuiones(s, n, "VISIONRANGE")) return CAMPO_VISION_RANGE;
+        break;
+    case 12:
+        if (igualSinGuiones(s, n, "ATTACKDAMAGE")) return CAMPO_ATTACK_DAMAGE;
+        break;
+    }
+    return CAMPO_DESCONOCIDO;
+}
+
+// Lee coordenadas tipo (x,y) (x,y) ... aunque ocupen varias lineas
+static void parse_path(Lector *l, Point *arr, int *len, int max, int width, int height) {
     *len = 0;
+    for (;;) {
+        saltarBlancos(l);
+        if (l->p >= l->fin || *l->p != '(') return;
+        l->p++;
 
-    while (fscanf(f, " %127s", token) == 1) {
-        if (token[0] == '(') {
-            if (sscanf(token, "(%d,%d)", &x, &y) == 2) {
-                if (*len < max) {
-                    arr[*len].x = x;
-                    arr[*len].y = y;
-                    (*len)++;
-                    if (x < 0 || y < 0 || x >= width || y >= height)
-                        printf("[WARN] Coordenada fuera de rango: (%d,%d)\n", x, y);
-                }
-            }
-        } else {
-            for (int i = (int)strlen(token) - 1; i >= 0; --i) ungetc(token[i], f);
-            ungetc(' ', f);
-            break;
+        int x, y;
+        if (!leerEntero(l, &x)) continue;
+        saltarBlancos(l);
+        if (l->p < l->fin && *l->p == ',') l->p++;
+        if (!leerEntero(l, &y)) continue;
+        saltarBlancos(l);
+        if (l->p < l->fin && *l->p == ')') l->p++;
+
+        if (*len < max) {
+            arr[*len].x = x;
+            arr[*len].y = y;
+            (*len)++;
+            if (x < 0 || y < 0 || x >= width || y >= height)
+                printf("[WARN] Coordenada fuera de rango: (%d,%d)\n", x, y);
         }
     }
 }
 
-// Quita guiones bajos de una palabra
-static void norm_key(const char *src, char *dst, size_t n) {
-    size_t j = 0;
-    for (size_t i = 0; src[i] && j + 1 < n; ++i)
-        if (src[i] != '_') dst[j++] = src[i];
-    dst[j] = '\0';
+// Lee el id numerico pegado a la clave (HERO_12_HP -> 12), 0 si no hay
+static int leerIdPegado(const char **s, const char *fin) {
+    int id = 0;
+    const char *p = *s;
+    while (p < fin && (unsigned)(*p - '0') <= 9) id = id * 10 + (*p++ - '0');
+    while (p < fin && *p == '_') ++p;
+    *s = p;
+    return id;
 }
 
-int leerConfig(const char *nombreArchivo, GameConfig *cfg) {
-    FILE *f = fopen(nombreArchivo, "r");
-    if (!f) {
-        printf("No se pudo abrir el archivo: %s\n", nombreArchivo);
-        return 1;
+static int aplicarCampoHeroe(Lector *l, GameConfig *cfg, Hero *h, Campo campo) {
+    Point pts[MAX_PATH];
+    int n;
+
+    switch (campo) {
+    case CAMPO_HP: leerEntero(l, &h->hp); break;
+    case CAMPO_ATTACK_DAMAGE: leerEntero(l, &h->attack); break;
+    case CAMPO_ATTACK_RANGE: leerEntero(l, &h->range); break;
+    case CAMPO_START:
+        leerEntero(l, &h->start.x);
+        leerEntero(l, &h->start.y);
+        h->posActual = h->start;
+        break;
+    case CAMPO_PATH:
+        parse_path(l, pts, &n, MAX_PATH, cfg->width, cfg->height);
+        // un PATH repetido pisa al anterior sin dejar sus tramos perdidos
+        h->ruta = reemplazarRuta(cfg, h->ruta, pts, n);
+        if (h->ruta < 0) return 1;
+        h->path_len = n;
+        break;
+    default: saltarLinea(l); break;
     }
+    return 0;
+}
 
-    init_cfg(cfg);
+static void aplicarCampoMonstruo(Lector *l, Monster *m, Campo campo) {
+    switch (campo) {
+    case CAMPO_HP: leerEntero(l, &m->hp); break;
+    case CAMPO_ATTACK_DAMAGE: leerEntero(l, &m->attack); break;
+    case CAMPO_VISION_RANGE: leerEntero(l, &m->vision); break;
+    case CAMPO_ATTACK_RANGE: leerEntero(l, &m->range); break;
+    case CAMPO_COORDS:
+        leerEntero(l, &m->pos.x);
+        leerEntero(l, &m->pos.y);
+        break;
+    default: saltarLinea(l); break;
+    }
+}
+
+// Formatos aceptados: HERO <id> CAMPO, HERO_<id>_CAMPO, HERO_CAMPO (un heroe)
+static int parseHeroe(Lector *l, GameConfig *cfg, const char *resto, const char *finPalabra) {
+    int id;
+    Campo campo;
 
-    char word[128];
-    while (fscanf(f, "%127s", word) == 1) {
-        if (word[0] == '#') {
-            int c;
-            while ((c = fgetc(f)) != '\n' && c != EOF) {}
-            continue;
+    if (resto == finPalabra) {
+        const char *w;
+        if (!leerEntero(l, &id)) return 0;
+        saltarBlancos(l);
+        size_t n = leerPalabra(l, &w);
+        if (n == 0) return 0;
+        campo = clasificarCampo(w, n);
+    } else {
+        id = leerIdPegado(&resto, finPalabra);
+        campo = clasificarCampo(resto, (size_t)(finPalabra - resto));
+
+        if (id == 0) {
+            if (campo == CAMPO_COUNT) {
+                leerEntero(l, &cfg->hero_count);
+                if (cfg->hero_count < 1) cfg->hero_count = 1;
+                if (cfg->hero_count > MAX_HEROES) cfg->hero_count = MAX_HEROES;
+                return reservarHeroes(cfg, cfg->hero_count);
+            }
+            id = 1;
         }
+    }
+
+    if (id < 1 || id > MAX_HEROES) { saltarLinea(l); return 0; }
+    if (reservarHeroes(cfg, id) != 0) return 1;
+    if (id > cfg->hero_count) cfg->hero_count = id;
+    return aplicarCampoHeroe(l, cfg, &cfg->heroes[id - 1], campo);
+}
+
+// Formatos aceptados: GROUP <g> CAMPO, GROUP_<g>_CAMPO. COUNT es la cantidad
+// de heroes del grupo; el resto de los campos son los de HERO
+static int parseGrupo(Lector *l, GameConfig *cfg, const char *resto, const char *finPalabra) {
+    int g;
+    Campo campo;
 
-        if (strcmp(word, "GRID_SIZE") == 0) {
-            fscanf(f, "%d %d", &cfg->width, &cfg->height);
-            continue;
+    if (resto == finPalabra) {
+        const char *w;
+        if (!leerEntero(l, &g)) return 0;
+        saltarBlancos(l);
+        size_t n = leerPalabra(l, &w);
+        if (n == 0) return 0;
+        campo = clasificarCampo(w, n);
+    } else {
+        g = leerIdPegado(&resto, finPalabra);
+        campo = clasificarCampo(resto, (size_t)(finPalabra - resto));
+    }
+    // el id se valida antes de reservar: cada grupo hasta g lleva su plantilla
+    if (g < 1 || g > MAX_GRUPOS) {
+        printf("[WARN] Grupo %d fuera de rango (1..%d), se ignora\n", g, MAX_GRUPOS);
+        saltarLinea(l);
+        return 0;
+    }
+
+    if (g > l->capgrupos) {
+        int cap = l->capgrupos ? l->capgrupos * 2 : 8;
+        if (cap < g) cap = g;
+        if (cap > MAX_GRUPOS) cap = MAX_GRUPOS;
+        Grupo *nuevo = realloc(l->grupos, (size_t)cap * sizeof(Grupo));
+        if (!nuevo) {
+            printf("Sin memoria para %d grupos\n", cap);
+            return 1;
         }
-        if (strcmp(word, "HERO_COUNT") == 0) {
-            fscanf(f, "%d", &cfg->hero_count);
-            if (cfg->hero_count < 1) cfg->hero_count = 1;
-            if (cfg->hero_count > MAX_HEROES) cfg->hero_count = MAX_HEROES;
-            continue;
+        l->grupos = nuevo;
+        l->capgrupos = cap;
+    }
+    for (; l->ngrupos < g; ++l->ngrupos) {
+        init_heroe(&l->grupos[l->ngrupos].plantilla, 0);
+        l->grupos[l->ngrupos].plantilla.grupo = l->ngrupos + 1;
+        l->grupos[l->ngrupos].cantidad = 0;
+    }
+
+    Grupo *gr = &l->grupos[g - 1];
+    if (campo == CAMPO_COUNT) {
+        leerEntero(l, &gr->cantidad);
+        if (gr->cantidad < 0) gr->cantidad = 0;
+        if (gr->cantidad > MAX_HEROES) gr->cantidad = MAX_HEROES;
+        return 0;
+    }
+    return aplicarCampoHeroe(l, cfg, &gr->plantilla, campo);
+}
+
+// Los heroes de los grupos van despues de los sueltos, con ids correlativos
+static int expandirGrupos(GameConfig *cfg, const Lector *l) {
+    long total = cfg->hero_count;
+    for (int g = 0; g < l->ngrupos; ++g) total += l->grupos[g].cantidad;
+    if (total > MAX_HEROES) {
+        printf("[WARN] Demasiados heroes (%ld), se usan %d\n", total, MAX_HEROES);
+        total = MAX_HEROES;
+    }
+    if (reservarHeroes(cfg, (int)total) != 0) return 1;
+
+    for (int g = 0; g < l->ngrupos; ++g) {
+        for (int k = 0; k < l->grupos[g].cantidad && cfg->hero_count < total; ++k) {
+            Hero *h = &cfg->heroes[cfg->hero_count];
+            *h = l->grupos[g].plantilla;
+            h->id = ++cfg->hero_count;
+            h->posActual = h->start;
         }
-        if (strcmp(word, "MONSTER_COUNT") == 0) {
-            fscanf(f, "%d", &cfg->monster_count);
+    }
+    return 0;
+}
+
+// Formatos aceptados: MONSTER <id> CAMPO, MONSTER_<id>_CAMPO, MONSTER_COUNT
+static int parseMonstruo(Lector *l, GameConfig *cfg, const char *resto, const char *finPalabra) {
+    int id;
+    Campo campo;
+
+    if (resto == finPalabra) {
+        const char *w;
+        if (!leerEntero(l, &id)) return 0;
+        saltarBlancos(l);
+        size_t n = leerPalabra(l, &w);
+        if (n == 0) return 0;
+        campo = clasificarCampo(w, n);
+    } else {
+        id = leerIdPegado(&resto, finPalabra);
+        campo = clasificarCampo(resto, (size_t)(finPalabra - resto));
+
+        if (id == 0 && campo == CAMPO_COUNT) {
+            leerEntero(l, &cfg->monster_count);
             if (cfg->monster_count < 0) cfg->monster_count = 0;
             if (cfg->monster_count > MAX_MONSTERS) cfg->monster_count = MAX_MONSTERS;
-            continue;
+            return reservarMonstruos(cfg, cfg->monster_count);
         }
+    }
 
-        // Formato HERO <id> CAMPO
-        if (strcmp(word, "HERO") == 0) {
-            int id; char campo[64];
-            if (fscanf(f, "%d %63s", &id, campo) != 2) continue;
-            if (id < 1 || id > MAX_HEROES) { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} continue; }
-            if (id > cfg->hero_count) cfg->hero_count = id;
-            Hero *h = &cfg->heroes[id - 1];
-
-            if      (strcmp(campo, "HP") == 0) fscanf(f, "%d", &h->hp);
-            else if (strcmp(campo, "ATTACK_DAMAGE") == 0) fscanf(f, "%d", &h->attack);
-            else if (strcmp(campo, "ATTACK_RANGE") == 0) fscanf(f, "%d", &h->range);
-            else if (strcmp(campo, "START") == 0) { fscanf(f, "%d %d", &h->start.x, &h->start.y); h->posActual = h->start; }
-            else if (strcmp(campo, "PATH") == 0) parse_path_multiline(f, h->path, &h->path_len, MAX_PATH, cfg->width, cfg->height);
-            else { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} }
-            continue;
-        }
+    if (id < 1 || id > MAX_MONSTERS) { saltarLinea(l); return 0; }
+    if (reservarMonstruos(cfg, id) != 0) return 1;
+    if (id > cfg->monster_count) cfg->monster_count = id;
+    aplicarCampoMonstruo(l, &cfg->monsters[id - 1], campo);
+    return 0;
+}
 
-        // Formato MONSTER <id> CAMPO
-        if (strcmp(word, "MONSTER") == 0) {
-            int id; char campo[64];
-            if (fscanf(f, "%d %63s", &id, campo) != 2) continue;
-            if (id < 1 || id > MAX_MONSTERS) { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} continue; }
-            if (id > cfg->monster_count) cfg->monster_count = id;
-            Monster *m = &cfg->monsters[id - 1];
-
-            if      (strcmp(campo, "HP") == 0) fscanf(f, "%d", &m->hp);
-            else if (strcmp(campo, "ATTACK_DAMAGE") == 0) fscanf(f, "%d", &m->attack);
-            else if (strcmp(campo, "VISION_RANGE") == 0) fscanf(f, "%d", &m->vision);
-            else if (strcmp(campo, "ATTACK_RANGE") == 0) fscanf(f, "%d", &m->range);
-            else if (strcmp(campo, "COORDS") == 0) fscanf(f, "%d %d", &m->pos.x, &m->pos.y);
-            else { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} }
-            continue;
-        }
+int leerConfigBuffer(const char *buf, size_t len, GameConfig *cfg) {
+    Lector l = { buf, buf + len, NULL, 0, 0, 0 };
+    init_cfg(cfg);
 
-        // Quita guiones bajos
-        char key[128]; norm_key(word, key, sizeof(key));
-
-        // HERO_1_HP, HERO_2_PATH, etc
-        if (strncmp(key, "HERO", 4) == 0 && isdigit((unsigned char)key[4])) {
-            int id = 0; const char *p = key + 4;
-            while (*p && isdigit((unsigned char)*p)) { id = id * 10 + (*p - '0'); ++p; }
-            if (id < 1 || id > MAX_HEROES) { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} continue; }
-            if (id > cfg->hero_count) cfg->hero_count = id;
-            Hero *h = &cfg->heroes[id - 1];
-
-            if      (strstr(key, "HP")) fscanf(f, "%d", &h->hp);
-            else if (strstr(key, "ATTACKDAMAGE")) fscanf(f, "%d", &h->attack);
-            else if (strstr(key, "ATTACKRANGE")) fscanf(f, "%d", &h->range);
-            else if (strstr(key, "START")) { fscanf(f, "%d %d", &h->start.x, &h->start.y); h->posActual = h->start; }
-            else if (strstr(key, "PATH")) parse_path_multiline(f, h->path, &h->path_len, MAX_PATH, cfg->width, cfg->height);
-            else { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} }
-            continue;
-        }
+    for (;;) {
+        saltarBlancosYComentarios(&l);
+        if (l.p >= l.fin) break;
+
+        const char *w;
+        size_t n = leerPalabra(&l, &w);
+        const char *fin = w + n;
+        const char *resto = w;
+        int err = 0;
 
-        // HERO_HP, HERO_PATH (un heroe)
-        if (strncmp(key, "HERO", 4) == 0) {
-            Hero *h = &cfg->heroes[0];
-            h->id = 1;
-            if (cfg->hero_count < 1) cfg->hero_count = 1;
-
-            if      (strcmp(key, "HEROHP") == 0) fscanf(f, "%d", &h->hp);
-            else if (strcmp(key, "HEROATTACKDAMAGE") == 0) fscanf(f, "%d", &h->attack);
-            else if (strcmp(key, "HEROATTACKRANGE") == 0) fscanf(f, "%d", &h->range);
-            else if (strcmp(key, "HEROSTART") == 0) { fscanf(f, "%d %d", &h->start.x, &h->start.y); h->posActual = h->start; }
-            else if (strcmp(key, "HEROPATH") == 0) parse_path_multiline(f, h->path, &h->path_len, MAX_PATH, cfg->width, cfg->height);
-            else { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} }
-            continue;
+        switch (w[0]) {
+        case 'H':
+            if (consumirPrefijo(&resto, fin, "HERO")) { err = parseHeroe(&l, cfg, resto, fin); break; }
+            saltarLinea(&l);
+            break;
+        case 'M':
+            if (consumirPrefijo(&resto, fin, "MONSTER")) { err = parseMonstruo(&l, cfg, resto, fin); break; }
+            saltarLinea(&l);
+            break;
+        case 'W':
+            // WALL x y  |  WALL x0 y0 x1 y1
+            if (consumirPrefijo(&resto, fin, "WALL") && resto == fin) {
+                int x0 = 0, y0 = 0, x1, y1;
+                leerEntero(&l, &x0);
+                leerEntero(&l, &y0);
+                if (!leerEntero(&l, &x1) || !leerEntero(&l, &y1)) { x1 = x0; y1 = y0; }
+                marcarTerreno(cfg, x0, y0, x1, y1, 0);
+                break;
+            }
+            saltarLinea(&l);
+            break;
+        case 'T':
+            // TERRAIN x0 y0 x1 y1 costo
+            if (consumirPrefijo(&resto, fin, "TERRAIN") && resto == fin) {
+                int x0 = 0, y0 = 0, x1 = 0, y1 = 0, costo = 1;
+                leerEntero(&l, &x0);
+                leerEntero(&l, &y0);
+                leerEntero(&l, &x1);
+                leerEntero(&l, &y1);
+                leerEntero(&l, &costo);
+                marcarTerreno(cfg, x0, y0, x1, y1, costo);
+                break;
+            }
+            saltarLinea(&l);
+            break;
+        case 'G':
+            if (consumirPrefijo(&resto, fin, "GROUP")) { err = parseGrupo(&l, cfg, resto, fin); break; }
+            resto = w;
+            if (consumirPrefijo(&resto, fin, "GRID") &&
+                clasificarCampo(resto, (size_t)(fin - resto)) == CAMPO_SIZE) {
+                leerEntero(&l, &cfg->width);
+                leerEntero(&l, &cfg->height);
+                break;
+            }
+            saltarLinea(&l);
+            break;
+        default:
+            // Si no calza nada
+            saltarLinea(&l);
+            break;
         }
+        if (err || l.desborde) { free(l.grupos); liberarConfig(cfg); return 1; }
+    }
+
+    // sin heroes ni grupos queda el heroe 1 en cero, como siempre
+    if (cfg->hero_count < 1 && l.ngrupos == 0) cfg->hero_count = 1;
+    int err = reservarHeroes(cfg, cfg->hero_count) || expandirGrupos(cfg, &l) ||
+              reservarMonstruos(cfg, cfg->monster_count);
+    free(l.grupos);
+    if (err) { liberarConfig(cfg); return 1; }
 
-        // MONSTER_1_HP, MONSTER_2_COORDS, etc
-        if (strncmp(key, "MONSTER", 7) == 0) {
-            int id = 0; const char *p = key + 7;
-            while (*p && isdigit((unsigned char)*p)) { id = id * 10 + (*p - '0'); ++p; }
-            if (id < 1 || id > MAX_MONSTERS) { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} continue; }
-            if (id > cfg->monster_count) cfg->monster_count = id;
-            Monster *m = &cfg->monsters[id - 1];
-
-            if      (strstr(key, "HP")) fscanf(f, "%d", &m->hp);
-            else if (strstr(key, "ATTACKDAMAGE")) fscanf(f, "%d", &m->attack);
-            else if (strstr(key, "VISIONRANGE")) fscanf(f, "%d", &m->vision);
-            else if (strstr(key, "ATTACKRANGE")) fscanf(f, "%d", &m->range);
-            else if (strstr(key, "COORDS")) fscanf(f, "%d %d", &m->pos.x, &m->pos.y);
-            else { int c; while ((c = fgetc(f)) != '\n' && c != EOF) {} }
-            continue;
+    if (cfg->terreno) {
+        for (int i = 0; i < cfg->monster_count; ++i) {
+            Point p = cfg->monsters[i].pos;
+            if (p.x >= 0 && p.y >= 0 && p.x < cfg->width && p.y < cfg->height &&
+                cfg->terreno[(size_t)p.y * (size_t)cfg->width + (size_t)p.x] == 0)
+                printf("[WARN] MONSTRUO %d parte dentro de un muro (%d,%d)\n", i + 1, p.x, p.y);
         }
+    }
+    return 0;
+}
+
+int leerConfig(const char *nombreArchivo, GameConfig *cfg) {
+    int fd = open(nombreArchivo, O_RDONLY);
+    if (fd < 0) {
+        printf("No se pudo abrir el archivo: %s\n", nombreArchivo);
+        return 1;
+    }
 
-        // Si no calza nada
-        int c;
-        while ((c = fgetc(f)) != '\n' && c != EOF) {}
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        printf("No se pudo leer el archivo: %s\n", nombreArchivo);
+        close(fd);
+        return 1;
     }
 
-    if (cfg->hero_count < 1) cfg->hero_count = 1;
-    if (cfg->monster_count < 0) cfg->monster_count = 0;
-    if (cfg->monster_count > MAX_MONSTERS) cfg->monster_count = MAX_MONSTERS;
+    // mmap de tamano 0 falla, un archivo vacio es una config vacia
+    if (st.st_size == 0) {
+        close(fd);
+        return leerConfigBuffer("", 0, cfg);
+    }
 
-    fclose(f);
-    return 0;
+    // PROT_WRITE + MAP_PRIVATE: un escenario binario se usa en el lugar
+    // y las escrituras del motor quedan en copias privadas, no en el archivo
+    size_t len = (size_t)st.st_size;
+    void *map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("No se pudo mapear el archivo: %s\n", nombreArchivo);
+        return 1;
+    }
+
+    if (esEscenario(map, len)) {
+        if (cargarEscenario(map, len, cfg) != 0) {
+            printf("Escenario binario invalido: %s\n", nombreArchivo);
+            munmap(map, len);
+            return 1;
+        }
+        return 0;
+    }
+
+    madvise(map, len, MADV_SEQUENTIAL);
+
+    int r = leerConfigBuffer((const char *)map, len, cfg);
+    munmap(map, len);
+    return r;
+}
+
+void liberarConfig(GameConfig *cfg) {
+    free(cfg->heroes);
+    free(cfg->rutas);
+    free(cfg->segmentos);
+    cfg->heroes = NULL;
+    cfg->rutas = NULL;
+    cfg->segmentos = NULL;
+    cfg->hero_count = cfg->hero_cap = 0;
+    cfg->ruta_count = cfg->ruta_cap = 0;
+    cfg->seg_count = cfg->seg_cap = 0;
+
+    if (cfg->mapa) {
+        munmap(cfg->mapa, cfg->mapa_len);
+        cfg->mapa = NULL;
+        cfg->mapa_len = 0;
+    } else {
+        free(cfg->monsters);
+        free(cfg->terreno);
+    }
+    cfg->terreno = NULL;
+    cfg->monsters = NULL;
+    cfg->monster_cap = 0;
+    cfg->monster_count = 0;
 }
@@ -2,29 +2,51 @@
 #define CONFIG_H
 
 #include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define MAX_PATH 200
-#define MAX_MONSTERS 30
-#define MAX_HEROES 5
+#define MAX_MONSTERS 1000000
+#define MAX_HEROES 1000000
+#define MAX_GRUPOS 65536  // cada id de grupo reserva su plantilla al leerse
+#define TERRENO_COSTO_MAX 9
 
 typedef struct {
     int x;
     int y;
 } Point;
 
+// Tramo recto de un path: inicio, inicio + (dx,dy), ..., inicio + (largo-1)*(dx,dy)
+typedef struct {
+    Point inicio;
+    int16_t dx;
+    int16_t dy;
+    int32_t largo;
+} Segmento;
+
+// Path compartido: tramos [seg_ini, seg_ini + nsegs) de cfg->segmentos
+typedef struct {
+    int32_t seg_ini;
+    int32_t nsegs;
+    int32_t largo;     // puntos en total
+} Ruta;
+
 typedef struct {
     int id;
     int hp;
     int attack;
     int range;
     Point start;
-    Point path[MAX_PATH];
+    int ruta;          // indice en cfg->rutas, -1 = sin path
     int path_len;
     Point posActual;
     int en_combate;
     int path_step;
+    int seg;           // cursor: tramo actual dentro de la ruta
+    int seg_paso;      // y punto dentro del tramo
     int path_finished;
     int escapado;
+    int grupo;         // 0 = heroe suelto
 } Hero;
 
 typedef struct {
@@ -41,14 +63,29 @@ typedef struct {
 typedef struct {
     int width;
     int height;
-    Hero heroes[MAX_HEROES];
+    Hero *heroes;
     int hero_count;
-    Monster monsters[MAX_MONSTERS];
+    int hero_cap;
+    Ruta *rutas;
+    int ruta_count;
+    int ruta_cap;
+    Segmento *segmentos;
+    int seg_count;
+    int seg_cap;
+    Monster *monsters;
     int monster_count;
+    int monster_cap;
+    uint8_t *terreno;  // width*height, costo de entrar a la celda (0 = muro), NULL = sin obstaculos
     pthread_mutex_t mutex;
     int juegoActivo;
+    void *mapa;        // escenario binario mapeado (NULL si vino de texto); solo
+                       // monstruos y terreno apuntan dentro, el resto es propio
+    size_t mapa_len;
 } GameConfig;
 
 int leerConfig(const char *nombreArchivo, GameConfig *cfg);
+int leerConfigBuffer(const char *buf, size_t len, GameConfig *cfg);
+void liberarConfig(GameConfig *cfg);
+int reservarHeroes(GameConfig *cfg, int n);
 
 #endif
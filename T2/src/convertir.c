@@ -0,0 +1,21 @@
+#include <stdio.h>
+#include "config.h"
+#include "escenario.h"
+
+// Convierte un config.txt (cualquiera de sus formatos) a escenario binario
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        printf("Uso: %s <config.txt> <salida.bin>\n", argv[0]);
+        return 1;
+    }
+
+    GameConfig cfg;
+    if (leerConfig(argv[1], &cfg) != 0) return 1;
+
+    int r = guardarEscenario(argv[2], &cfg);
+    if (r == 0)
+        printf("Escenario %s: %d heroes, %d monstruos, grilla %dx%d\n",
+               argv[2], cfg.hero_count, cfg.monster_count, cfg.width, cfg.height);
+    liberarConfig(&cfg);
+    return r;
+}
@@ -0,0 +1,346 @@
+#define _DEFAULT_SOURCE
+#include "ejecucion.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    Motor* mt;
+    int heroes_vivos;   // hilos de heroes que no terminaron (con cfg->mutex)
+    int sin_heroes;     // ya nadie puede despertar a un monstruo dormido
+} Corrida;
+
+typedef struct { Corrida* c; int entidad; uint32_t ticks_max; } ArgsEntidad;
+
+static int llegoAlLimite(const Motor* mt, uint32_t ticks_max) {
+    return ticks_max && mt->tick_global >= ticks_max;
+}
+
+static void entregar(Motor* mt, int hilo, int entidad) {
+    BufferEventos* ev = bufferEventos(mt->eventos, entidad);
+    if (!mt->perfil) {
+        entregarEventos(ev);
+        return;
+    }
+    uint64_t t = perfilAhora();
+    entregarEventos(ev);
+    perfilFase(perfilHilo(mt->perfil, hilo), FASE_LOG, &t);
+}
+
+// Fin de ronda de un trabajador: su lote pasa al escritor aunque no este lleno
+static void entregarRonda(Motor* mt, int hilo, LoteEventos* lote) {
+    if (!mt->perfil) {
+        entregarLote(mt->eventos, lote);
+        return;
+    }
+    uint64_t t = perfilAhora();
+    entregarLote(mt->eventos, lote);
+    perfilFase(perfilHilo(mt->perfil, hilo), FASE_LOG, &t);
+}
+
+static void pausa(Motor* mt, int hilo) {
+    uint64_t t = mt->perfil ? perfilAhora() : 0;
+    sleep(1);
+    if (mt->perfil) perfilFase(perfilHilo(mt->perfil, hilo), FASE_PAUSA, &t);
+}
+
+// Un monstruo dormido espera en su variable de condicion en vez de
+// despertarse cada segundo. 1 si lo despertaron, 0 si ya no quedan heroes.
+static int esperarDespierto(Motor* mt, Corrida* c, int e) {
+    GameConfig* cfg = mt->cfg;
+    uint64_t t = mt->perfil ? perfilAhora() : 0;
+    tomarMutex(mt->perfil, e, &cfg->mutex);
+    int espero = 0;
+    while (mt->estado[e] == ENTIDAD_DORMIDA && !c->sin_heroes) {
+        pthread_cond_wait(&mt->agenda.conds[e], &cfg->mutex);
+        espero = 1;
+    }
+    int despierto = mt->estado[e] != ENTIDAD_DORMIDA;
+    pthread_mutex_unlock(&cfg->mutex);
+    if (espero && mt->perfil) perfilFase(perfilHilo(mt->perfil, e), FASE_PAUSA, &t);
+    return despierto;
+}
+
+// Sin hilos de heroes nadie entra a la vision de nadie: los dormidos que
+// quedan (corrida cortada por --ticks) se sueltan sin OP_FIN
+static void terminaHeroe(Motor* mt, Corrida* c, int hilo) {
+    tomarMutex(mt->perfil, hilo, &mt->cfg->mutex);
+    if (--c->heroes_vivos == 0) {
+        c->sin_heroes = 1;
+        for (int e = mt->cfg->hero_count; e < mt->nentidades; e++)
+            if (mt->estado[e] == ENTIDAD_DORMIDA) pthread_cond_signal(&mt->agenda.conds[e]);
+    }
+    pthread_mutex_unlock(&mt->cfg->mutex);
+}
+
+static void* hiloEntidad(void* arg) {
+    ArgsEntidad* a = (ArgsEntidad*) arg;
+    Corrida* c = a->c;
+    Motor* mt = c->mt;
+    GameConfig* cfg = mt->cfg;
+    int e = a->entidad;
+    int heroe = e < cfg->hero_count;
+
+    if (mt->estado[e] == ENTIDAD_PENDIENTE) {
+        tomarMutex(mt->perfil, e, &cfg->mutex);
+        ejecutarOp(mt, e, OP_INICIO);
+        pthread_mutex_unlock(&cfg->mutex);
+        entregar(mt, e, e);
+    }
+
+    int cortado = 0;
+    int dormido = !heroe;   // puede venir dormido de un checkpoint
+    while (1) {
+        if (dormido && !esperarDespierto(mt, c, e)) {
+            cortado = 1;
+            break;
+        }
+        // el monstruo espera antes de actuar, el heroe despues
+        if (!heroe) pausa(mt, e);
+
+        tomarMutex(mt->perfil, e, &cfg->mutex);
+        cortado = a->ticks_max && mt->ticks[e] >= a->ticks_max;
+        int seguir = !cortado && ejecutarOp(mt, e, OP_PASO);
+        if (!cortado) revisarCheckpoint(mt);
+        dormido = mt->estado[e] == ENTIDAD_DORMIDA;
+        pthread_mutex_unlock(&cfg->mutex);
+        entregar(mt, e, e);
+        if (!seguir) break;
+
+        if (heroe) pausa(mt, e);
+    }
+
+    if (!cortado) {
+        tomarMutex(mt->perfil, e, &cfg->mutex);
+        ejecutarOp(mt, e, OP_FIN);
+        pthread_mutex_unlock(&cfg->mutex);
+        entregar(mt, e, e);
+    }
+    if (heroe) terminaHeroe(mt, c, e);
+    return NULL;
+}
+
+int correrHilos(Motor* mt, uint32_t ticks_max) {
+    int n = mt->nentidades;
+    uint32_t tick_inicial = mt->tick_global;
+    pthread_t* hilos = malloc((size_t)(n ? n : 1) * sizeof(pthread_t));
+    ArgsEntidad* args = malloc((size_t)(n ? n : 1) * sizeof(ArgsEntidad));
+    char* creado = calloc((size_t)(n ? n : 1), 1);
+    pthread_cond_t* conds = malloc((size_t)(n ? n : 1) * sizeof(pthread_cond_t));
+    if (!hilos || !args || !creado || !conds) {
+        printf("Sin memoria para los hilos.\n");
+        free(hilos); free(args); free(creado); free(conds);
+        return 1;
+    }
+    for (int i = 0; i < n; i++) pthread_cond_init(&conds[i], NULL);
+    mt->agenda.conds = conds;
+
+    // los heroes que ya terminaron no cuentan; si no queda ninguno, los
+    // monstruos dormidos no esperan a nadie
+    Corrida c = { mt, 0, 0 };
+    for (int i = 0; i < mt->cfg->hero_count; i++)
+        if (mt->estado[i] != ENTIDAD_TERMINADA) c.heroes_vivos++;
+    c.sin_heroes = c.heroes_vivos == 0;
+
+    for (int i = 0; i < n; i++) {
+        if (mt->estado[i] == ENTIDAD_TERMINADA) continue;
+        args[i].c = &c;
+        args[i].entidad = i;
+        args[i].ticks_max = ticks_max;
+        creado[i] = pthread_create(&hilos[i], NULL, hiloEntidad, &args[i]) == 0;
+        if (!creado[i] && i < mt->cfg->hero_count) terminaHeroe(mt, &c, 0);
+    }
+    for (int i = 0; i < n; i++)
+        if (creado[i]) pthread_join(hilos[i], NULL);
+
+    if (mt->perfil) mt->perfil->rondas += mt->tick_global - tick_inicial;
+    mt->agenda.conds = NULL;
+    for (int i = 0; i < n; i++) pthread_cond_destroy(&conds[i]);
+    free(conds);
+    free(hilos);
+    free(args);
+    free(creado);
+    return 0;
+}
+
+static void iniciarPendientes(Motor* mt, LoteEventos* lote) {
+    usarLote(lote);
+    for (int e = 0; e < mt->nentidades; e++) {
+        if (mt->estado[e] != ENTIDAD_PENDIENTE) continue;
+        ejecutarOp(mt, e, OP_INICIO);
+    }
+    entregarRonda(mt, 0, lote);
+}
+
+// Sin hilos ni pausas: en cada ronda actuan las entidades activas en orden
+// fijo. Se recorren los bits de la agenda, asi que los monstruos dormidos no
+// cuestan nada; uno que despierta en la ronda actua en ella si viene despues.
+void correrDeterminista(Motor* mt, uint32_t ticks_max) {
+    LoteEventos* lote = loteEventos(mt->eventos, 0);
+    iniciarPendientes(mt, lote);
+
+    while (!llegoAlLimite(mt, ticks_max)) {
+        int e = siguienteListo(&mt->agenda, 0);
+        if (e < 0) break;
+        for (; e >= 0; e = siguienteListo(&mt->agenda, e + 1))
+            if (!ejecutarOp(mt, e, OP_PASO)) ejecutarOp(mt, e, OP_FIN);
+        entregarRonda(mt, 0, lote);
+        if (mt->perfil) mt->perfil->rondas++;
+        revisarCheckpoint(mt);
+    }
+    usarLote(NULL);
+}
+
+typedef struct {
+    Motor* mt;
+    uint32_t ticks_max;
+    pthread_barrier_t barrera;
+    _Atomic int cursor;
+    _Atomic int activos;
+    int seguir;
+    pthread_mutex_t arranque;   // los trabajadores esperan a que esten todos
+    pthread_cond_t arranco;
+    int estado;                 // 0: creando, 1: adelante, -1: abortado
+} Pool;
+
+typedef struct { Pool* pool; int id; } ArgsPool;
+
+// Cada ronda los trabajadores toman palabras de 64 bits de la agenda (64
+// entidades) con un contador atomico; entre rondas se esperan en una barrera
+// y el trabajador 0 decide si sigue. Cada entidad la procesa un solo hilo por
+// ronda, asi que su buffer de eventos no se comparte; los eventos van al lote
+// del trabajador, que se entrega antes de la barrera.
+static void* hiloPool(void* arg) {
+    ArgsPool* a = (ArgsPool*) arg;
+    Pool* p = a->pool;
+    Motor* mt = p->mt;
+    int npalabras = (mt->nentidades + 63) / 64;
+    LoteEventos* lote = loteEventos(mt->eventos, a->id);
+
+    // si falta algun hilo la barrera no se completaria: no se entra a ella
+    pthread_mutex_lock(&p->arranque);
+    while (p->estado == 0) pthread_cond_wait(&p->arranco, &p->arranque);
+    int abortado = p->estado < 0;
+    pthread_mutex_unlock(&p->arranque);
+    if (abortado) return NULL;
+    usarLote(lote);
+
+    for (;;) {
+        int activos = 0;
+        int w;
+        while ((w = atomic_fetch_add(&p->cursor, 1)) < npalabras) {
+            // se relee la palabra en cada paso: alguien despertado mas adelante
+            // en ella actua en esta misma ronda, como en el modo determinista
+            for (int b = 0; b < 64; b++) {
+                uint64_t bits = atomic_load_explicit(&mt->agenda.listos[w], memory_order_relaxed) >> b;
+                if (!bits) break;
+                b += __builtin_ctzll(bits);
+                int e = w * 64 + b;
+                tomarMutex(mt->perfil, a->id, &mt->cfg->mutex);
+                // otro hilo pudo dormirla o terminarla desde que se leyo la palabra
+                int activa = mt->estado[e] == ENTIDAD_ACTIVA;
+                if (activa && !ejecutarOp(mt, e, OP_PASO)) ejecutarOp(mt, e, OP_FIN);
+                pthread_mutex_unlock(&mt->cfg->mutex);
+                if (!activa) continue;
+                activos++;
+                if (!lote) entregar(mt, a->id, e);
+            }
+        }
+        atomic_fetch_add(&p->activos, activos);
+        entregarRonda(mt, a->id, lote);
+
+        pthread_barrier_wait(&p->barrera);
+        if (a->id == 0) {
+            int hubo = atomic_load(&p->activos) > 0;
+            if (hubo && mt->perfil) mt->perfil->rondas++;
+            if (hubo) revisarCheckpoint(mt);
+            p->seguir = hubo && siguienteListo(&mt->agenda, 0) >= 0 && !llegoAlLimite(mt, p->ticks_max);
+            atomic_store(&p->cursor, 0);
+            atomic_store(&p->activos, 0);
+        }
+        pthread_barrier_wait(&p->barrera);
+        if (!p->seguir) break;
+    }
+    usarLote(NULL);
+    return NULL;
+}
+
+int correrPool(Motor* mt, int nhilos, uint32_t ticks_max) {
+    if (nhilos < 1) nhilos = 1;
+    iniciarPendientes(mt, loteEventos(mt->eventos, 0));
+    usarLote(NULL);
+    if (llegoAlLimite(mt, ticks_max) || siguienteListo(&mt->agenda, 0) < 0) return 0;
+
+    Pool p;
+    p.mt = mt;
+    p.ticks_max = ticks_max;
+    p.seguir = 1;
+    p.estado = 0;
+    atomic_init(&p.cursor, 0);
+    atomic_init(&p.activos, 0);
+
+    pthread_t* hilos = malloc((size_t)nhilos * sizeof(pthread_t));
+    ArgsPool* args = malloc((size_t)nhilos * sizeof(ArgsPool));
+    if (!hilos || !args || pthread_barrier_init(&p.barrera, NULL, (unsigned)nhilos) != 0) {
+        printf("No se pudo crear el pool de %d hilos.\n", nhilos);
+        free(hilos); free(args);
+        return 1;
+    }
+    pthread_mutex_init(&p.arranque, NULL);
+    pthread_cond_init(&p.arranco, NULL);
+
+    // el hilo principal hace de trabajador 0
+    int creados = 0;
+    for (int i = 1; i < nhilos; i++) {
+        args[i].pool = &p;
+        args[i].id = i;
+        if (pthread_create(&hilos[i], NULL, hiloPool, &args[i]) != 0) break;
+        creados++;
+    }
+    int r = creados == nhilos - 1 ? 0 : 1;
+    pthread_mutex_lock(&p.arranque);
+    p.estado = r ? -1 : 1;
+    pthread_cond_broadcast(&p.arranco);
+    pthread_mutex_unlock(&p.arranque);
+
+    if (r) {
+        printf("No se pudieron crear los %d hilos del pool.\n", nhilos);
+    } else {
+        args[0].pool = &p;
+        args[0].id = 0;
+        hiloPool(&args[0]);
+    }
+
+    for (int i = 1; i <= creados; i++) pthread_join(hilos[i], NULL);
+    pthread_cond_destroy(&p.arranco);
+    pthread_mutex_destroy(&p.arranque);
+    pthread_barrier_destroy(&p.barrera);
+    free(hilos);
+    free(args);
+    return r;
+}
+
+// Repite las ops grabadas en el mismo orden en que las tomaron los hilos
+int correrReproduccion(Motor* mt, const TrazaLeida* t, uint64_t desde) {
+    LoteEventos* lote = loteEventos(mt->eventos, 0);
+    usarLote(lote);
+    int r = 0;
+    for (uint64_t k = desde; k < t->nops; k++) {
+        int e = (int)(t->ops[k] >> 2);
+        uint32_t tipo = t->ops[k] & 3u;
+        if (e >= mt->nentidades || tipo > OP_FIN) {
+            printf("Traza corrupta en la op %llu\n", (unsigned long long)(t->h.ops_base + k));
+            r = 1;
+            break;
+        }
+        uint32_t tick = mt->tick_global;
+        ejecutarOp(mt, e, (TipoOp)tipo);
+        if (mt->tick_global != tick) entregarRonda(mt, 0, lote);
+        revisarCheckpoint(mt);
+    }
+    entregarRonda(mt, 0, lote);
+    usarLote(NULL);
+    return r;
+}
@@ -0,0 +1,24 @@
+#ifndef EJECUCION_H
+#define EJECUCION_H
+
+#include <stdint.h>
+#include "motor.h"
+#include "traza.h"
+
+// Formas de correr la simulacion sobre un Motor ya iniciado. Todas paran
+// cuando no quedan entidades activas o cuando tick_global llega a ticks_max
+// (0 = sin limite); en ese caso las entidades quedan activas, sin OP_FIN.
+
+// Un hilo por entidad con sleep(1) entre iteraciones (modo original)
+int correrHilos(Motor *mt, uint32_t ticks_max);
+
+// Un solo hilo, por rondas en orden fijo, sin pausas
+void correrDeterminista(Motor *mt, uint32_t ticks_max);
+
+// nhilos trabajadores se reparten las entidades de cada ronda, sin pausas
+int correrPool(Motor *mt, int nhilos, uint32_t ticks_max);
+
+// Repite una traza grabada desde la op 'desde'
+int correrReproduccion(Motor *mt, const TrazaLeida *t, uint64_t desde);
+
+#endif
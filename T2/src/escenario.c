@@ -0,0 +1,207 @@
+#include "escenario.h"
+#include "ruta.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Los monstruos se usan directo desde el archivo, el layout tiene que calzar
+_Static_assert(sizeof(Point) == 2 * sizeof(int32_t), "Point debe ser 2 x int32");
+_Static_assert(sizeof(Monster) == 9 * sizeof(int32_t), "Monster debe ser 9 x int32");
+_Static_assert(sizeof(Ruta) == 3 * sizeof(int32_t), "Ruta debe ser 3 x int32");
+_Static_assert(sizeof(Segmento) == 4 * sizeof(int32_t), "Segmento debe ser 16 bytes");
+_Static_assert(sizeof(EscenarioHeader) <= ESCENARIO_ALINEACION * 2, "el encabezado cabe en el relleno de v1/v2");
+
+static uint64_t alinear(uint64_t x) {
+    return (x + ESCENARIO_ALINEACION - 1) & ~(uint64_t)(ESCENARIO_ALINEACION - 1);
+}
+
+int esEscenario(const void *buf, size_t len) {
+    return len >= sizeof(EscenarioHeader) && memcmp(buf, ESCENARIO_MAGIA, 4) == 0;
+}
+
+// Valida que una seccion de n elementos de tam bytes quepa en el archivo
+static int seccionValida(uint64_t off, int32_t n, size_t tam, size_t len) {
+    if (n < 0 || off % ESCENARIO_ALINEACION != 0 || off > len) return 0;
+    return (uint64_t)n * tam <= len - off;
+}
+
+// Heroes de v1/v2: el path viene como puntos y se comprime al cargarlo
+static int cargarHeroesV2(const EscenarioHeader *h, const char *base, GameConfig *cfg) {
+    const EscenarioHeroeV2 *eh = (const EscenarioHeroeV2 *)(base + h->off_heroes);
+    const Point *paths = (const Point *)(base + h->off_paths);
+    for (int i = 0; i < h->hero_count; ++i) {
+        if (eh[i].path_len < 0 || eh[i].path_len > MAX_PATH) return 1;
+        if (eh[i].path_ini < 0 || eh[i].path_ini > h->path_total - eh[i].path_len) return 1;
+    }
+
+    for (int i = 0; i < h->hero_count; ++i) {
+        Hero *hero = &cfg->heroes[i];
+        hero->hp = eh[i].hp;
+        hero->attack = eh[i].attack;
+        hero->range = eh[i].range;
+        hero->start = eh[i].start;
+        hero->posActual = eh[i].start;
+        hero->ruta = agregarRuta(cfg, paths + eh[i].path_ini, eh[i].path_len);
+        if (hero->ruta < 0) return 1;
+        hero->path_len = eh[i].path_len;
+    }
+    return 0;
+}
+
+static int cargarHeroesV3(const EscenarioHeader *h, const char *base, size_t len, GameConfig *cfg) {
+    if (h->ruta_count < 0 || h->seg_count < 0 ||
+        !seccionValida(h->off_rutas, h->ruta_count, sizeof(Ruta), len) ||
+        !seccionValida(h->off_segmentos, h->seg_count, sizeof(Segmento), len))
+        return 1;
+
+    const EscenarioHeroe *eh = (const EscenarioHeroe *)(base + h->off_heroes);
+    const Ruta *rutas = (const Ruta *)(base + h->off_rutas);
+    const Segmento *segs = (const Segmento *)(base + h->off_segmentos);
+    // avanzarRuta confia en que los tramos sumen el largo
+    for (int r = 0; r < h->ruta_count; ++r)
+        if (!rutaValida(&rutas[r], segs, h->seg_count)) return 1;
+    for (int i = 0; i < h->hero_count; ++i)
+        if (eh[i].ruta < -1 || eh[i].ruta >= h->ruta_count) return 1;
+
+    // rutas y tramos son chicos: se copian para que la config sea duena de todo salvo monstruos y terreno
+    if (reservarRutas(cfg, h->ruta_count, h->seg_count) != 0) return 1;
+    memcpy(cfg->rutas, rutas, (size_t)h->ruta_count * sizeof(Ruta));
+    memcpy(cfg->segmentos, segs, (size_t)h->seg_count * sizeof(Segmento));
+    cfg->ruta_count = h->ruta_count;
+    cfg->seg_count = h->seg_count;
+
+    for (int i = 0; i < h->hero_count; ++i) {
+        Hero *hero = &cfg->heroes[i];
+        hero->hp = eh[i].hp;
+        hero->attack = eh[i].attack;
+        hero->range = eh[i].range;
+        hero->start = eh[i].start;
+        hero->posActual = eh[i].start;
+        hero->ruta = eh[i].ruta;
+        hero->path_len = eh[i].ruta >= 0 ? cfg->rutas[eh[i].ruta].largo : 0;
+        hero->grupo = eh[i].grupo;
+    }
+    return 0;
+}
+
+// Toma posesion del mapa si todo sale bien; los monstruos y el terreno
+// quedan apuntando dentro de el (sin copiar), heroes y rutas se copian
+int cargarEscenario(void *mapa, size_t len, GameConfig *cfg) {
+    const EscenarioHeader *h = (const EscenarioHeader *)mapa;
+    const char *base = (const char *)mapa;
+
+    if (!esEscenario(mapa, len)) return 1;
+    if (h->version < 1 || h->version > ESCENARIO_VERSION || h->orden != ESCENARIO_ORDEN) return 1;
+    if (h->tamanio != len) return 1;
+    if (h->hero_count < 1 || h->hero_count > MAX_HEROES) return 1;
+    if (h->monster_count < 0 || h->monster_count > MAX_MONSTERS) return 1;
+    size_t tamHeroe = h->version >= 3 ? sizeof(EscenarioHeroe) : sizeof(EscenarioHeroeV2);
+    if (!seccionValida(h->off_heroes, h->hero_count, tamHeroe, len) ||
+        !seccionValida(h->off_monsters, h->monster_count, sizeof(Monster), len))
+        return 1;
+    if (h->version < 3 && !seccionValida(h->off_paths, h->path_total, sizeof(Point), len)) return 1;
+
+    uint64_t off_terreno = (h->version >= 2) ? h->off_terreno : 0;
+    if (off_terreno != 0) {
+        if (h->width <= 0 || h->height <= 0) return 1;
+        uint64_t celdas = (uint64_t)h->width * (uint64_t)h->height;
+        if (off_terreno % ESCENARIO_ALINEACION != 0 || off_terreno > len || celdas > len - off_terreno)
+            return 1;
+    }
+
+    memset(cfg, 0, sizeof(*cfg));
+    int err = reservarHeroes(cfg, h->hero_count);
+    if (!err) err = h->version >= 3 ? cargarHeroesV3(h, base, len, cfg) : cargarHeroesV2(h, base, cfg);
+    if (err) {
+        liberarConfig(cfg);
+        return 1;
+    }
+
+    cfg->width = h->width;
+    cfg->height = h->height;
+    cfg->hero_count = h->hero_count;
+    cfg->monster_count = h->monster_count;
+    cfg->monster_cap = h->monster_count;
+    cfg->monsters = (Monster *)(base + h->off_monsters);
+    cfg->terreno = off_terreno ? (uint8_t *)(base + off_terreno) : NULL;
+    cfg->mapa = mapa;
+    cfg->mapa_len = len;
+    return 0;
+}
+
+static int escribirRelleno(FILE *f, uint64_t hasta) {
+    static const char ceros[ESCENARIO_ALINEACION];
+    long pos = ftell(f);
+    if (pos < 0) return 1;
+    uint64_t falta = hasta - (uint64_t)pos;
+    return fwrite(ceros, 1, (size_t)falta, f) != falta;
+}
+
+int guardarEscenario(const char *ruta, const GameConfig *cfg) {
+    EscenarioHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magia, ESCENARIO_MAGIA, 4);
+    h.version = ESCENARIO_VERSION;
+    h.orden = ESCENARIO_ORDEN;
+    h.width = cfg->width;
+    h.height = cfg->height;
+    h.hero_count = cfg->hero_count;
+    h.monster_count = cfg->monster_count;
+    h.ruta_count = cfg->ruta_count;
+    h.seg_count = cfg->seg_count;
+
+    EscenarioHeroe *eh = malloc((size_t)(h.hero_count > 0 ? h.hero_count : 1) * sizeof(EscenarioHeroe));
+    if (!eh) {
+        printf("Sin memoria para guardar el escenario\n");
+        return 1;
+    }
+    for (int i = 0; i < cfg->hero_count; ++i) {
+        const Hero *hero = &cfg->heroes[i];
+        eh[i].hp = hero->hp;
+        eh[i].attack = hero->attack;
+        eh[i].range = hero->range;
+        eh[i].start = hero->start;
+        eh[i].ruta = hero->ruta;
+        eh[i].grupo = hero->grupo;
+    }
+
+    h.off_heroes = alinear(sizeof(EscenarioHeader));
+    h.off_rutas = alinear(h.off_heroes + (uint64_t)h.hero_count * sizeof(EscenarioHeroe));
+    h.off_segmentos = alinear(h.off_rutas + (uint64_t)h.ruta_count * sizeof(Ruta));
+    h.off_monsters = alinear(h.off_segmentos + (uint64_t)h.seg_count * sizeof(Segmento));
+    h.tamanio = h.off_monsters + (uint64_t)h.monster_count * sizeof(Monster);
+    if (cfg->terreno) {
+        h.off_terreno = alinear(h.tamanio);
+        h.tamanio = h.off_terreno + (uint64_t)cfg->width * (uint64_t)cfg->height;
+    }
+
+    FILE *f = fopen(ruta, "wb");
+    if (!f) {
+        printf("No se pudo crear el escenario: %s\n", ruta);
+        free(eh);
+        return 1;
+    }
+
+    int err = fwrite(&h, sizeof(h), 1, f) != 1;
+    err = err || escribirRelleno(f, h.off_heroes);
+    err = err || fwrite(eh, sizeof(EscenarioHeroe), (size_t)h.hero_count, f) != (size_t)h.hero_count;
+    err = err || escribirRelleno(f, h.off_rutas);
+    if (h.ruta_count > 0)
+        err = err || fwrite(cfg->rutas, sizeof(Ruta), (size_t)h.ruta_count, f) != (size_t)h.ruta_count;
+    err = err || escribirRelleno(f, h.off_segmentos);
+    if (h.seg_count > 0)
+        err = err || fwrite(cfg->segmentos, sizeof(Segmento), (size_t)h.seg_count, f) != (size_t)h.seg_count;
+    err = err || escribirRelleno(f, h.off_monsters);
+    if (h.monster_count > 0)
+        err = err || fwrite(cfg->monsters, sizeof(Monster), (size_t)h.monster_count, f) != (size_t)h.monster_count;
+    if (cfg->terreno) {
+        size_t celdas = (size_t)cfg->width * (size_t)cfg->height;
+        err = err || escribirRelleno(f, h.off_terreno);
+        err = err || fwrite(cfg->terreno, 1, celdas, f) != celdas;
+    }
+    free(eh);
+
+    if (fclose(f) != 0) err = 1;
+    if (err) printf("Error escribiendo el escenario: %s\n", ruta);
+    return err;
+}
@@ -0,0 +1,64 @@
+#ifndef ESCENARIO_H
+#define ESCENARIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// Formato binario de escenario (little endian, version 3):
+//   EscenarioHeader | EscenarioHeroe[hero_count] | Ruta[ruta_count] | Segmento[seg_count]
+//   | Monster[monster_count] | uint8_t terreno[width * height] (solo si off_terreno != 0)
+// Cada seccion parte alineada a ESCENARIO_ALINEACION bytes desde el inicio.
+// Las versiones 1 y 2 guardaban los paths como Point[path_total] (EscenarioHeroeV2)
+// y se comprimen al cargarlas. El encabezado de la 1 mide 64 bytes y sus
+// heroes empiezan justo ahi, donde estaria off_terreno: ese campo solo se lee
+// desde la version 2. Los campos de la 3 caen en el relleno de la 2, pero
+// tambien se leen solo si la version lo dice.
+#define ESCENARIO_MAGIA "T2SC"
+#define ESCENARIO_VERSION 3
+#define ESCENARIO_ORDEN 0x01020304u
+#define ESCENARIO_ALINEACION 64
+
+typedef struct {
+    char magia[4];
+    uint32_t version;
+    uint32_t orden;          // detecta archivos de otra endianness
+    int32_t width;
+    int32_t height;
+    int32_t hero_count;
+    int32_t monster_count;
+    int32_t path_total;      // puntos en la seccion de paths (v1/v2)
+    uint64_t off_heroes;
+    uint64_t off_paths;      // v1/v2
+    uint64_t off_monsters;
+    uint64_t tamanio;        // tamanio total esperado del archivo
+    uint64_t off_terreno;    // 0 si no hay muros ni terreno (v2)
+    int32_t ruta_count;      // v3
+    int32_t seg_count;
+    uint64_t off_rutas;
+    uint64_t off_segmentos;
+} EscenarioHeader;
+
+typedef struct {
+    int32_t hp;
+    int32_t attack;
+    int32_t range;
+    Point start;
+    int32_t ruta;            // indice en la seccion de rutas, -1 = sin path
+    int32_t grupo;
+} EscenarioHeroe;
+
+typedef struct {
+    int32_t hp;
+    int32_t attack;
+    int32_t range;
+    Point start;
+    int32_t path_ini;        // indice en la seccion de paths
+    int32_t path_len;
+} EscenarioHeroeV2;
+
+int esEscenario(const void *buf, size_t len);
+int cargarEscenario(void *mapa, size_t len, GameConfig *cfg);
+int guardarEscenario(const char *ruta, const GameConfig *cfg);
+
+#endif
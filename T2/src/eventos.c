@@ -0,0 +1,345 @@
+#include "eventos.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *nombreAccion[EV_TOTAL] = {
+    "inicio", "mueve", "ataca", "hp_restante", "muere",
+    "escapa", "ve", "alerta", "termina", "fin_juego"
+};
+
+static const char *nombreTipo[] = { "heroe", "monstruo", "juego" };
+
+// bloques impresos que el escritor guarda para reusar; el resto se libera
+#define LIBRES_MAX 64
+
+static _Thread_local LoteEventos *loteHilo;
+
+BufferEventos *bufferEventos(RegistroEventos *r, int i) {
+    return &r->buffers[i];
+}
+
+LoteEventos *loteEventos(RegistroEventos *r, int i) {
+    return i < r->nlotes ? &r->lotes[i] : NULL;
+}
+
+void usarLote(LoteEventos *l) {
+    loteHilo = l;
+}
+
+// Pasa *bloque al escritor y deja en su lugar uno libre, si hay; se llama
+// fuera de cfg->mutex
+static void entregarBloque(RegistroEventos *r, BloqueEventos **bloque, _Atomic uint64_t *primer) {
+    pthread_mutex_lock(&r->mutex);
+    (*bloque)->sig = r->cola;
+    r->cola = *bloque;
+    pthread_cond_signal(&r->cond);
+    *bloque = r->libres;
+    if (r->libres) {
+        r->libres = r->libres->sig;
+        r->nlibres--;
+        (*bloque)->n = 0;
+    }
+    pthread_mutex_unlock(&r->mutex);
+
+    atomic_store(primer, UINT64_MAX);
+}
+
+void registrarEvento(BufferEventos *b, uint32_t tick, AccionEvento accion, TipoEntidad tipo,
+                     int entidad, int objetivo, int hp, Point pos) {
+    b->contadores[accion]++;
+    if (b->reg->modo == LOG_SILENCIOSO) return;
+
+    LoteEventos *l = loteHilo;
+    BloqueEventos **bloque = l ? &l->actual : &b->actual;
+    _Atomic uint64_t *primer = l ? &l->primer_pendiente : &b->primer_pendiente;
+    if (!*bloque) {
+        *bloque = malloc(sizeof(BloqueEventos));
+        if (!*bloque) {
+            atomic_fetch_add(&b->reg->perdidos, 1);
+            return;
+        }
+        (*bloque)->n = 0;
+    }
+    // Cota inferior del seq antes de pedirlo, ver calcularMarca()
+    if ((*bloque)->n == 0) atomic_store(primer, atomic_load(&b->reg->seq));
+
+    Evento *e = &(*bloque)->ev[(*bloque)->n++];
+    memset(e, 0, sizeof(*e));
+    e->seq = atomic_fetch_add(&b->reg->seq, 1);
+    e->tick = tick;
+    e->entidad = entidad;
+    e->objetivo = objetivo;
+    e->hp = hp;
+    e->x = pos.x;
+    e->y = pos.y;
+    e->accion = (uint8_t)accion;
+    e->tipo = (uint8_t)tipo;
+
+    if ((*bloque)->n == EVENTOS_POR_BLOQUE) entregarBloque(b->reg, bloque, primer);
+}
+
+// Pasa el bloque de la entidad al escritor; con un lote en uso no hay nada
+void entregarEventos(BufferEventos *b) {
+    if (!b->actual || b->actual->n == 0) return;
+    entregarBloque(b->reg, &b->actual, &b->primer_pendiente);
+}
+
+// Al cerrar la ronda el lote entrega lo que junto, aunque no este lleno
+void entregarLote(RegistroEventos *r, LoteEventos *l) {
+    if (!l || !l->actual || l->actual->n == 0) return;
+    entregarBloque(r, &l->actual, &l->primer_pendiente);
+}
+
+static void renderTexto(FILE *f, const Evento *e) {
+    int heroe = (e->tipo == ENT_HEROE);
+    switch ((AccionEvento)e->accion) {
+    case EV_INICIO:
+        if (heroe) fprintf(f, "[HEROE %d] Inicia en (%d,%d) con %d HP\n", e->entidad, e->x, e->y, e->hp);
+        else fprintf(f, "[MONSTRUO %d] Inicia en (%d,%d), HP=%d, Vision=%d\n",
+                     e->entidad, e->x, e->y, e->hp, e->objetivo);
+        break;
+    case EV_MUEVE:
+        if (heroe) fprintf(f, "[HEROE %d] Se mueve a (%d,%d)\n", e->entidad, e->x, e->y);
+        else fprintf(f, "[MONSTRUO %d] Avanza hacia HEROE %d -> (%d,%d)\n",
+                     e->entidad, e->objetivo, e->x, e->y);
+        break;
+    case EV_ATACA:
+        if (heroe) fprintf(f, "[HEROE %d] Ataca a MONSTRUO %d (HP antes=%d)\n", e->entidad, e->objetivo, e->hp);
+        else fprintf(f, "[MONSTRUO %d] Ataca a HEROE %d (HP antes: %d)\n", e->entidad, e->objetivo, e->hp);
+        break;
+    case EV_HP_RESTANTE:
+        fprintf(f, "[%s %d] HP restante: %d\n", heroe ? "HEROE" : "MONSTRUO", e->entidad, e->hp);
+        break;
+    case EV_MUERE:
+        if (heroe) fprintf(f, "[HEROE %d] Muere por MONSTRUO %d\n", e->entidad, e->objetivo);
+        else fprintf(f, "[MONSTRUO %d] Muere\n", e->entidad);
+        break;
+    case EV_ESCAPA:
+        fprintf(f, "[HEROE %d] Llega al final y escapa (HP=%d)\n", e->entidad, e->hp);
+        break;
+    case EV_VE:
+        fprintf(f, "[MONSTRUO %d] Ve al HEROE %d a distancia %d\n", e->entidad, e->objetivo, e->hp);
+        break;
+    case EV_ALERTA:
+        fprintf(f, "[MONSTRUO %d] Alerta a MONSTRUO %d (Heroe %d)\n", e->entidad, e->objetivo, e->hp);
+        break;
+    case EV_TERMINA:
+        if (heroe) fprintf(f, "[HEROE %d] Ha muerto.\n", e->entidad);
+        else fprintf(f, "[MONSTRUO %d] Termina hilo en (%d,%d)\n", e->entidad, e->x, e->y);
+        break;
+    case EV_FIN_JUEGO:
+        if (e->objetivo == FIN_SIN_ACTIVOS)
+            fprintf(f, "=== No quedan heroes activos. Fin de la simulacion. ===\n");
+        else if (e->objetivo == FIN_TODOS_MUERTOS)
+            fprintf(f, "=== Todos los heroes han muerto. Fin de la simulacion. ===\n");
+        else
+            fprintf(f, "=== Todos los heroes escaparon. Fin de la simulacion. ===\n");
+        break;
+    default:
+        break;
+    }
+}
+
+static void renderJson(FILE *f, const Evento *e) {
+    fprintf(f, "{\"seq\":%llu,\"tick\":%u,\"tipo\":\"%s\",\"id\":%d,\"accion\":\"%s\","
+               "\"objetivo\":%d,\"hp\":%d,\"x\":%d,\"y\":%d}\n",
+            (unsigned long long)e->seq, e->tick, nombreTipo[e->tipo], e->entidad,
+            nombreAccion[e->accion], e->objetivo, e->hp, e->x, e->y);
+}
+
+static int compararSeq(const void *a, const void *b) {
+    uint64_t x = ((const Evento *)a)->seq, y = ((const Evento *)b)->seq;
+    return (x > y) - (x < y);
+}
+
+// Todo evento con seq menor a la marca ya fue entregado por su hilo:
+// se lee el contador global antes que los buffers (ver registrarEvento)
+static uint64_t calcularMarca(RegistroEventos *r) {
+    uint64_t marca = atomic_load(&r->seq);
+    for (int i = 0; i < r->nbuffers; ++i) {
+        uint64_t p = atomic_load(&r->buffers[i].primer_pendiente);
+        if (p < marca) marca = p;
+    }
+    for (int i = 0; i < r->nlotes; ++i) {
+        uint64_t p = atomic_load(&r->lotes[i].primer_pendiente);
+        if (p < marca) marca = p;
+    }
+    return marca;
+}
+
+static int crecerPendientes(RegistroEventos *r, size_t n) {
+    if (n <= r->cappendientes) return 0;
+    size_t cap = r->cappendientes ? r->cappendientes * 2 : 1024;
+    while (cap < n) cap *= 2;
+    Evento *nuevo = realloc(r->pendientes, cap * sizeof(Evento));
+    if (!nuevo) return 1;
+    r->pendientes = nuevo;
+    Evento *mezcla = realloc(r->mezcla, cap * sizeof(Evento));
+    if (!mezcla) return 1;
+    r->mezcla = mezcla;
+    r->cappendientes = cap;
+    return 0;
+}
+
+// Los pendientes ya estan ordenados: se ordenan solo los recien llegados y se
+// mezclan con ellos. Los bloques vacios vuelven a la lista de libres.
+static void agregarPendientes(RegistroEventos *r, BloqueEventos *cola) {
+    size_t viejos = r->npendientes;
+    BloqueEventos *vacios = NULL;
+    while (cola) {
+        BloqueEventos *sig = cola->sig;
+        if (crecerPendientes(r, r->npendientes + (size_t)cola->n) == 0) {
+            memcpy(r->pendientes + r->npendientes, cola->ev, (size_t)cola->n * sizeof(Evento));
+            r->npendientes += (size_t)cola->n;
+        } else {
+            atomic_fetch_add(&r->perdidos, (uint64_t)cola->n);
+        }
+        cola->sig = vacios;
+        vacios = cola;
+        cola = sig;
+    }
+
+    Evento *p = r->pendientes;
+    size_t n = r->npendientes;
+    qsort(p + viejos, n - viejos, sizeof(Evento), compararSeq);
+    if (viejos > 0 && viejos < n && p[viejos - 1].seq > p[viejos].seq) {
+        // el destino nunca alcanza a los nuevos que faltan leer
+        memcpy(r->mezcla, p, viejos * sizeof(Evento));
+        size_t i = 0, j = viejos, k = 0;
+        while (i < viejos && j < n)
+            p[k++] = r->mezcla[i].seq < p[j].seq ? r->mezcla[i++] : p[j++];
+        while (i < viejos) p[k++] = r->mezcla[i++];
+    }
+
+    pthread_mutex_lock(&r->mutex);
+    while (vacios && r->nlibres < LIBRES_MAX) {
+        BloqueEventos *sig = vacios->sig;
+        vacios->sig = r->libres;
+        r->libres = vacios;
+        r->nlibres++;
+        vacios = sig;
+    }
+    pthread_mutex_unlock(&r->mutex);
+    while (vacios) {
+        BloqueEventos *sig = vacios->sig;
+        free(vacios);
+        vacios = sig;
+    }
+}
+
+static void emitirHasta(RegistroEventos *r, uint64_t marca) {
+    size_t i = 0;
+    for (; i < r->npendientes && r->pendientes[i].seq < marca; ++i) {
+        if (r->modo == LOG_JSON) renderJson(r->salida, &r->pendientes[i]);
+        else renderTexto(r->salida, &r->pendientes[i]);
+    }
+    memmove(r->pendientes, r->pendientes + i, (r->npendientes - i) * sizeof(Evento));
+    r->npendientes -= i;
+}
+
+static void *hiloEscritor(void *arg) {
+    RegistroEventos *r = (RegistroEventos *)arg;
+
+    pthread_mutex_lock(&r->mutex);
+    for (;;) {
+        while (!r->cola && !r->terminar) pthread_cond_wait(&r->cond, &r->mutex);
+        int fin = r->terminar;
+        pthread_mutex_unlock(&r->mutex);
+
+        uint64_t marca = fin ? UINT64_MAX : calcularMarca(r);
+
+        pthread_mutex_lock(&r->mutex);
+        BloqueEventos *cola = r->cola;
+        r->cola = NULL;
+        pthread_mutex_unlock(&r->mutex);
+
+        agregarPendientes(r, cola);
+        emitirHasta(r, marca);
+        if (fin) break;
+
+        pthread_mutex_lock(&r->mutex);
+    }
+
+    fflush(r->salida);
+    return NULL;
+}
+
+int iniciarEventos(RegistroEventos *r, ModoLog modo, FILE *salida, int nbuffers, int nlotes) {
+    memset(r, 0, sizeof(*r));
+    r->modo = modo;
+    r->salida = salida;
+    r->nbuffers = nbuffers;
+    r->nlotes = nlotes > 0 ? nlotes : 1;
+    atomic_init(&r->seq, 0);
+    atomic_init(&r->perdidos, 0);
+
+    r->buffers = calloc((size_t)(nbuffers > 0 ? nbuffers : 1), sizeof(BufferEventos));
+    r->lotes = calloc((size_t)r->nlotes, sizeof(LoteEventos));
+    if (!r->buffers || !r->lotes) {
+        printf("Sin memoria para los buffers de eventos.\n");
+        free(r->buffers);
+        free(r->lotes);
+        return 1;
+    }
+    for (int i = 0; i < nbuffers; ++i) {
+        r->buffers[i].reg = r;
+        atomic_init(&r->buffers[i].primer_pendiente, UINT64_MAX);
+    }
+    for (int i = 0; i < r->nlotes; ++i) atomic_init(&r->lotes[i].primer_pendiente, UINT64_MAX);
+
+    pthread_mutex_init(&r->mutex, NULL);
+    pthread_cond_init(&r->cond, NULL);
+
+    if (modo != LOG_SILENCIOSO && pthread_create(&r->escritor, NULL, hiloEscritor, r) != 0) {
+        printf("No se pudo crear el hilo escritor.\n");
+        free(r->buffers);
+        free(r->lotes);
+        return 1;
+    }
+    return 0;
+}
+
+// Llamar despues de que todas las entidades terminaron
+void terminarEventos(RegistroEventos *r) {
+    if (r->modo != LOG_SILENCIOSO) {
+        // lo que haya quedado sin entregar (una corrida cortada) sale igual
+        for (int i = 0; i < r->nlotes; ++i) entregarLote(r, &r->lotes[i]);
+        for (int i = 0; i < r->nbuffers; ++i) entregarEventos(&r->buffers[i]);
+        pthread_mutex_lock(&r->mutex);
+        r->terminar = 1;
+        pthread_cond_signal(&r->cond);
+        pthread_mutex_unlock(&r->mutex);
+        pthread_join(r->escritor, NULL);
+    } else {
+        uint64_t total[EV_TOTAL] = {0};
+        for (int i = 0; i < r->nbuffers; ++i)
+            for (int a = 0; a < EV_TOTAL; ++a) total[a] += r->buffers[i].contadores[a];
+
+        fprintf(r->salida, "=== Resumen de eventos ===\n");
+        for (int a = 0; a < EV_TOTAL; ++a)
+            fprintf(r->salida, "%-12s %llu\n", nombreAccion[a], (unsigned long long)total[a]);
+        fflush(r->salida);
+    }
+
+    uint64_t perdidos = atomic_load(&r->perdidos);
+    if (perdidos)
+        fprintf(stderr, "[WARN] Se perdieron %llu eventos por falta de memoria\n", (unsigned long long)perdidos);
+
+    pthread_mutex_destroy(&r->mutex);
+    pthread_cond_destroy(&r->cond);
+    for (int i = 0; i < r->nbuffers; ++i) free(r->buffers[i].actual);
+    for (int i = 0; i < r->nlotes; ++i) free(r->lotes[i].actual);
+    while (r->libres) {
+        BloqueEventos *sig = r->libres->sig;
+        free(r->libres);
+        r->libres = sig;
+    }
+    free(r->buffers);
+    free(r->lotes);
+    free(r->pendientes);
+    free(r->mezcla);
+    r->buffers = NULL;
+    r->lotes = NULL;
+    r->pendientes = NULL;
+    r->mezcla = NULL;
+}
@@ -0,0 +1,122 @@
+#ifndef EVENTOS_H
+#define EVENTOS_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "config.h"
+
+typedef enum {
+    EV_INICIO,        // hp, x/y; monstruo: objetivo = vision
+    EV_MUEVE,         // x/y nueva; monstruo: objetivo = heroe perseguido
+    EV_ATACA,         // objetivo, hp = hp del objetivo antes del golpe
+    EV_HP_RESTANTE,   // hp que le queda a la entidad golpeada
+    EV_MUERE,         // objetivo = quien lo mato
+    EV_ESCAPA,        // hp al escapar
+    EV_VE,            // objetivo = heroe visto, hp = distancia
+    EV_ALERTA,        // objetivo = monstruo alertado, hp = heroe visto
+    EV_TERMINA,       // fin del hilo, x/y final
+    EV_FIN_JUEGO,     // objetivo = MotivoFin
+    EV_TOTAL
+} AccionEvento;
+
+typedef enum {
+    ENT_HEROE,
+    ENT_MONSTRUO,
+    ENT_JUEGO
+} TipoEntidad;
+
+typedef enum {
+    FIN_SIN_ACTIVOS,
+    FIN_TODOS_MUERTOS,
+    FIN_TODOS_ESCAPADOS
+} MotivoFin;
+
+// Registro binario de tamanio fijo (40 bytes)
+typedef struct {
+    uint64_t seq;       // orden global en que ocurrio (bajo cfg->mutex)
+    uint32_t tick;      // iteracion del hilo que lo genero
+    int32_t entidad;    // id de heroe/monstruo (base 1)
+    int32_t objetivo;
+    int32_t hp;
+    int32_t x;
+    int32_t y;
+    uint8_t accion;
+    uint8_t tipo;
+    uint8_t reservado[6];
+} Evento;
+
+typedef enum {
+    LOG_TEXTO,
+    LOG_JSON,
+    LOG_SILENCIOSO      // solo contadores, no guarda eventos
+} ModoLog;
+
+#define EVENTOS_POR_BLOQUE 64
+
+typedef struct BloqueEventos {
+    struct BloqueEventos *sig;
+    int n;
+    Evento ev[EVENTOS_POR_BLOQUE];
+} BloqueEventos;
+
+struct RegistroEventos;
+
+// Buffer de un solo hilo: se llena sin locks y se entrega al escritor por bloques
+typedef struct {
+    struct RegistroEventos *reg;
+    BloqueEventos *actual;
+    _Atomic uint64_t primer_pendiente;  // seq mas bajo aun no entregado
+    uint64_t contadores[EV_TOTAL];
+} BufferEventos;
+
+// Lote de un trabajador (modos determinista, pool y reproduccion): mientras
+// el hilo lo usa, los eventos de todas las entidades que procesa van a sus
+// bloques, que se entregan llenos o al cerrar la ronda
+typedef struct {
+    BloqueEventos *actual;
+    _Atomic uint64_t primer_pendiente;
+} LoteEventos;
+
+typedef struct RegistroEventos {
+    ModoLog modo;
+    FILE *salida;
+    _Atomic uint64_t seq;
+    BufferEventos *buffers;
+    int nbuffers;
+    LoteEventos *lotes;
+    int nlotes;
+    _Atomic uint64_t perdidos; // eventos descartados por falta de memoria
+
+    pthread_mutex_t mutex;   // solo protege la cola de bloques, no el juego
+    pthread_cond_t cond;
+    BloqueEventos *cola;
+    BloqueEventos *libres;   // bloques ya impresos, para no volver a pedirlos
+    int nlibres;
+    int terminar;
+    pthread_t escritor;
+
+    Evento *pendientes;      // eventos recibidos que aun no se pueden imprimir, por seq
+    Evento *mezcla;          // auxiliar para mezclar los recien llegados
+    size_t npendientes;
+    size_t cappendientes;
+} RegistroEventos;
+
+// nlotes: trabajadores que pueden usar un lote a la vez
+int iniciarEventos(RegistroEventos *r, ModoLog modo, FILE *salida, int nbuffers, int nlotes);
+void terminarEventos(RegistroEventos *r);
+BufferEventos *bufferEventos(RegistroEventos *r, int i);
+
+// Lote i, o NULL si no hay tantos (el hilo entrega por entidad, como en el
+// modo un-hilo-por-entidad)
+LoteEventos *loteEventos(RegistroEventos *r, int i);
+// Desde aca los eventos que registre este hilo van al lote (NULL = a cada buffer)
+void usarLote(LoteEventos *l);
+void entregarLote(RegistroEventos *r, LoteEventos *l);
+
+void registrarEvento(BufferEventos *b, uint32_t tick, AccionEvento accion, TipoEntidad tipo,
+                     int entidad, int objetivo, int hp, Point pos);
+void entregarEventos(BufferEventos *b);
+
+#endif
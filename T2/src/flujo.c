@@ -0,0 +1,174 @@
+#include "flujo.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int iniciarFlujos(Flujos *f, const GameConfig *cfg) {
+    f->width = cfg->width;
+    f->height = cfg->height;
+    f->terreno = cfg->terreno;
+    f->ncampos = cfg->hero_count < FLUJO_MAX_CAMPOS ? cfg->hero_count : FLUJO_MAX_CAMPOS;
+    size_t bytesCampo = (size_t)cfg->width * (size_t)cfg->height * sizeof(uint32_t);
+    size_t entran = bytesCampo ? FLUJO_MAX_BYTES / bytesCampo : (size_t)f->ncampos;
+    if (entran < 1) entran = 1;
+    if ((size_t)f->ncampos > entran) f->ncampos = (int)entran;
+    f->reloj = 0;
+    f->reconstrucciones = 0;
+    f->consultas = 0;
+    for (int i = 0; i <= TERRENO_COSTO_MAX; ++i) {
+        f->buckets[i] = NULL;
+        f->nbucket[i] = f->capbucket[i] = 0;
+    }
+
+    // las distancias se piden recien cuando alguien persigue a un heroe
+    f->campos = calloc((size_t)(f->ncampos > 0 ? f->ncampos : 1), sizeof(CampoFlujo));
+    if (!f->campos) {
+        f->ncampos = 0;
+        printf("Sin memoria para los campos de flujo.\n");
+        return 1;
+    }
+    return 0;
+}
+
+void liberarFlujos(Flujos *f) {
+    for (int i = 0; i < f->ncampos; ++i) free(f->campos[i].dist);
+    for (int i = 0; i <= TERRENO_COSTO_MAX; ++i) free(f->buckets[i]);
+    free(f->campos);
+    f->campos = NULL;
+    f->ncampos = 0;
+}
+
+static int dentro(const Flujos *f, Point p) {
+    return p.x >= 0 && p.y >= 0 && p.x < f->width && p.y < f->height;
+}
+
+static int costoCelda(const Flujos *f, int celda) {
+    return f->terreno ? f->terreno[celda] : 1;
+}
+
+static int empujar(Flujos *f, int b, int celda) {
+    if (f->nbucket[b] == f->capbucket[b]) {
+        int cap = f->capbucket[b] ? f->capbucket[b] * 2 : 1024;
+        int *nuevo = realloc(f->buckets[b], (size_t)cap * sizeof(int));
+        if (!nuevo) return 1;
+        f->buckets[b] = nuevo;
+        f->capbucket[b] = cap;
+    }
+    f->buckets[b][f->nbucket[b]++] = celda;
+    return 0;
+}
+
+// Dijkstra con cola de Dial: los costos van de 1 a TERRENO_COSTO_MAX, asi que
+// basta un arreglo circular de TERRENO_COSTO_MAX + 1 buckets y todo es O(celdas)
+static int construirCampo(Flujos *f, CampoFlujo *c, Point origen) {
+    size_t celdas = (size_t)f->width * (size_t)f->height;
+    if (!c->dist) {
+        c->dist = malloc(celdas * sizeof(uint32_t));
+        if (!c->dist) {
+            printf("Sin memoria para un campo de flujo de %dx%d\n", f->width, f->height);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < celdas; ++i) c->dist[i] = FLUJO_INF;
+
+    const int nb = TERRENO_COSTO_MAX + 1;
+    for (int b = 0; b < nb; ++b) f->nbucket[b] = 0;
+
+    int src = origen.y * f->width + origen.x;
+    c->dist[src] = 0;
+    if (empujar(f, 0, src)) return 1;
+
+    int pendientes = 1;
+    for (uint32_t actual = 0; pendientes > 0; ++actual) {
+        int b = (int)(actual % (uint32_t)nb);
+        for (int k = 0; k < f->nbucket[b]; ++k) {
+            int v = f->buckets[b][k];
+            pendientes--;
+            if (c->dist[v] != actual) continue;   // entrada vieja
+
+            int x = v % f->width, y = v / f->width;
+            int vecinos[4] = {
+                x + 1 < f->width ? v + 1 : -1,
+                x > 0 ? v - 1 : -1,
+                y + 1 < f->height ? v + f->width : -1,
+                y > 0 ? v - f->width : -1
+            };
+            for (int n = 0; n < 4; ++n) {
+                int u = vecinos[n];
+                if (u < 0) continue;
+                int costo = costoCelda(f, u);
+                if (costo == 0) continue;
+                uint32_t nd = actual + (uint32_t)costo;
+                if (nd < c->dist[u]) {
+                    c->dist[u] = nd;
+                    if (empujar(f, (int)(nd % (uint32_t)nb), u)) return 1;
+                    pendientes++;
+                }
+            }
+        }
+        f->nbucket[b] = 0;
+    }
+
+    c->origen = origen;
+    c->valido = 1;
+    f->reconstrucciones++;
+    return 0;
+}
+
+// Un paso por eje, primero x (igual que el movimiento original sin obstaculos)
+Point pasoGreedy(Point objetivo, Point desde) {
+    Point p = desde;
+    if (objetivo.x > p.x) p.x++;
+    else if (objetivo.x < p.x) p.x--;
+    else if (objetivo.y > p.y) p.y++;
+    else if (objetivo.y < p.y) p.y--;
+    return p;
+}
+
+// Campo con origen en la celda pedida, o uno para rearmarlo: el primero
+// invalido, o si no hay, el usado hace mas tiempo. Se miran todos porque un
+// rearmado que fallo deja huecos invalidos entre campos validos
+static CampoFlujo *buscarCampo(Flujos *f, Point origen, int *hallado) {
+    CampoFlujo *libre = NULL, *viejo = &f->campos[0];
+    for (int i = 0; i < f->ncampos; ++i) {
+        CampoFlujo *c = &f->campos[i];
+        if (!c->valido) {
+            if (!libre) libre = c;
+            continue;
+        }
+        if (c->origen.x == origen.x && c->origen.y == origen.y) {
+            *hallado = 1;
+            return c;
+        }
+        if (c->uso < viejo->uso) viejo = c;
+    }
+    *hallado = 0;
+    return libre ? libre : viejo;
+}
+
+// Vecino con menor distancia al objetivo; si no se llega, se queda quieto
+Point pasoFlujo(Flujos *f, Point objetivo, Point desde) {
+    if (f->ncampos == 0 || !dentro(f, objetivo) || !dentro(f, desde))
+        return pasoGreedy(objetivo, desde);
+
+    int hallado;
+    CampoFlujo *c = buscarCampo(f, objetivo, &hallado);
+    if (!hallado && construirCampo(f, c, objetivo) != 0) {
+        c->valido = 0;
+        return pasoGreedy(objetivo, desde);
+    }
+    c->uso = ++f->reloj;
+    f->consultas++;
+
+    int v = desde.y * f->width + desde.x;
+    uint32_t mejor = c->dist[v];
+    Point paso = desde;
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    for (int n = 0; n < 4; ++n) {
+        Point q = { desde.x + dx[n], desde.y + dy[n] };
+        if (!dentro(f, q)) continue;
+        uint32_t d = c->dist[q.y * f->width + q.x];
+        if (d < mejor) { mejor = d; paso = q; }
+    }
+    return paso;
+}
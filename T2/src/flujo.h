@@ -0,0 +1,45 @@
+#ifndef FLUJO_H
+#define FLUJO_H
+
+#include <stdint.h>
+#include "config.h"
+
+#define FLUJO_INF UINT32_MAX
+
+// Como mucho se guardan estos campos; con grupos grandes varios heroes
+// comparten celda y por lo tanto campo, asi la memoria no crece con los heroes.
+// En mapas grandes manda el tope en bytes (siempre queda al menos un campo)
+#define FLUJO_MAX_CAMPOS 64
+#define FLUJO_MAX_BYTES (64u << 20)
+
+// Campo de distancias hacia una celda (donde esta algun heroe). Se busca por
+// celda de origen; si no esta, se rearma el usado hace mas tiempo.
+typedef struct {
+    uint32_t *dist;        // costo acumulado hasta el origen, FLUJO_INF si no se llega
+    Point origen;          // celda con que se construyo
+    int valido;
+    uint64_t uso;          // ultima consulta, para elegir a quien reemplazar
+} CampoFlujo;
+
+typedef struct {
+    int width;
+    int height;
+    const uint8_t *terreno;   // costo de entrar a cada celda, 0 = muro (NULL = todo 1)
+    CampoFlujo *campos;       // min(heroes, FLUJO_MAX_CAMPOS, lo que entra en FLUJO_MAX_BYTES)
+    int ncampos;
+    uint64_t reloj;
+
+    int *buckets[TERRENO_COSTO_MAX + 1];   // cola de Dial (costos enteros chicos)
+    int nbucket[TERRENO_COSTO_MAX + 1];
+    int capbucket[TERRENO_COSTO_MAX + 1];
+
+    uint64_t reconstrucciones;
+    uint64_t consultas;
+} Flujos;
+
+int iniciarFlujos(Flujos *f, const GameConfig *cfg);
+void liberarFlujos(Flujos *f);
+Point pasoFlujo(Flujos *f, Point objetivo, Point desde);
+Point pasoGreedy(Point objetivo, Point desde);
+
+#endif
@@ -0,0 +1,422 @@
+#include "motor.h"
+#include "traza.h"
+#include "ruta.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const Point SIN_POS = { 0, 0 };
+
+// Medicion por fase; sin --perfil no se llama al reloj
+static uint64_t medirDesde(const Motor* mt) {
+    return mt->perfil ? perfilAhora() : 0;
+}
+
+static void medirFase(Motor* mt, Fase f, uint64_t* t) {
+    if (mt->perfil) perfilFase(&mt->perfil->juego, f, t);
+}
+
+int distanciaManhattan(Point a, Point b) {
+    return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+static int heroesActivosCount(GameConfig* cfg) {
+    int c = 0;
+    for (int i = 0; i < cfg->hero_count; i++) {
+        if (cfg->heroes[i].hp > 0 && !cfg->heroes[i].escapado) c++;
+    }
+    return c;
+}
+
+static int todosMuertos(GameConfig* cfg) {
+    for (int i = 0; i < cfg->hero_count; i++)
+        if (cfg->heroes[i].hp > 0) return 0;
+    return 1;
+}
+
+static int todosEscapados(GameConfig* cfg) {
+    for (int i = 0; i < cfg->hero_count; i++)
+        if (!cfg->heroes[i].escapado) return 0;
+    return 1;
+}
+
+static void ponerEstado(Motor* mt, int entidad, EstadoEntidad e) {
+    mt->estado[entidad] = (uint8_t)e;
+    marcarListo(&mt->agenda, entidad, e == ENTIDAD_ACTIVA);
+}
+
+// vuelve a la ronda un monstruo dormido (y a su hilo, si tiene uno)
+static void despertar(Motor* mt, int entidad) {
+    if (mt->estado[entidad] != ENTIDAD_DORMIDA) return;
+    Agenda* a = &mt->agenda;
+    a->gen[entidad - mt->cfg->hero_count]++;
+    a->despertares++;
+    ponerEstado(mt, entidad, ENTIDAD_ACTIVA);
+    if (a->conds) pthread_cond_signal(&a->conds[entidad]);
+}
+
+// Un monstruo sin alertar solo cambia de idea cuando un heroe entra a su
+// vision (o lo matan, o termina el juego): hasta entonces no se lo corre.
+// Una traza vieja puede mandarle pasos estando dormido; como sin alertar no
+// se mueve, sus suscripciones siguen valiendo y solo se corre dormido_en
+static void dormir(Motor* mt, int idx) {
+    int entidad = mt->cfg->hero_count + idx;
+    Agenda* a = &mt->agenda;
+    if (mt->estado[entidad] == ENTIDAD_DORMIDA) {
+        a->dormido_en[entidad] = mt->tick_global;
+        return;
+    }
+    if (suscribir(a, &mt->cfg->monsters[idx], idx) != 0) return;
+    ponerEstado(mt, entidad, ENTIDAD_DORMIDA);
+    a->dormido_en[entidad] = mt->tick_global;
+    a->dormidas++;
+}
+
+// un heroe entro a la celda p: despierta a los dormidos que lo ven desde ahi
+static void heroeEntra(Motor* mt, Point p) {
+    Agenda* a = &mt->agenda;
+    Zona* z = zonaDe(a, p);
+    int k = 0;
+    for (int i = 0; i < z->n; i++) {
+        Suscripcion s = z->v[i];
+        a->revisadas++;
+        if (s.gen != a->gen[s.monstruo]) continue;
+        const Monster* m = &mt->cfg->monsters[s.monstruo];
+        if (distanciaManhattan(p, m->pos) <= m->vision) despertar(mt, mt->cfg->hero_count + s.monstruo);
+        else z->v[k++] = s;
+    }
+    z->n = k;
+}
+
+static void terminarJuego(Motor* mt) {
+    mt->cfg->juegoActivo = 0;
+    for (int e = mt->cfg->hero_count; e < mt->nentidades; e++) despertar(mt, e);
+}
+
+static void actualizarEstadoJuego(Motor* mt, BufferEventos* ev, uint32_t tick) {
+    GameConfig* cfg = mt->cfg;
+    int activos = mt->heroes_activos;
+    if (activos == 0) {
+        terminarJuego(mt);
+        registrarEvento(ev, tick, EV_FIN_JUEGO, ENT_JUEGO, 0, FIN_SIN_ACTIVOS, 0, SIN_POS);
+        return;
+    }
+    if (todosMuertos(cfg)) {
+        terminarJuego(mt);
+        registrarEvento(ev, tick, EV_FIN_JUEGO, ENT_JUEGO, 0, FIN_TODOS_MUERTOS, 0, SIN_POS);
+        return;
+    }
+    if (todosEscapados(cfg)) {
+        terminarJuego(mt);
+        registrarEvento(ev, tick, EV_FIN_JUEGO, ENT_JUEGO, 0, FIN_TODOS_ESCAPADOS, 0, SIN_POS);
+        return;
+    }
+}
+
+// alerta a otros monstruos cercanos si uno ve a un heroe
+static void alertarMonstruos(Motor* mt, BufferEventos* ev, uint32_t tick,
+                             int idx_monstruo_alerta, int id_heroe_visto) {
+    GameConfig* cfg = mt->cfg;
+    Monster* m = &cfg->monsters[idx_monstruo_alerta];
+
+    for (int i = 0; i < cfg->monster_count; i++) {
+        if (i == idx_monstruo_alerta) continue;
+        Monster* otro = &cfg->monsters[i];
+        if (otro->hp <= 0 || otro->alertado) continue;
+        if (cfg->heroes[id_heroe_visto].escapado) continue;
+
+        int d = distanciaManhattan(m->pos, otro->pos);
+        if (d <= m->vision) {
+            otro->alertado = 1;
+            otro->target_hero_id = id_heroe_visto;
+            despertar(mt, cfg->hero_count + i);
+            registrarEvento(ev, tick, EV_ALERTA, ENT_MONSTRUO, m->id, otro->id, id_heroe_visto + 1, m->pos);
+        }
+    }
+}
+
+static void inicioHeroe(Motor* mt, int idx, uint32_t tick) {
+    Hero* hero = &mt->cfg->heroes[idx];
+    hero->posActual = hero->start;
+    reiniciarRuta(hero);
+    hero->path_finished = 0;
+    hero->en_combate = 0;
+    hero->escapado = 0;
+    registrarEvento(bufferEventos(mt->eventos, idx), tick, EV_INICIO, ENT_HEROE,
+                    hero->id, -1, hero->hp, hero->posActual);
+    if (hero->hp > 0) heroeEntra(mt, hero->posActual);
+}
+
+// una iteracion del heroe: combate o movimiento. 0 si el heroe ya termino
+static int pasoHeroe(Motor* mt, int idx, uint32_t tick) {
+    GameConfig* cfg = mt->cfg;
+    Hero* hero = &cfg->heroes[idx];
+    BufferEventos* ev = bufferEventos(mt->eventos, idx);
+
+    if (!cfg->juegoActivo || hero->hp <= 0 || hero->escapado) return 0;
+
+    uint64_t t = medirDesde(mt);
+    hero->en_combate = 0;
+    Monster* monstruo_atacante = NULL;
+
+    // combate
+    for (int i = 0; i < cfg->monster_count; i++) {
+        Monster* m = &cfg->monsters[i];
+        if (m->hp <= 0) continue;
+        int d = distanciaManhattan(hero->posActual, m->pos);
+        if (d <= hero->range) {
+            hero->en_combate = 1;
+            monstruo_atacante = m;
+            break;
+        }
+    }
+    if (hero->en_combate && monstruo_atacante) {
+        Monster* m = monstruo_atacante;
+        registrarEvento(ev, tick, EV_ATACA, ENT_HEROE, hero->id, m->id, m->hp, hero->posActual);
+        m->hp -= hero->attack;
+        if (m->hp <= 0) {
+            registrarEvento(ev, tick, EV_MUERE, ENT_MONSTRUO, m->id, hero->id, m->hp, m->pos);
+            despertar(mt, cfg->hero_count + (int)(m - cfg->monsters));
+        } else registrarEvento(ev, tick, EV_HP_RESTANTE, ENT_MONSTRUO, m->id, hero->id, m->hp, m->pos);
+    }
+    medirFase(mt, FASE_COMBATE, &t);
+
+    // movimiento
+    if (!hero->en_combate && hero->hp > 0) {
+        if (hero->path_step < hero->path_len) {
+            hero->posActual = avanzarRuta(cfg, hero);
+            registrarEvento(ev, tick, EV_MUEVE, ENT_HEROE, hero->id, -1, hero->hp, hero->posActual);
+            heroeEntra(mt, hero->posActual);
+        } else {
+            hero->path_finished = 1;
+            hero->escapado = 1;
+            mt->heroes_activos--;
+            registrarEvento(ev, tick, EV_ESCAPA, ENT_HEROE, hero->id, -1, hero->hp, hero->posActual);
+            actualizarEstadoJuego(mt, ev, tick);
+        }
+        medirFase(mt, FASE_MOVIMIENTO, &t);
+    }
+    return 1;
+}
+
+static void finHeroe(Motor* mt, int idx, uint32_t tick) {
+    Hero* hero = &mt->cfg->heroes[idx];
+    BufferEventos* ev = bufferEventos(mt->eventos, idx);
+    if (hero->hp <= 0) {
+        registrarEvento(ev, tick, EV_TERMINA, ENT_HEROE, hero->id, -1, hero->hp, hero->posActual);
+        actualizarEstadoJuego(mt, ev, tick);
+    }
+}
+
+static void inicioMonstruo(Motor* mt, int idx, uint32_t tick) {
+    Monster* m = &mt->cfg->monsters[idx];
+    registrarEvento(bufferEventos(mt->eventos, mt->cfg->hero_count + idx), tick, EV_INICIO,
+                    ENT_MONSTRUO, m->id, m->vision, m->hp, m->pos);
+}
+
+// una iteracion del monstruo: vision, alerta y ataque o avance. 0 si termino
+static int pasoMonstruo(Motor* mt, int idx, uint32_t tick) {
+    GameConfig* cfg = mt->cfg;
+    Monster* m = &cfg->monsters[idx];
+    BufferEventos* ev = bufferEventos(mt->eventos, cfg->hero_count + idx);
+
+    if (!cfg->juegoActivo || m->hp <= 0) return 0;
+    uint64_t t0 = medirDesde(mt);
+    if (mt->heroes_activos == 0) {
+        terminarJuego(mt);
+        return 0;
+    }
+
+    // vision
+    if (!m->alertado) {
+        int heroe_visto_id = -1, dist_min = 1e9;
+        for (int i = 0; i < cfg->hero_count; i++) {
+            Hero* h = &cfg->heroes[i];
+            if (h->hp <= 0 || h->escapado) continue;
+            int d = distanciaManhattan(h->posActual, m->pos);
+            if (d <= m->vision && d < dist_min) {
+                dist_min = d;
+                heroe_visto_id = i;
+            }
+        }
+        if (heroe_visto_id != -1) {
+            m->alertado = 1;
+            m->target_hero_id = heroe_visto_id;
+            registrarEvento(ev, tick, EV_VE, ENT_MONSTRUO, m->id, heroe_visto_id + 1, dist_min, m->pos);
+        }
+        medirFase(mt, FASE_VISION, &t0);
+        if (heroe_visto_id != -1) {
+            alertarMonstruos(mt, ev, tick, idx, heroe_visto_id);
+            medirFase(mt, FASE_ALERTA, &t0);
+        }
+    }
+
+    // ataque o movimiento
+    if (m->alertado) {
+        if (m->target_hero_id == -1 ||
+            cfg->heroes[m->target_hero_id].hp <= 0 ||
+            cfg->heroes[m->target_hero_id].escapado) {
+            int nuevo = -1, dmin = 1e9;
+            for (int i = 0; i < cfg->hero_count; ++i) {
+                Hero* h = &cfg->heroes[i];
+                if (h->hp <= 0 || h->escapado) continue;
+                int d = distanciaManhattan(h->posActual, m->pos);
+                if (d < dmin) { dmin = d; nuevo = i; }
+            }
+            if (nuevo == -1) { m->alertado = 0; m->target_hero_id = -1; }
+            else { m->target_hero_id = nuevo; }
+            medirFase(mt, FASE_MOVIMIENTO, &t0);
+        } else {
+            Hero* t = &cfg->heroes[m->target_hero_id];
+            int d = distanciaManhattan(t->posActual, m->pos);
+            if (d <= m->range) {
+                registrarEvento(ev, tick, EV_ATACA, ENT_MONSTRUO, m->id, t->id, t->hp, m->pos);
+                t->hp -= m->attack;
+                if (t->hp <= 0) {
+                    mt->heroes_activos--;
+                    registrarEvento(ev, tick, EV_MUERE, ENT_HEROE, t->id, m->id, t->hp, t->posActual);
+                    actualizarEstadoJuego(mt, ev, tick);
+                } else {
+                    registrarEvento(ev, tick, EV_HP_RESTANTE, ENT_HEROE, t->id, m->id, t->hp, t->posActual);
+                }
+                medirFase(mt, FASE_COMBATE, &t0);
+            } else {
+                // campo hacia la celda del heroe, de la cache por celda de origen;
+                // si ninguno parte de ahi se rearma el usado hace mas tiempo
+                Point paso = pasoFlujo(&mt->flujos, t->posActual, m->pos);
+                if (paso.x != m->pos.x || paso.y != m->pos.y) {
+                    m->pos = paso;
+                    registrarEvento(ev, tick, EV_MUEVE, ENT_MONSTRUO, m->id, t->id, m->hp, m->pos);
+                }
+                medirFase(mt, FASE_MOVIMIENTO, &t0);
+            }
+        }
+    }
+    return 1;
+}
+
+static void finMonstruo(Motor* mt, int idx, uint32_t tick) {
+    Monster* m = &mt->cfg->monsters[idx];
+    registrarEvento(bufferEventos(mt->eventos, mt->cfg->hero_count + idx), tick, EV_TERMINA,
+                    ENT_MONSTRUO, m->id, -1, m->hp, m->pos);
+}
+
+int iniciarMotor(Motor *mt, GameConfig *cfg, RegistroEventos *eventos) {
+    memset(mt, 0, sizeof(*mt));
+    mt->cfg = cfg;
+    mt->eventos = eventos;
+    mt->nentidades = cfg->hero_count + cfg->monster_count;
+    mt->huella_origen = huellaEstado(cfg);
+    mt->heroes_activos = heroesActivosCount(cfg);
+
+    size_t n = (size_t)(mt->nentidades > 0 ? mt->nentidades : 1);
+    mt->ticks = calloc(n, sizeof(uint32_t));
+    mt->estado = calloc(n, sizeof(uint8_t));
+    if (!mt->ticks || !mt->estado || iniciarFlujos(&mt->flujos, cfg) != 0 ||
+        iniciarAgenda(&mt->agenda, cfg, mt->nentidades) != 0) {
+        printf("Sin memoria para el motor de simulacion.\n");
+        liberarFlujos(&mt->flujos);
+        free(mt->ticks);
+        free(mt->estado);
+        mt->ticks = NULL;
+        mt->estado = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+void liberarMotor(Motor *mt) {
+    liberarFlujos(&mt->flujos);
+    liberarAgenda(&mt->agenda);
+    free(mt->ticks);
+    free(mt->estado);
+    mt->ticks = NULL;
+    mt->estado = NULL;
+}
+
+// Llamar con cfg->mutex tomado (o desde un solo hilo)
+int ejecutarOp(Motor *mt, int entidad, TipoOp op) {
+    if (mt->traza) grabarOp(mt->traza, entidad, op);
+    mt->ops++;
+
+    int heroe = entidad < mt->cfg->hero_count;
+    int idx = heroe ? entidad : entidad - mt->cfg->hero_count;
+    int seguir = 1;
+
+    switch (op) {
+    case OP_INICIO:
+        if (heroe) inicioHeroe(mt, idx, mt->ticks[entidad]);
+        else inicioMonstruo(mt, idx, mt->ticks[entidad]);
+        ponerEstado(mt, entidad, ENTIDAD_ACTIVA);
+        break;
+    case OP_PASO:
+        // el tick cuenta tambien las rondas que se salteo dormido; los heroes
+        // actuan antes y siguen activos mientras haya dormidos, asi que
+        // tick_global ya es el de esta ronda
+        if (mt->agenda.dormido_en[entidad] != SIN_DORMIR) {
+            uint32_t desde = mt->agenda.dormido_en[entidad];
+            if (mt->tick_global > desde + 1) mt->ticks[entidad] += mt->tick_global - desde - 1;
+            mt->agenda.dormido_en[entidad] = SIN_DORMIR;
+        }
+        mt->ticks[entidad]++;
+        seguir = heroe ? pasoHeroe(mt, idx, mt->ticks[entidad])
+                       : pasoMonstruo(mt, idx, mt->ticks[entidad]);
+        if (!heroe && seguir && !mt->cfg->monsters[idx].alertado) dormir(mt, idx);
+        break;
+    case OP_FIN:
+        if (heroe) finHeroe(mt, idx, mt->ticks[entidad]);
+        else finMonstruo(mt, idx, mt->ticks[entidad]);
+        ponerEstado(mt, entidad, ENTIDAD_TERMINADA);
+        break;
+    }
+
+    if (mt->ticks[entidad] > mt->tick_global) mt->tick_global = mt->ticks[entidad];
+    return seguir;
+}
+
+// Guarda un checkpoint si tick_global paso un multiplo de checkpoint_cada.
+// Solo se llama en puntos seguros (fin de ronda, o despues de una op completa).
+void revisarCheckpoint(Motor *mt) {
+    if (!mt->checkpoint_cada) return;
+    if (mt->tick_global / mt->checkpoint_cada <= mt->ultimo_checkpoint / mt->checkpoint_cada) return;
+
+    char ruta[512];
+    snprintf(ruta, sizeof(ruta), "%s_%06u.ckpt",
+             mt->checkpoint_prefijo ? mt->checkpoint_prefijo : "checkpoint", mt->tick_global);
+    guardarCheckpoint(ruta, mt);
+    mt->ultimo_checkpoint = mt->tick_global;
+}
+
+// Despues de copiar estado/dormido_en desde un checkpoint: rearma los bits de
+// la ronda y vuelve a anotar a los monstruos dormidos
+void restaurarAgenda(Motor *mt) {
+    Agenda* a = &mt->agenda;
+    int hc = mt->cfg->hero_count;
+    for (int e = 0; e < mt->nentidades; e++) {
+        marcarListo(a, e, mt->estado[e] == ENTIDAD_ACTIVA);
+        if (mt->estado[e] != ENTIDAD_DORMIDA) continue;
+        if (e < hc || suscribir(a, &mt->cfg->monsters[e - hc], e - hc) != 0) {
+            ponerEstado(mt, e, ENTIDAD_ACTIVA);
+            a->dormido_en[e] = SIN_DORMIR;
+        }
+    }
+}
+
+// FNV-1a sobre el estado de heroes, rutas, monstruos y terreno
+static uint64_t fnv(uint64_t h, const void *datos, size_t n) {
+    const unsigned char *p = (const unsigned char *)datos;
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+uint64_t huellaEstado(const GameConfig *cfg) {
+    uint64_t h = 1469598103934665603ull;
+    h = fnv(h, &cfg->width, sizeof(cfg->width));
+    h = fnv(h, &cfg->height, sizeof(cfg->height));
+    h = fnv(h, cfg->heroes, (size_t)cfg->hero_count * sizeof(Hero));
+    if (cfg->ruta_count > 0) h = fnv(h, cfg->rutas, (size_t)cfg->ruta_count * sizeof(Ruta));
+    if (cfg->seg_count > 0) h = fnv(h, cfg->segmentos, (size_t)cfg->seg_count * sizeof(Segmento));
+    if (cfg->monster_count > 0) h = fnv(h, cfg->monsters, (size_t)cfg->monster_count * sizeof(Monster));
+    if (cfg->terreno) h = fnv(h, cfg->terreno, (size_t)cfg->width * (size_t)cfg->height);
+    return h;
+}
@@ -0,0 +1,58 @@
+#ifndef MOTOR_H
+#define MOTOR_H
+
+#include <stdint.h>
+#include "agenda.h"
+#include "config.h"
+#include "eventos.h"
+#include "flujo.h"
+#include "perfil.h"
+
+// Cada iteracion de un heroe/monstruo es una operacion atomica (se ejecuta
+// entera con cfg->mutex tomado). Repetir las mismas operaciones en el mismo
+// orden desde el mismo estado da exactamente la misma simulacion.
+typedef enum {
+    OP_INICIO,
+    OP_PASO,
+    OP_FIN
+} TipoOp;
+
+typedef enum {
+    ENTIDAD_PENDIENTE,
+    ENTIDAD_ACTIVA,
+    ENTIDAD_TERMINADA,
+    ENTIDAD_DORMIDA     // monstruo sin alertar: no actua hasta que un heroe entre a su vision
+} EstadoEntidad;
+
+struct Traza;
+
+typedef struct {
+    GameConfig *cfg;
+    Flujos flujos;
+    RegistroEventos *eventos;
+
+    int nentidades;          // heroes (0..hero_count-1) y luego monstruos
+    int heroes_activos;      // vivos y sin escapar, se mantiene al morir/escapar
+    uint32_t *ticks;         // iteraciones hechas por cada entidad
+    uint8_t *estado;         // EstadoEntidad
+    uint64_t ops;            // operaciones ejecutadas desde el tick 0
+    uint32_t tick_global;    // tick mas alto alcanzado
+    uint64_t huella_origen;  // huella del escenario con que partio la corrida
+    Agenda agenda;           // quien actua en la ronda y quien espera a un heroe
+
+    struct Traza *traza;     // NULL si no se graba
+    Perfil *perfil;          // NULL si no se mide
+    uint32_t checkpoint_cada;
+    uint32_t ultimo_checkpoint;
+    const char *checkpoint_prefijo;
+} Motor;
+
+int iniciarMotor(Motor *mt, GameConfig *cfg, RegistroEventos *eventos);
+void liberarMotor(Motor *mt);
+
+int ejecutarOp(Motor *mt, int entidad, TipoOp op);
+void revisarCheckpoint(Motor *mt);
+void restaurarAgenda(Motor *mt);
+uint64_t huellaEstado(const GameConfig *cfg);
+
+#endif
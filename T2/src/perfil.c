@@ -0,0 +1,88 @@
+#define _DEFAULT_SOURCE
+#include "perfil.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *nombreFase[FASE_TOTAL] = {
+    "vision", "alerta", "combate", "movimiento", "log", "espera lock", "pausa"
+};
+
+uint64_t perfilAhora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int iniciarPerfil(Perfil *p, int nhilos) {
+    memset(p, 0, sizeof(*p));
+    p->nhilos = nhilos > 0 ? nhilos : 1;
+    p->hilos = aligned_alloc(64, (size_t)p->nhilos * sizeof(PerfilHilo));
+    if (!p->hilos) {
+        printf("Sin memoria para el perfil.\n");
+        return 1;
+    }
+    memset(p->hilos, 0, (size_t)p->nhilos * sizeof(PerfilHilo));
+    p->inicio_ns = perfilAhora();
+    return 0;
+}
+
+void liberarPerfil(Perfil *p) {
+    free(p->hilos);
+    p->hilos = NULL;
+}
+
+PerfilHilo *perfilHilo(Perfil *p, int i) {
+    return &p->hilos[i % p->nhilos];
+}
+
+void tomarMutex(Perfil *p, int hilo, pthread_mutex_t *m) {
+    if (!p) {
+        pthread_mutex_lock(m);
+        return;
+    }
+    PerfilHilo *h = perfilHilo(p, hilo);
+    h->locks++;
+    if (pthread_mutex_trylock(m) == 0) return;
+
+    h->contendidos++;
+    uint64_t t = perfilAhora();
+    pthread_mutex_lock(m);
+    perfilFase(h, FASE_ESPERA_LOCK, &t);
+}
+
+void sumarPerfil(const Perfil *p, PerfilHilo *total) {
+    *total = p->juego;
+    for (int i = 0; i < p->nhilos; ++i) {
+        for (int f = 0; f < FASE_TOTAL; ++f) {
+            total->ns[f] += p->hilos[i].ns[f];
+            total->veces[f] += p->hilos[i].veces[f];
+        }
+        total->locks += p->hilos[i].locks;
+        total->contendidos += p->hilos[i].contendidos;
+    }
+}
+
+void imprimirPerfil(const Perfil *p, uint64_t ops, FILE *f) {
+    PerfilHilo t;
+    sumarPerfil(p, &t);
+    double seg = (p->fin_ns - p->inicio_ns) / 1e9;
+    if (seg <= 0) seg = 1e-9;
+
+    uint64_t medido = 0;
+    for (int i = 0; i < FASE_TOTAL; ++i) medido += t.ns[i];
+
+    fprintf(f, "=== Perfil ===\n");
+    fprintf(f, "Rondas: %llu  Ops: %llu  Tiempo: %.3f s  (%.1f rondas/s, %.0f ops/s)\n",
+            (unsigned long long)p->rondas, (unsigned long long)ops, seg,
+            p->rondas / seg, ops / seg);
+    fprintf(f, "%-12s %12s %7s %12s %10s\n", "fase", "total ms", "%", "veces", "ns/vez");
+    for (int i = 0; i < FASE_TOTAL; ++i) {
+        fprintf(f, "%-12s %12.3f %6.1f%% %12llu %10.0f\n", nombreFase[i], t.ns[i] / 1e6,
+                medido ? 100.0 * t.ns[i] / medido : 0.0, (unsigned long long)t.veces[i],
+                t.veces[i] ? (double)t.ns[i] / t.veces[i] : 0.0);
+    }
+    fprintf(f, "cfg->mutex: %llu tomas, %llu con contencion (%.2f%%)\n",
+            (unsigned long long)t.locks, (unsigned long long)t.contendidos,
+            t.locks ? 100.0 * t.contendidos / t.locks : 0.0);
+}
@@ -0,0 +1,57 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Fases en que se reparte el tiempo de una iteracion
+typedef enum {
+    FASE_VISION,       // monstruo buscando heroes a la vista
+    FASE_ALERTA,       // alertarMonstruos()
+    FASE_COMBATE,      // heroe buscando a quien pegar, golpes
+    FASE_MOVIMIENTO,   // paso por el path / campo de flujo
+    FASE_LOG,          // entregar eventos al escritor
+    FASE_ESPERA_LOCK,  // bloqueado esperando cfg->mutex
+    FASE_PAUSA,        // sleep(1) del modo con un hilo por entidad
+    FASE_TOTAL
+} Fase;
+
+// Contadores de un hilo; alineados para no compartir linea de cache
+typedef struct {
+    uint64_t ns[FASE_TOTAL];
+    uint64_t veces[FASE_TOTAL];
+    uint64_t locks;
+    uint64_t contendidos;    // el trylock fallo y hubo que esperar
+} __attribute__((aligned(64))) PerfilHilo;
+
+typedef struct {
+    PerfilHilo juego;        // fases medidas dentro de cfg->mutex
+    PerfilHilo *hilos;       // lock, log y pausa: uno por hilo (o entidad)
+    int nhilos;
+    uint64_t rondas;         // ticks completos de la simulacion
+    uint64_t inicio_ns;
+    uint64_t fin_ns;
+} Perfil;
+
+uint64_t perfilAhora(void);   // ns de CLOCK_MONOTONIC
+
+// Suma lo que paso desde *t a la fase y deja *t en el instante actual
+static inline void perfilFase(PerfilHilo *h, Fase f, uint64_t *t) {
+    uint64_t ahora = perfilAhora();
+    h->ns[f] += ahora - *t;
+    h->veces[f]++;
+    *t = ahora;
+}
+
+int iniciarPerfil(Perfil *p, int nhilos);
+void liberarPerfil(Perfil *p);
+PerfilHilo *perfilHilo(Perfil *p, int i);
+
+// pthread_mutex_lock que cuenta contencion y tiempo de espera (p puede ser NULL)
+void tomarMutex(Perfil *p, int hilo, pthread_mutex_t *m);
+
+void sumarPerfil(const Perfil *p, PerfilHilo *total);
+void imprimirPerfil(const Perfil *p, uint64_t ops, FILE *f);
+
+#endif
@@ -0,0 +1,115 @@
+#include "ruta.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int crecer(void **arr, int *cap, int n, size_t tam) {
+    if (n <= *cap) return 0;
+    int nueva = *cap ? *cap * 2 : 16;
+    if (nueva < n) nueva = n;
+    void *p = realloc(*arr, (size_t)nueva * tam);
+    if (!p) return 1;
+    *arr = p;
+    *cap = nueva;
+    return 0;
+}
+
+int reservarRutas(GameConfig *cfg, int nrutas, int nsegs) {
+    if (crecer((void **)&cfg->rutas, &cfg->ruta_cap, cfg->ruta_count + nrutas, sizeof(Ruta)) != 0 ||
+        crecer((void **)&cfg->segmentos, &cfg->seg_cap, cfg->seg_count + nsegs, sizeof(Segmento)) != 0) {
+        printf("Sin memoria para los paths\n");
+        return 1;
+    }
+    return 0;
+}
+
+int rutaValida(const Ruta *r, const Segmento *segs, int nsegs) {
+    if (r->nsegs < 0 || r->seg_ini < 0 || r->seg_ini > nsegs - r->nsegs) return 0;
+    if (r->largo < 0 || r->largo > MAX_PATH) return 0;
+    int suma = 0;
+    for (int i = 0; i < r->nsegs; ++i) {
+        int largo = segs[r->seg_ini + i].largo;
+        if (largo <= 0 || largo > r->largo - suma) return 0;
+        suma += largo;
+    }
+    return suma == r->largo;
+}
+
+static int cabeEnPaso(int d) {
+    return d >= INT16_MIN && d <= INT16_MAX;
+}
+
+// Un punto extiende el tramo si sigue el mismo paso; si no, abre uno nuevo
+int agregarRuta(GameConfig *cfg, const Point *pts, int n) {
+    if (reservarRutas(cfg, 1, n) != 0) return -1;
+
+    Ruta *r = &cfg->rutas[cfg->ruta_count];
+    r->seg_ini = cfg->seg_count;
+    r->nsegs = 0;
+    r->largo = n;
+
+    Segmento *s = NULL;
+    for (int i = 0; i < n; ++i) {
+        if (s) {
+            int dx = pts[i].x - s->inicio.x, dy = pts[i].y - s->inicio.y;
+            if (s->largo == 1 && cabeEnPaso(dx) && cabeEnPaso(dy)) {
+                s->dx = (int16_t)dx;
+                s->dy = (int16_t)dy;
+                s->largo = 2;
+                continue;
+            }
+            if (s->largo > 1 && dx == s->dx * s->largo && dy == s->dy * s->largo) {
+                s->largo++;
+                continue;
+            }
+        }
+        s = &cfg->segmentos[cfg->seg_count++];
+        s->inicio = pts[i];
+        s->dx = s->dy = 0;
+        s->largo = 1;
+        r->nsegs++;
+    }
+    return cfg->ruta_count++;
+}
+
+int reemplazarRuta(GameConfig *cfg, int ruta, const Point *pts, int n) {
+    if (ruta < 0) return agregarRuta(cfg, pts, n);
+
+    Ruta *vieja = &cfg->rutas[ruta];
+    if (ruta == cfg->ruta_count - 1 && vieja->seg_ini + vieja->nsegs == cfg->seg_count) {
+        cfg->seg_count = vieja->seg_ini;
+        cfg->ruta_count--;
+        return agregarRuta(cfg, pts, n);
+    }
+
+    // se codifica al final y, si no ocupa mas tramos que la vieja, se copia encima
+    int nueva = agregarRuta(cfg, pts, n);
+    if (nueva < 0) return -1;
+    vieja = &cfg->rutas[ruta];
+    const Ruta *r = &cfg->rutas[nueva];
+    if (r->nsegs > vieja->nsegs) return nueva;
+
+    memcpy(&cfg->segmentos[vieja->seg_ini], &cfg->segmentos[r->seg_ini], (size_t)r->nsegs * sizeof(Segmento));
+    vieja->nsegs = r->nsegs;
+    vieja->largo = r->largo;
+    cfg->seg_count = r->seg_ini;
+    cfg->ruta_count--;
+    return ruta;
+}
+
+void reiniciarRuta(Hero *h) {
+    h->path_step = 0;
+    h->seg = 0;
+    h->seg_paso = 0;
+}
+
+Point avanzarRuta(const GameConfig *cfg, Hero *h) {
+    const Segmento *s = &cfg->segmentos[cfg->rutas[h->ruta].seg_ini + h->seg];
+    Point p = { s->inicio.x + s->dx * h->seg_paso, s->inicio.y + s->dy * h->seg_paso };
+    if (++h->seg_paso == s->largo) {
+        h->seg++;
+        h->seg_paso = 0;
+    }
+    h->path_step++;
+    return p;
+}
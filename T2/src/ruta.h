@@ -0,0 +1,28 @@
+#ifndef RUTA_H
+#define RUTA_H
+
+#include "config.h"
+
+// Paths comprimidos en tramos rectos (ver Segmento/Ruta en config.h). Un
+// grupo de heroes comparte una sola ruta y cada heroe solo guarda su cursor.
+
+// Codifica n puntos como una ruta nueva; devuelve su indice o -1 sin memoria
+int agregarRuta(GameConfig *cfg, const Point *pts, int n);
+
+// Igual, pero para quien ya tenia la ruta 'ruta' (-1 = ninguna) y es su unico
+// dueño: se reusa su lugar si entra, o se descarta si era la ultima agregada
+int reemplazarRuta(GameConfig *cfg, int ruta, const Point *pts, int n);
+
+// 1 si la ruta leida de un archivo se puede recorrer: sus tramos estan entre
+// los nsegs de segs, ninguno esta vacio y suman su largo (a lo sumo MAX_PATH)
+int rutaValida(const Ruta *r, const Segmento *segs, int nsegs);
+
+// Deja espacio para nrutas rutas y nsegs tramos mas
+int reservarRutas(GameConfig *cfg, int nrutas, int nsegs);
+
+void reiniciarRuta(Hero *h);
+
+// Siguiente punto del path del heroe; llamar solo con path_step < path_len
+Point avanzarRuta(const GameConfig *cfg, Hero *h);
+
+#endif
@@ -0,0 +1,241 @@
+#define _DEFAULT_SOURCE
+#include "traza.h"
+#include "ruta.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+int abrirTraza(Traza *t, const char *ruta, const Motor *mt) {
+    t->f = fopen(ruta, "wb");
+    t->n = 0;
+    t->total = 0;
+    t->error = 0;
+    if (!t->f) {
+        printf("No se pudo crear la traza: %s\n", ruta);
+        return 1;
+    }
+
+    TrazaHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magia, TRAZA_MAGIA, 4);
+    h.version = TRAZA_VERSION;
+    h.hero_count = mt->cfg->hero_count;
+    h.monster_count = mt->cfg->monster_count;
+    h.huella = mt->huella_origen;
+    h.ops_base = mt->ops;
+    if (fwrite(&h, sizeof(h), 1, t->f) != 1) {
+        printf("Error escribiendo la traza: %s\n", ruta);
+        fclose(t->f);
+        t->f = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+// Tras un error no se sigue escribiendo: la traza ya no se puede reproducir
+static void vaciarTraza(Traza *t) {
+    if (t->n > 0 && t->f && !t->error)
+        t->error = fwrite(t->buf, sizeof(uint32_t), (size_t)t->n, t->f) != (size_t)t->n;
+    t->n = 0;
+}
+
+// 4 bytes por operacion; se escribe al archivo cada TRAZA_BUFFER ops
+void grabarOp(Traza *t, int entidad, TipoOp op) {
+    t->buf[t->n++] = ((uint32_t)entidad << 2) | (uint32_t)op;
+    t->total++;
+    if (t->n == TRAZA_BUFFER) vaciarTraza(t);
+}
+
+int cerrarTraza(Traza *t) {
+    if (!t->f) return 1;
+    vaciarTraza(t);
+    int r = (fclose(t->f) != 0) || t->error;
+    t->f = NULL;
+    return r;
+}
+
+int leerTraza(const char *ruta, TrazaLeida *t) {
+    memset(t, 0, sizeof(*t));
+    int fd = open(ruta, O_RDONLY);
+    if (fd < 0) {
+        printf("No se pudo abrir la traza: %s\n", ruta);
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TrazaHeader)) {
+        printf("Traza invalida: %s\n", ruta);
+        close(fd);
+        return 1;
+    }
+
+    size_t len = (size_t)st.st_size;
+    void *mapa = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        printf("No se pudo mapear la traza: %s\n", ruta);
+        return 1;
+    }
+
+    memcpy(&t->h, mapa, sizeof(TrazaHeader));
+    if (memcmp(t->h.magia, TRAZA_MAGIA, 4) != 0 || t->h.version != TRAZA_VERSION) {
+        printf("Traza invalida: %s\n", ruta);
+        munmap(mapa, len);
+        return 1;
+    }
+    madvise(mapa, len, MADV_SEQUENTIAL);
+
+    t->mapa = mapa;
+    t->mapa_len = len;
+    t->ops = (const uint32_t *)((const char *)mapa + sizeof(TrazaHeader));
+    t->nops = (len - sizeof(TrazaHeader)) / sizeof(uint32_t);
+    return 0;
+}
+
+void liberarTraza(TrazaLeida *t) {
+    if (t->mapa) munmap(t->mapa, t->mapa_len);
+    t->mapa = NULL;
+}
+
+int guardarCheckpoint(const char *ruta, const Motor *mt) {
+    const GameConfig *cfg = mt->cfg;
+    CheckpointHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magia, CHECKPOINT_MAGIA, 4);
+    h.version = CHECKPOINT_VERSION;
+    h.width = cfg->width;
+    h.height = cfg->height;
+    h.hero_count = cfg->hero_count;
+    h.monster_count = cfg->monster_count;
+    h.juegoActivo = cfg->juegoActivo;
+    h.tiene_terreno = cfg->terreno != NULL;
+    h.tick_global = mt->tick_global;
+    h.ops = mt->ops;
+    h.seq_eventos = atomic_load(&mt->eventos->seq);
+    h.huella_origen = mt->huella_origen;
+    h.ruta_count = cfg->ruta_count;
+    h.seg_count = cfg->seg_count;
+
+    FILE *f = fopen(ruta, "wb");
+    if (!f) {
+        printf("No se pudo crear el checkpoint: %s\n", ruta);
+        return 1;
+    }
+
+    size_t n = (size_t)mt->nentidades;
+    size_t nm = (size_t)cfg->monster_count;
+    int err = fwrite(&h, sizeof(h), 1, f) != 1;
+    err = err || fwrite(cfg->heroes, sizeof(Hero), (size_t)cfg->hero_count, f) != (size_t)cfg->hero_count;
+    if (h.ruta_count > 0)
+        err = err || fwrite(cfg->rutas, sizeof(Ruta), (size_t)h.ruta_count, f) != (size_t)h.ruta_count;
+    if (h.seg_count > 0)
+        err = err || fwrite(cfg->segmentos, sizeof(Segmento), (size_t)h.seg_count, f) != (size_t)h.seg_count;
+    if (nm > 0) err = err || fwrite(cfg->monsters, sizeof(Monster), nm, f) != nm;
+    err = err || fwrite(mt->ticks, sizeof(uint32_t), n, f) != n;
+    err = err || fwrite(mt->estado, sizeof(uint8_t), n, f) != n;
+    err = err || fwrite(mt->agenda.dormido_en, sizeof(uint32_t), n, f) != n;
+    if (cfg->terreno) {
+        size_t celdas = (size_t)cfg->width * (size_t)cfg->height;
+        err = err || fwrite(cfg->terreno, 1, celdas, f) != celdas;
+    }
+
+    if (fclose(f) != 0) err = 1;
+    if (err) printf("Error escribiendo el checkpoint: %s\n", ruta);
+    return err;
+}
+
+// Arma una GameConfig completa (monstruos y terreno en memoria propia)
+// El cursor del heroe tiene que caer dentro de su ruta y apuntar al mismo
+// punto que path_step; si no, avanzarRuta leeria fuera de los tramos
+static int cursorValido(const GameConfig *cfg, const Hero *h) {
+    if (h->path_step < 0 || h->seg < 0 || h->seg_paso < 0) return 0;
+    if (h->ruta < 0) return h->path_len == 0 && h->path_step == 0 && h->seg == 0 && h->seg_paso == 0;
+
+    const Ruta *r = &cfg->rutas[h->ruta];
+    if (h->path_len != r->largo || h->path_step > h->path_len || h->seg > r->nsegs) return 0;
+    int antes = 0;
+    for (int s = 0; s < h->seg; ++s) antes += cfg->segmentos[r->seg_ini + s].largo;
+    int largo = h->seg < r->nsegs ? cfg->segmentos[r->seg_ini + h->seg].largo : 1;
+    return h->seg_paso < largo && antes + h->seg_paso == h->path_step;
+}
+
+int leerCheckpoint(const char *ruta, GameConfig *cfg, CheckpointHeader *h,
+                   uint32_t **ticks, uint8_t **estado, uint32_t **dormido) {
+    FILE *f = fopen(ruta, "rb");
+    if (!f) {
+        printf("No se pudo abrir el checkpoint: %s\n", ruta);
+        return 1;
+    }
+
+    memset(cfg, 0, sizeof(*cfg));
+    *ticks = NULL;
+    *estado = NULL;
+    *dormido = NULL;
+
+    int err = fread(h, sizeof(*h), 1, f) != 1;
+    err = err || memcmp(h->magia, CHECKPOINT_MAGIA, 4) != 0 || h->version != CHECKPOINT_VERSION;
+    err = err || h->hero_count < 1 || h->hero_count > MAX_HEROES;
+    err = err || h->monster_count < 0 || h->monster_count > MAX_MONSTERS;
+    err = err || (h->tiene_terreno && (h->width <= 0 || h->height <= 0));
+    err = err || h->ruta_count < 0 || h->seg_count < 0;
+    if (err) {
+        printf("Checkpoint invalido: %s\n", ruta);
+        fclose(f);
+        return 1;
+    }
+
+    size_t n = (size_t)h->hero_count + (size_t)h->monster_count;
+    size_t nm = (size_t)h->monster_count;
+    size_t celdas = h->tiene_terreno ? (size_t)h->width * (size_t)h->height : 0;
+    cfg->monsters = malloc((nm ? nm : 1) * sizeof(Monster));
+    cfg->terreno = celdas ? malloc(celdas) : NULL;
+    *ticks = malloc(n * sizeof(uint32_t));
+    *estado = malloc(n);
+    *dormido = malloc(n * sizeof(uint32_t));
+    err = !cfg->monsters || (celdas && !cfg->terreno) || !*ticks || !*estado || !*dormido;
+    err = err || reservarHeroes(cfg, h->hero_count) || reservarRutas(cfg, h->ruta_count, h->seg_count);
+
+    err = err || fread(cfg->heroes, sizeof(Hero), (size_t)h->hero_count, f) != (size_t)h->hero_count;
+    if (h->ruta_count > 0)
+        err = err || fread(cfg->rutas, sizeof(Ruta), (size_t)h->ruta_count, f) != (size_t)h->ruta_count;
+    if (h->seg_count > 0)
+        err = err || fread(cfg->segmentos, sizeof(Segmento), (size_t)h->seg_count, f) != (size_t)h->seg_count;
+    if (nm > 0) err = err || fread(cfg->monsters, sizeof(Monster), nm, f) != nm;
+    err = err || fread(*ticks, sizeof(uint32_t), n, f) != n;
+    err = err || fread(*estado, 1, n, f) != n;
+    err = err || fread(*dormido, sizeof(uint32_t), n, f) != n;
+    if (celdas) err = err || fread(cfg->terreno, 1, celdas, f) != celdas;
+    fclose(f);
+
+    // las rutas vienen del archivo: se validan antes de que un heroe las recorra
+    for (int r = 0; !err && r < h->ruta_count; ++r)
+        err = !rutaValida(&cfg->rutas[r], cfg->segmentos, h->seg_count);
+    for (int i = 0; !err && i < h->hero_count; ++i) {
+        const Hero *hero = &cfg->heroes[i];
+        err = hero->ruta < -1 || hero->ruta >= h->ruta_count || !cursorValido(cfg, hero);
+    }
+
+    if (err) {
+        printf("Checkpoint incompleto: %s\n", ruta);
+        free(*ticks);
+        free(*estado);
+        free(*dormido);
+        *ticks = NULL;
+        *estado = NULL;
+        *dormido = NULL;
+        liberarConfig(cfg);
+        return 1;
+    }
+
+    cfg->width = h->width;
+    cfg->height = h->height;
+    cfg->hero_count = h->hero_count;
+    cfg->ruta_count = h->ruta_count;
+    cfg->seg_count = h->seg_count;
+    cfg->monster_count = h->monster_count;
+    cfg->monster_cap = h->monster_count;
+    cfg->juegoActivo = h->juegoActivo;
+    return 0;
+}
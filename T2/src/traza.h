@@ -0,0 +1,78 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "config.h"
+#include "motor.h"
+
+// Traza de operaciones (little endian):
+//   TrazaHeader | uint32_t op[...]   con op = (entidad << 2) | TipoOp
+#define TRAZA_MAGIA "T2TR"
+#define TRAZA_VERSION 1
+#define TRAZA_BUFFER 65536
+
+typedef struct {
+    char magia[4];
+    uint32_t version;
+    int32_t hero_count;
+    int32_t monster_count;
+    uint64_t huella;        // huella del escenario original de la corrida
+    uint64_t ops_base;      // ops ya ejecutadas cuando empezo la grabacion
+} TrazaHeader;
+
+typedef struct Traza {
+    FILE *f;
+    uint32_t buf[TRAZA_BUFFER];
+    int n;
+    uint64_t total;
+    int error;              // fallo alguna escritura; se informa al cerrar
+} Traza;
+
+int abrirTraza(Traza *t, const char *ruta, const Motor *mt);
+void grabarOp(Traza *t, int entidad, TipoOp op);
+// 0 si la traza quedo completa en disco
+int cerrarTraza(Traza *t);
+
+// Traza leida para reproducir (mapeada en memoria)
+typedef struct {
+    TrazaHeader h;
+    const uint32_t *ops;
+    uint64_t nops;
+    void *mapa;
+    size_t mapa_len;
+} TrazaLeida;
+
+int leerTraza(const char *ruta, TrazaLeida *t);
+void liberarTraza(TrazaLeida *t);
+
+// Checkpoint: estado completo para reanudar una corrida
+//   CheckpointHeader | Hero[hero_count] | Ruta[ruta_count] | Segmento[seg_count]
+//   | Monster[monster_count] | uint32_t ticks[n] | uint8_t estado[n]
+//   | uint32_t dormido_en[n] | uint8_t terreno[w*h] (si hay)
+#define CHECKPOINT_MAGIA "T2CK"
+#define CHECKPOINT_VERSION 3
+
+typedef struct {
+    char magia[4];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t hero_count;
+    int32_t monster_count;
+    int32_t juegoActivo;
+    int32_t tiene_terreno;
+    uint32_t tick_global;
+    uint32_t reservado;
+    uint64_t ops;
+    uint64_t seq_eventos;
+    uint64_t huella_origen;
+    int32_t ruta_count;
+    int32_t seg_count;
+} CheckpointHeader;
+
+int guardarCheckpoint(const char *ruta, const Motor *mt);
+int leerCheckpoint(const char *ruta, GameConfig *cfg, CheckpointHeader *h,
+                   uint32_t **ticks, uint8_t **estado, uint32_t **dormido);
+
+#endif
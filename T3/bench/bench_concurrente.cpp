@@ -0,0 +1,59 @@
+// Escalamiento del modo concurrente (concurrente.h): la misma carga con
+// 1, 2, 4, ... hilos sobre CLOCK sin locks y sobre LRU fragmentada.
+// Muestra accesos por segundo, la aceleración contra 1 hilo y la tasa de
+// aciertos, y verifica que la RAM quede consistente después de cada corrida.
+//
+// Compilar desde T3/:  g++ -std=c++17 -O2 -pthread bench/bench_concurrente.cpp -o bench_concurrente
+// Uso: ./bench_concurrente [hilos máximos] [accesos]
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include "../src/concurrente.h"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    int maxHilos = argc > 1 ? atoi(argv[1]) : 8;
+    uint64_t accesos = argc > 2 ? strtoull(argv[2], nullptr, 10) : 8000000;
+    if (maxHilos < 1)
+        maxHilos = 1;
+
+    // 16 procesos de 4096 páginas (16 MB con páginas de 4 KB) sobre 16384 marcos
+    const int procesos = 16, marcos = 16384, fragmentos = 64;
+    const uint32_t paginasPorProceso = 4096;
+    ParametrosCarga carga;
+    carga.tipo = CARGA_ZIPF;
+
+    printf("=== bench_concurrente (%d marcos, %d procesos, zipf, %llu accesos, %u CPUs) ===\n",
+           marcos, procesos, (unsigned long long)accesos, thread::hardware_concurrency());
+    printf("%-18s %6s %14s %12s %10s\n", "reemplazo", "hilos", "accesos/s", "aceleración", "aciertos");
+    for (int tipo = 0; tipo < 2; tipo++)
+    {
+        double base = 0;
+        for (int hilos = 1; hilos <= maxHilos; hilos *= 2)
+        {
+            unique_ptr<RAMConcurrente> ram;
+            if (tipo == 0)
+                ram.reset(new ClockConcurrente(marcos, procesos * paginasPorProceso));
+            else
+                ram.reset(new LRUFragmentada(marcos, procesos * paginasPorProceso, fragmentos));
+            ResultadoConcurrente r = ejecutarConcurrente(*ram, hilos, carga, procesos, paginasPorProceso,
+                                                         accesos, 64, 42);
+            string error;
+            if (!ram->verificar(error))
+            {
+                printf("ERROR: %s con %d hilos: %s\n", ram->nombre(), hilos, error.c_str());
+                return 1;
+            }
+            double porSegundo = r.segundos > 0 ? r.accesos / r.segundos : 0;
+            if (hilos == 1)
+                base = porSegundo;
+            printf("%-18s %6d %14.0f %11.2fx %9.2f%%\n", ram->nombre(), hilos, porSegundo,
+                   base > 0 ? porSegundo / base : 0, 100.0 * (r.accesos - r.faults) / r.accesos);
+        }
+    }
+    return 0;
+}
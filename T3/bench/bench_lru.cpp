@@ -0,0 +1,145 @@
+// Compara la elección de víctima LRU: lista intrusiva (lru.h) contra el
+// recorrido lineal de RAM buscando el menor ultimoAcceso (versión original).
+//
+// Compilar desde T3/:  g++ -std=c++17 -O2 bench/bench_lru.cpp -o bench_lru
+// Uso: ./bench_lru [accesos_por_fault] [ms_por_medicion]
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../src/lru.h"
+
+using namespace std;
+using reloj = chrono::steady_clock;
+
+// Cada fault: elegir víctima, sacarla y cargar la nueva página como la más
+// reciente; entre faults hay 'hits' accesos a marcos al azar.
+static double faultsLista(int marcos, int hits, double msMax, int *victimaFinal)
+{
+    ListaLRU lru(marcos);
+    for (int m = 0; m < marcos; m++)
+        lru.insertarFrio(m);
+
+    mt19937 gen(7);
+    uniform_int_distribution<int> dist(0, marcos - 1);
+    long long faults = 0;
+    auto inicio = reloj::now();
+    double ms = 0;
+    int v = -1;
+    do
+    {
+        for (int k = 0; k < 1024; k++)
+        {
+            for (int h = 0; h < hits; h++)
+                lru.tocar(dist(gen));
+            v = lru.victima();
+            lru.quitar(v);
+            lru.tocar(v);
+            faults++;
+        }
+        ms = chrono::duration<double, milli>(reloj::now() - inicio).count();
+    } while (ms < msMax);
+    *victimaFinal = v;
+    return faults / (ms / 1e3);
+}
+
+static double faultsLineal(int marcos, int hits, double msMax, int *victimaFinal)
+{
+    vector<unsigned long long> ultimoAcceso(marcos, 0);
+    unsigned long long contadorReloj = 0;
+
+    mt19937 gen(7);
+    uniform_int_distribution<int> dist(0, marcos - 1);
+    long long faults = 0;
+    auto inicio = reloj::now();
+    double ms = 0;
+    int v = -1;
+    do
+    {
+        for (int h = 0; h < hits; h++)
+            ultimoAcceso[dist(gen)] = ++contadorReloj;
+
+        v = -1;
+        unsigned long long masAntiguo = ULLONG_MAX;
+        for (int i = 0; i < marcos; i++)
+        {
+            if (ultimoAcceso[i] < masAntiguo)
+            {
+                masAntiguo = ultimoAcceso[i];
+                v = i;
+            }
+        }
+        ultimoAcceso[v] = ++contadorReloj;
+        faults++;
+        ms = chrono::duration<double, milli>(reloj::now() - inicio).count();
+    } while (ms < msMax);
+    *victimaFinal = v;
+    return faults / (ms / 1e3);
+}
+
+// Con la misma secuencia de accesos las dos tienen que elegir las mismas víctimas
+static bool mismasVictimas(int marcos, int hits, int faults)
+{
+    ListaLRU lru(marcos);
+    vector<unsigned long long> ultimoAcceso(marcos, 0);
+    unsigned long long contadorReloj = 0;
+    for (int m = 0; m < marcos; m++)
+        lru.insertarFrio(m);
+
+    mt19937 gen(11);
+    uniform_int_distribution<int> dist(0, marcos - 1);
+    for (int f = 0; f < faults; f++)
+    {
+        for (int h = 0; h < hits; h++)
+        {
+            int m = dist(gen);
+            lru.tocar(m);
+            ultimoAcceso[m] = ++contadorReloj;
+        }
+        int esperado = -1;
+        unsigned long long masAntiguo = ULLONG_MAX;
+        for (int i = 0; i < marcos; i++)
+            if (ultimoAcceso[i] < masAntiguo)
+            {
+                masAntiguo = ultimoAcceso[i];
+                esperado = i;
+            }
+        int v = lru.victima();
+        if (v != esperado)
+            return false;
+        lru.quitar(v);
+        lru.tocar(v);
+        ultimoAcceso[v] = ++contadorReloj;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int hits = argc > 1 ? atoi(argv[1]) : 4;
+    double msMax = argc > 2 ? atof(argv[2]) : 200;
+    if (hits < 0)
+        hits = 0;
+
+    if (!mismasVictimas(4096, hits, 20000))
+    {
+        printf("ERROR: la lista y el recorrido lineal eligieron víctimas distintas\n");
+        return 1;
+    }
+
+    printf("=== bench_lru (%d accesos entre faults, %.0f ms por medición) ===\n", hits, msMax);
+    printf("%10s %10s %16s %16s %10s\n", "marcos", "RAM 4KB", "lineal faults/s", "lista faults/s", "mejora");
+    const int tamanios[] = {1 << 10, 1 << 14, 1 << 18, 1 << 20, 1 << 22};
+    for (int marcos : tamanios)
+    {
+        int v1, v2;
+        double lineal = faultsLineal(marcos, hits, msMax, &v1);
+        double lista = faultsLista(marcos, hits, msMax, &v2);
+        char ram[32];
+        snprintf(ram, sizeof(ram), "%d MB", marcos / 256);
+        printf("%10d %10s %16.0f %16.0f %9.0fx\n", marcos, ram, lineal, lista, lista / lineal);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Compara las políticas de reemplazo (politicas.h) sobre los mismos eventos:
+// tasa de aciertos y costo por acceso. Cada carga se genera una vez y se
+// repite con todas las políticas; OPT usa los próximos usos de la traza.
+// Las cargas salen de cargas.h, salvo la mezcla de caliente y recorrido.
+//
+// Compilar desde T3/:  g++ -std=c++17 -O2 bench/bench_politicas.cpp -o bench_politicas
+// Uso: ./bench_politicas [marcos] [accesos]
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "../src/cargas.h"
+#include "../src/traza.h"
+
+using namespace std;
+
+struct Carga
+{
+    const char *nombre;
+    vector<EventoMemoria> eventos;
+};
+
+// Procesos de 'paginas' páginas que se crean hasta ocupar ~3 veces la RAM;
+// de vez en cuando uno termina y se crea otro. 'elegir' da la página a acceder.
+template <class Elegir>
+static Carga generar(const char *nombre, int marcos, long long accesos, Elegir elegir)
+{
+    Carga c = {nombre, {}};
+    const int paginas = 256;
+    int procesos = 3 * marcos / paginas + 1, siguientePid = 1;
+    vector<int> pid;
+    for (int i = 0; i < procesos; i++)
+        pid.push_back(siguientePid++);
+    for (int p : pid)
+        for (int n = 0; n < paginas; n++)
+            c.eventos.push_back({clavePagina(p, n), EV_COLOCAR});
+
+    mt19937_64 gen(42);
+    for (long long a = 0; a < accesos; a++)
+    {
+        if (a % 20000 == 19999)
+        {
+            int i = (int)(gen() % pid.size());
+            for (int n = 0; n < paginas; n++)
+                c.eventos.push_back({clavePagina(pid[i], n), EV_LIBERAR});
+            pid[i] = siguientePid++;
+            for (int n = 0; n < paginas; n++)
+                c.eventos.push_back({clavePagina(pid[i], n), EV_COLOCAR});
+        }
+        long long g = elegir(gen, a, (long long)pid.size() * paginas);
+        c.eventos.push_back({clavePagina(pid[g / paginas], (int)(g % paginas)), EV_ACCESO});
+    }
+    return c;
+}
+
+int main(int argc, char **argv)
+{
+    int marcos = argc > 1 ? atoi(argv[1]) : 4096;
+    long long accesos = argc > 2 ? atoll(argv[2]) : 1000000;
+    if (marcos < 256)
+        marcos = 256;
+
+    // Los generadores de cargas.h sobre todas las páginas vivas como un solo espacio
+    auto conGenerador = [](ParametrosCarga p) {
+        auto gc = make_shared<GeneradorCarga>(p, 7);
+        auto estado = make_shared<EstadoCarga>();
+        return [gc, estado](mt19937_64 &, long long, long long n) {
+            return (long long)gc->siguiente((uint32_t)n, *estado);
+        };
+    };
+    long long paginasTotales = (3 * marcos / 256 + 1) * 256LL;
+    ParametrosCarga pz, pu, pb, pf;
+    pz.tipo = CARGA_ZIPF;
+    pu.tipo = CARGA_UNIFORME;
+    // recorre en bucle un conjunto un 20% más grande que la RAM
+    pb.tipo = CARGA_BUCLE;
+    pb.conjunto = (marcos + marcos / 5) / (double)paginasTotales;
+    // conjunto de media RAM que se muda cada 50 000 accesos
+    pf.tipo = CARGA_FASES;
+    pf.conjunto = (marcos / 2) / (double)paginasTotales;
+    pf.largoFase = 50000;
+    // 80% sobre un conjunto caliente de media RAM, 20% recorriendo todo en orden
+    auto mezcla = [marcos](mt19937_64 &g, long long a, long long n) {
+        return g() % 5 ? (long long)(g() % (marcos / 2)) : (a * 7) % n;
+    };
+
+    vector<Carga> cargas;
+    cargas.push_back(generar("zipf", marcos, accesos, conGenerador(pz)));
+    cargas.push_back(generar("uniforme", marcos, accesos, conGenerador(pu)));
+    cargas.push_back(generar("bucle", marcos, accesos, conGenerador(pb)));
+    cargas.push_back(generar("fases", marcos, accesos, conGenerador(pf)));
+    cargas.push_back(generar("caliente+recorrido", marcos, accesos, mezcla));
+
+    printf("=== bench_politicas (%d marcos, %lld accesos por carga) ===\n", marcos, accesos);
+    for (const Carga &c : cargas)
+    {
+        vector<ResultadoPolitica> rs = compararPoliticas(c.eventos, marcos);
+        printf("\n--- %s ---\n", c.nombre);
+        imprimirComparacion(rs);
+
+        // OPT es el mínimo posible: si alguna lo supera, hay un error
+        uint64_t opt = rs.back().faults;
+        for (const ResultadoPolitica &r : rs)
+            if (r.faults < opt)
+            {
+                printf("ERROR: %s tuvo menos faults que OPT\n", r.nombre);
+                return 1;
+            }
+    }
+    return 0;
+}
@@ -0,0 +1,372 @@
+#ifndef ARCHIVO_TRAZA_H
+#define ARCHIVO_TRAZA_H
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "paginas_grandes.h"
+#include "traza.h"
+
+// Trazas de accesos a memoria, leídas con mmap.
+//
+// Texto: una línea por acceso, "proceso dirección" o solo "dirección"
+// (proceso 0). La dirección va en decimal o en hexadecimal con 0x; las
+// líneas vacías o que empiezan con '#' se saltan. El proceso tiene que
+// entrar en 16 bits y la dirección en 48, como en el binario.
+//
+// Binario: cabecera de 16 bytes y un uint64_t por acceso (little endian)
+//   "T3TR" | versión (uint32) | cantidad de accesos (uint64)
+//   acceso = proceso en los 16 bits altos | dirección en los 48 bajos
+static const char MAGIA_TRAZA[4] = {'T', '3', 'T', 'R'};
+static const uint32_t VERSION_TRAZA = 1;
+static const uint64_t MASCARA_DIRECCION = (1ull << 48) - 1;
+static const uint64_t MAX_PROCESO_TRAZA = 0xFFFF;
+
+struct CabeceraTraza
+{
+    char magia[4];
+    uint32_t version;
+    uint64_t accesos;
+};
+
+inline uint64_t empacarAcceso(uint32_t proceso, uint64_t direccion)
+{
+    return ((uint64_t)proceso << 48) | (direccion & MASCARA_DIRECCION);
+}
+
+class ArchivoTraza
+{
+public:
+    ArchivoTraza() : datos(nullptr), tam(0), binaria(false) {}
+    ~ArchivoTraza() { cerrar(); }
+    ArchivoTraza(const ArchivoTraza &) = delete;
+    ArchivoTraza &operator=(const ArchivoTraza &) = delete;
+
+    bool abrir(const std::string &ruta, std::string &error)
+    {
+        cerrar();
+        int fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            error = "no se pudo abrir " + ruta + ": " + strerror(errno);
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) < 0)
+        {
+            error = "no se pudo leer el tamaño de " + ruta;
+            ::close(fd);
+            return false;
+        }
+        tam = (size_t)st.st_size;
+        if (tam > 0)
+        {
+            void *p = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                error = "mmap de " + ruta + " falló: " + strerror(errno);
+                ::close(fd);
+                tam = 0;
+                return false;
+            }
+            datos = (const char *)p;
+            madvise(p, tam, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+
+        binaria = tam >= sizeof(CabeceraTraza) && memcmp(datos, MAGIA_TRAZA, 4) == 0;
+        if (binaria)
+        {
+            CabeceraTraza c;
+            memcpy(&c, datos, sizeof(c));
+            if (c.version != VERSION_TRAZA || tam != sizeof(c) + c.accesos * sizeof(uint64_t))
+            {
+                error = ruta + ": cabecera T3TR inválida o archivo truncado";
+                cerrar();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void cerrar()
+    {
+        if (datos)
+            munmap((void *)datos, tam);
+        datos = nullptr;
+        tam = 0;
+    }
+
+    bool esBinaria() const { return binaria; }
+
+    // Llama f(proceso, dirección) por cada acceso, en orden. false (con el
+    // número de línea en 'error') si una línea de texto no se entiende o
+    // no entra en el formato binario.
+    template <class F>
+    bool recorrer(F f, std::string &error) const
+    {
+        if (binaria)
+        {
+            const char *p = datos + sizeof(CabeceraTraza);
+            size_t n = (tam - sizeof(CabeceraTraza)) / sizeof(uint64_t);
+            for (size_t i = 0; i < n; i++)
+            {
+                uint64_t a;
+                memcpy(&a, p + i * sizeof(uint64_t), sizeof(a));
+                f((uint32_t)(a >> 48), a & MASCARA_DIRECCION);
+            }
+            return true;
+        }
+
+        const char *p = datos, *fin = datos + tam;
+        uint64_t linea = 0;
+        while (p < fin)
+        {
+            linea++;
+            const char *eol = (const char *)memchr(p, '\n', fin - p);
+            if (!eol)
+                eol = fin;
+            uint64_t a, b;
+            int n = numerosDeLinea(p, eol, a, b);
+            if (n < 0)
+            {
+                error = "línea " + std::to_string(linea) + " de la traza no es 'proceso dirección'";
+                return false;
+            }
+            if (n == 1)
+                b = a, a = 0;
+            if (n > 0 && (a > MAX_PROCESO_TRAZA || b > MASCARA_DIRECCION))
+            {
+                error = "línea " + std::to_string(linea) + " de la traza: " +
+                        (a > MAX_PROCESO_TRAZA ? "el proceso no entra en 16 bits" : "la dirección no entra en 48 bits");
+                return false;
+            }
+            if (n > 0)
+                f((uint32_t)a, b);
+            p = eol + 1;
+        }
+        return true;
+    }
+
+private:
+    const char *datos;
+    size_t tam;
+    bool binaria;
+
+    static bool esEspacio(char c) { return c == ' ' || c == '\t' || c == '\r' || c == ','; }
+
+    // Número decimal o 0x hexadecimal; false si no hay ninguno o no entra en 64 bits
+    static bool leerNumero(const char *&p, const char *fin, uint64_t &v)
+    {
+        v = 0;
+        if (fin - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+        {
+            p += 2;
+            const char *ini = p;
+            for (; p < fin; p++)
+            {
+                char c = *p;
+                int d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                                                      : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                                                             : -1;
+                if (d < 0)
+                    break;
+                if (v >> 60)
+                    return false;
+                v = v << 4 | (uint64_t)d;
+            }
+            return p > ini;
+        }
+        const char *ini = p;
+        for (; p < fin && *p >= '0' && *p <= '9'; p++)
+        {
+            uint64_t d = (uint64_t)(*p - '0');
+            if (v > (UINT64_MAX - d) / 10)
+                return false;
+            v = v * 10 + d;
+        }
+        return p > ini;
+    }
+
+    // 0 = línea vacía o comentario, 1 o 2 = números leídos, -1 = error
+    static int numerosDeLinea(const char *p, const char *fin, uint64_t &a, uint64_t &b)
+    {
+        while (p < fin && esEspacio(*p))
+            p++;
+        if (p == fin || *p == '#')
+            return 0;
+        if (!leerNumero(p, fin, a))
+            return -1;
+        while (p < fin && esEspacio(*p))
+            p++;
+        if (p == fin)
+            return 1;
+        if (!leerNumero(p, fin, b))
+            return -1;
+        while (p < fin && esEspacio(*p))
+            p++;
+        return p == fin ? 2 : -1;
+    }
+};
+
+// Escribe una traza binaria por lotes; la cantidad de la cabecera se
+// completa al cerrar
+class EscritorTraza
+{
+public:
+    EscritorTraza() : f(nullptr), escritos(0), fallo(false) { bloque.reserve(1 << 16); }
+    ~EscritorTraza()
+    {
+        std::string e;
+        cerrar(e);
+    }
+
+    bool abrir(const std::string &ruta, std::string &error)
+    {
+        f = fopen(ruta.c_str(), "wb");
+        if (!f)
+        {
+            error = "no se pudo crear " + ruta + ": " + strerror(errno);
+            return false;
+        }
+        nombre = ruta;
+        escritos = 0;
+        fallo = false;
+        escribirCabecera();
+        return true;
+    }
+
+    void agregar(uint32_t proceso, uint64_t direccion)
+    {
+        bloque.push_back(empacarAcceso(proceso, direccion));
+        if (bloque.size() == bloque.capacity())
+            vaciar();
+    }
+
+    bool cerrar(std::string &error)
+    {
+        if (!f)
+            return true;
+        vaciar();
+        fallo |= fseek(f, 0, SEEK_SET) != 0;
+        if (!fallo)
+            escribirCabecera();
+        bool ok = fclose(f) == 0 && !fallo;
+        f = nullptr;
+        if (!ok)
+            error = "error al escribir " + nombre;
+        return ok;
+    }
+
+    uint64_t cantidad() const { return escritos + bloque.size(); }
+
+private:
+    FILE *f;
+    std::string nombre;
+    std::vector<uint64_t> bloque;
+    uint64_t escritos;
+    bool fallo; // algún fwrite o fseek falló; lo informa cerrar()
+
+    void vaciar()
+    {
+        fallo |= fwrite(bloque.data(), sizeof(uint64_t), bloque.size(), f) != bloque.size();
+        escritos += bloque.size();
+        bloque.clear();
+    }
+
+    void escribirCabecera()
+    {
+        CabeceraTraza c;
+        memcpy(c.magia, MAGIA_TRAZA, 4);
+        c.version = VERSION_TRAZA;
+        c.accesos = escritos;
+        fallo |= fwrite(&c, sizeof(c), 1, f) != 1;
+    }
+};
+
+// Pasa una traza (de texto o binaria) al formato binario
+inline bool escribirTrazaBinaria(const ArchivoTraza &traza, const std::string &ruta,
+                                 uint64_t &escritos, std::string &error)
+{
+    EscritorTraza salida;
+    if (!salida.abrir(ruta, error))
+        return false;
+    bool ok = traza.recorrer([&](uint32_t proceso, uint64_t dir) { salida.agregar(proceso, dir); }, error);
+    escritos = salida.cantidad();
+    return salida.cerrar(error) && ok;
+}
+
+// Próximo uso de cada acceso de la traza, para OPT. false (con 'error') si
+// la traza no se pudo leer entera: OPT no puede correr sobre un pedazo
+inline bool proximosUsosTraza(const ArchivoTraza &traza, uint64_t bytesPagina, std::vector<uint64_t> &proximo,
+                              std::string &error)
+{
+    std::vector<uint64_t> paginas;
+    if (!traza.recorrer([&](uint32_t proceso, uint64_t dir) { paginas.push_back(clavePagina(proceso, dir / bytesPagina)); },
+                        error))
+        return false;
+
+    proximo.assign(paginas.size(), SIN_USO);
+    std::unordered_map<uint64_t, uint64_t> siguiente;
+    for (size_t i = paginas.size(); i-- > 0;)
+    {
+        auto it = siguiente.find(paginas[i]);
+        if (it != siguiente.end())
+        {
+            proximo[i] = it->second;
+            it->second = i;
+        }
+        else
+            siguiente.emplace(paginas[i], i);
+    }
+    return true;
+}
+
+// Pasa la traza completa por una RAM de 'marcos' marcos, sin pausas ni
+// salida; con 'tlb' cada acceso se traduce primero, con 'respaldo' los
+// faults mueven páginas reales (el tiempo incluye esperar el último lote) y
+// con 'prebuscador' cada fault trae además las páginas que este proponga
+inline ResultadoPolitica ejecutarTraza(const ArchivoTraza &traza, int marcos, uint64_t bytesPagina,
+                                       Politica &politica, const std::vector<uint64_t> *proximos,
+                                       std::string &error, TLB *tlb = nullptr,
+                                       MemoriaRespaldada *respaldo = nullptr, Prebuscador *prebuscador = nullptr,
+                                       SwapComprimida *zswap = nullptr)
+{
+    ModeloRAM ram(marcos, politica);
+    ram.usarTLB(tlb);
+    ram.usarRespaldo(respaldo);
+    ram.usarPrebuscador(prebuscador);
+    ram.usarSwapComprimida(zswap);
+    uint64_t i = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    traza.recorrer([&](uint32_t proceso, uint64_t dir) {
+        if (proximos)
+            politica.siguienteUso((*proximos)[i++]);
+        ram.acceder(clavePagina(proceso, dir / bytesPagina));
+    }, error);
+    if (respaldo)
+        respaldo->esperar();
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return {politica.nombre(), ram.accesos, ram.faults, ram.desalojos, segundos};
+}
+
+// La misma traza sobre una RAM con páginas grandes; los contadores propios quedan en 'ram'
+inline ResultadoPolitica ejecutarTrazaMixta(const ArchivoTraza &traza, RAMMixta &ram, Politica &politica,
+                                            std::string &error)
+{
+    auto inicio = std::chrono::steady_clock::now();
+    traza.recorrer([&](uint32_t proceso, uint64_t dir) { ram.acceder(proceso, dir); }, error);
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return {politica.nombre(), ram.accesos, ram.faults, ram.desalojos, segundos};
+}
+
+#endif
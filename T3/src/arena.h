@@ -0,0 +1,93 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Arena de elementos en un solo vector, repartida en tramos contiguos: cada
+// proceso recibe un tramo con todas sus páginas y se refiere a ellas por
+// índice (uint32_t), no por puntero, así que el vector puede crecer.
+//
+// Los tramos liberados se juntan con los vecinos libres y se reusan con el
+// mejor ajuste; el que queda al final se devuelve achicando el vector.
+template <class T>
+class ArenaRangos
+{
+public:
+    // Índice del primer elemento de un tramo de 'n' elementos
+    uint32_t reservar(uint32_t n)
+    {
+        auto it = porLargo.lower_bound(n);
+        if (it != porLargo.end())
+        {
+            uint32_t largo = it->first, inicio = it->second;
+            porLargo.erase(it);
+            porInicio.erase(inicio);
+            if (largo > n)
+                agregarLibre(inicio + n, largo - n);
+            return inicio;
+        }
+        uint32_t inicio = (uint32_t)elementos.size();
+        elementos.resize(elementos.size() + n);
+        return inicio;
+    }
+
+    void liberar(uint32_t inicio, uint32_t n)
+    {
+        if (n == 0)
+            return;
+        // juntar con el tramo libre siguiente y con el anterior
+        auto sig = porInicio.find(inicio + n);
+        if (sig != porInicio.end())
+        {
+            n += sig->second;
+            quitarLibre(sig);
+        }
+        auto ant = porInicio.lower_bound(inicio);
+        if (ant != porInicio.begin())
+        {
+            --ant;
+            if (ant->first + ant->second == inicio)
+            {
+                inicio = ant->first;
+                n += ant->second;
+                quitarLibre(ant);
+            }
+        }
+        if (inicio + n == elementos.size())
+            elementos.resize(inicio);
+        else
+            agregarLibre(inicio, n);
+    }
+
+    T &operator[](uint32_t i) { return elementos[i]; }
+    const T &operator[](uint32_t i) const { return elementos[i]; }
+    size_t size() const { return elementos.size(); }
+    size_t tramosLibres() const { return porInicio.size(); }
+
+private:
+    std::vector<T> elementos;
+    std::map<uint32_t, uint32_t> porInicio;     // inicio -> largo
+    std::multimap<uint32_t, uint32_t> porLargo; // largo -> inicio
+
+    void agregarLibre(uint32_t inicio, uint32_t n)
+    {
+        porInicio[inicio] = n;
+        porLargo.emplace(n, inicio);
+    }
+
+    void quitarLibre(std::map<uint32_t, uint32_t>::iterator it)
+    {
+        auto r = porLargo.equal_range(it->second);
+        for (auto j = r.first; j != r.second; ++j)
+            if (j->second == it->first)
+            {
+                porLargo.erase(j);
+                break;
+            }
+        porInicio.erase(it);
+    }
+};
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef CARGAS_H
+#define CARGAS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+
+// Generadores de accesos con localidad. Cada proceso lleva su propio
+// EstadoCarga (cursor del recorrido, base del conjunto de trabajo) y el
+// generador llena lotes de números de página dentro de ese proceso.
+enum TipoCarga
+{
+    CARGA_UNIFORME,   // cualquier página con la misma probabilidad
+    CARGA_ZIPF,       // la página de rango k con probabilidad ~ 1/k^s
+    CARGA_SECUENCIAL, // recorre el proceso de principio a fin, una y otra vez
+    CARGA_BUCLE,      // recorre en bucle un conjunto de trabajo fijo
+    CARGA_FASES       // uniforme dentro de un conjunto que se muda cada 'largoFase' accesos
+};
+
+static const char *const NOMBRES_CARGAS[] = {"uniforme", "zipf", "secuencial", "bucle", "fases"};
+
+struct ParametrosCarga
+{
+    TipoCarga tipo = CARGA_UNIFORME;
+    double zipfS = 0.99;           // exponente de Zipf
+    double conjunto = 0.2;         // fracción del proceso en el conjunto de trabajo (bucle, fases)
+    uint64_t largoFase = 100000;   // accesos del proceso por fase
+};
+
+// false si el nombre no es una carga conocida
+inline bool tipoCargaDesdeNombre(const std::string &nombre, TipoCarga &tipo)
+{
+    for (int i = 0; i < (int)(sizeof(NOMBRES_CARGAS) / sizeof(NOMBRES_CARGAS[0])); i++)
+        if (nombre == NOMBRES_CARGAS[i])
+        {
+            tipo = (TipoCarga)i;
+            return true;
+        }
+    return false;
+}
+
+inline std::string describirCarga(const ParametrosCarga &c)
+{
+    std::ostringstream os;
+    os << NOMBRES_CARGAS[c.tipo];
+    if (c.tipo == CARGA_ZIPF)
+        os << " (s = " << c.zipfS << ")";
+    else if (c.tipo == CARGA_BUCLE)
+        os << " (conjunto de " << c.conjunto * 100 << "% del proceso)";
+    else if (c.tipo == CARGA_FASES)
+        os << " (conjunto de " << c.conjunto * 100 << "% del proceso, fases de " << c.largoFase << " accesos)";
+    return os.str();
+}
+
+struct EstadoCarga
+{
+    uint64_t cursor = 0;   // próxima posición del recorrido o del bucle
+    uint64_t accesos = 0;  // accesos generados para este proceso
+    uint32_t base = 0;     // inicio del conjunto de trabajo (fases)
+};
+
+// Zipf sobre los rangos 1..n por rechazo-inversión (Hörmann y Derflinger):
+// O(1) por muestra sin tablas, así que sirve para procesos de cualquier tamaño.
+class MuestreadorZipf
+{
+public:
+    MuestreadorZipf() : n(0), s(1) {}
+
+    void preparar(uint32_t paginas, double exponente)
+    {
+        if (paginas == n && exponente == s)
+            return;
+        n = paginas;
+        s = exponente;
+        hIntegralX1 = hIntegral(1.5) - 1.0;
+        hIntegralN = hIntegral(n + 0.5);
+        corte = 2.0 - hIntegralInversa(hIntegral(2.5) - h(2.0));
+    }
+
+    // Rango en [0, n): 0 es la página más popular
+    template <class Gen>
+    uint32_t muestra(Gen &gen)
+    {
+        std::uniform_real_distribution<double> u01(0.0, 1.0);
+        while (true)
+        {
+            double u = hIntegralN + u01(gen) * (hIntegralX1 - hIntegralN);
+            double x = hIntegralInversa(u);
+            double k = std::floor(x + 0.5);
+            if (k < 1)
+                k = 1;
+            else if (k > n)
+                k = n;
+            if (k - x <= corte || u >= hIntegral(k + 0.5) - h(k))
+                return (uint32_t)k - 1;
+        }
+    }
+
+private:
+    uint32_t n;
+    double s, hIntegralX1, hIntegralN, corte;
+
+    static double aux1(double x) { return std::fabs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x)); }
+    static double aux2(double x) { return std::fabs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x)); }
+    double h(double x) const { return std::exp(-s * std::log(x)); }
+    double hIntegral(double x) const
+    {
+        double lx = std::log(x);
+        return aux2((1 - s) * lx) * lx;
+    }
+    double hIntegralInversa(double x) const
+    {
+        double t = x * (1 - s);
+        if (t < -1)
+            t = -1;
+        return std::exp(aux1(t) * x);
+    }
+};
+
+class GeneradorCarga
+{
+public:
+    GeneradorCarga(const ParametrosCarga &p = ParametrosCarga(), uint64_t semilla = 1)
+        : param(p), gen(semilla) {}
+
+    const ParametrosCarga &parametros() const { return param; }
+
+    // Llena salida[0..n) con páginas en [0, paginas) del proceso de 'estado'
+    void generar(uint32_t paginas, EstadoCarga &estado, uint32_t *salida, size_t n)
+    {
+        if (paginas == 0)
+            return;
+        uint32_t conjunto = tamConjunto(paginas);
+        switch (param.tipo)
+        {
+        case CARGA_UNIFORME:
+            for (size_t i = 0; i < n; i++)
+                salida[i] = uniforme(paginas);
+            break;
+        case CARGA_ZIPF:
+            zipf.preparar(paginas, param.zipfS);
+            for (size_t i = 0; i < n; i++)
+                salida[i] = zipf.muestra(gen);
+            break;
+        case CARGA_SECUENCIAL:
+            for (size_t i = 0; i < n; i++)
+                salida[i] = (uint32_t)(estado.cursor++ % paginas);
+            break;
+        case CARGA_BUCLE:
+            for (size_t i = 0; i < n; i++)
+                salida[i] = (uint32_t)(estado.cursor++ % conjunto);
+            break;
+        case CARGA_FASES:
+            for (size_t i = 0; i < n; i++)
+            {
+                if ((estado.accesos + i) % param.largoFase == 0)
+                    estado.base = uniforme(paginas);
+                salida[i] = (estado.base + uniforme(conjunto)) % paginas;
+            }
+            break;
+        }
+        estado.accesos += n;
+    }
+
+    uint32_t siguiente(uint32_t paginas, EstadoCarga &estado)
+    {
+        uint32_t p = 0;
+        generar(paginas, estado, &p, 1);
+        return p;
+    }
+
+private:
+    ParametrosCarga param;
+    std::mt19937_64 gen;
+    MuestreadorZipf zipf;
+
+    // en [0, n) con una multiplicación en vez de una división
+    uint32_t uniforme(uint32_t n) { return (uint32_t)(((gen() >> 32) * (uint64_t)n) >> 32); }
+
+    uint32_t tamConjunto(uint32_t paginas) const
+    {
+        uint32_t c = (uint32_t)(paginas * param.conjunto);
+        return c < 1 ? 1 : c > paginas ? paginas : c;
+    }
+};
+
+#endif
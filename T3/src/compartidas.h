@@ -0,0 +1,147 @@
+#ifndef COMPARTIDAS_H
+#define COMPARTIDAS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "politicas.h"
+
+// Páginas compartidas entre procesos. Cada página virtual mapea una página
+// física (su contenido, que vive en un marco de RAM o de SWAP) y una física
+// puede estar mapeada por varias virtuales:
+//
+//  - con --fork, un proceso nuevo puede ser hijo de uno activo y mapear las
+//    mismas físicas que el padre sin ocupar marcos. Cuando un proceso escribe
+//    en una física compartida se queda con una copia propia (copy-on-write);
+//  - con --bibliotecas, cada proceso mapea además N regiones de solo lectura
+//    que se cargan con el primero que las usa y se liberan con el último.
+//
+// La política, el pool comprimido, la SWAP real y la comparación de políticas
+// ven físicas; el TLB sigue traduciendo páginas virtuales.
+struct ParametrosCompartir
+{
+    double fork = 0;        // probabilidad de que un proceso nuevo sea fork de un activo
+    double escrituras = 0;  // fracción de los accesos que escriben
+    int bibliotecas = 0;    // regiones compartidas que mapea cada proceso
+    int bibliotecaMB = 1;   // tamaño de cada una
+
+    bool activo() const { return fork > 0 || escrituras > 0 || bibliotecas > 0; }
+};
+
+inline bool validarCompartir(const ParametrosCompartir &p, std::string &error)
+{
+    if (p.fork < 0 || p.fork > 1 || p.escrituras < 0 || p.escrituras > 1)
+        return error = "la probabilidad de fork y la fracción de escrituras van de 0 a 1", false;
+    if (p.bibliotecas < 0 || p.bibliotecas > 64 || p.bibliotecaMB <= 0)
+        return error = "las bibliotecas van de 0 a 64 y su tamaño tiene que ser positivo", false;
+    return true;
+}
+
+// Las copias y las bibliotecas no son de un proceso: sus claves usan
+// procesos que no existen (los ids empiezan en 1 y no llegan a 2^24 - 64)
+static const uint32_t PROCESO_COPIAS = 0;
+static const uint32_t PROCESO_BIBLIOTECAS = (1u << 24) - 1; // y hacia abajo, una por biblioteca
+
+inline uint64_t claveBiblioteca(int biblioteca, uint64_t pagina)
+{
+    return clavePagina(PROCESO_BIBLIOTECAS - biblioteca, pagina);
+}
+
+// Biblioteca de una física por su clave, o -1 si no es de ninguna
+inline int bibliotecaDe(uint64_t clave)
+{
+    uint32_t proceso = (uint32_t)(clave >> 40);
+    return proceso > PROCESO_BIBLIOTECAS - 64 ? (int)(PROCESO_BIBLIOTECAS - proceso) : -1;
+}
+
+struct PaginaFisica
+{
+    uint64_t clave;       // identidad para la política, el pool y los eventos
+    int marco;            // en RAM o en SWAP según enRAM (-1 si todavía en ninguno)
+    bool enRAM;
+    bool prebuscada;      // traída por la prebúsqueda y todavía sin usar
+    uint32_t mapeos;      // páginas virtuales que la mapean
+    uint32_t primerMapeo; // la lista sigue por Pagina::siguienteMapeo
+};
+
+// Las físicas vivas, con sus índices reusados, y la cuenta de la huella:
+// 'rss' suma las páginas residentes de cada proceso (una compartida cuenta
+// una vez por cada proceso que la mapea), y la RAM ocupada es la suma de
+// los PSS, donde cada proceso paga 1/mapeos de cada física residente
+class TablaFisicas
+{
+public:
+    static const uint32_t NINGUNA = UINT32_MAX;
+
+    uint64_t forks = 0, copias = 0, copiasConFallo = 0, bibliotecasCargadas = 0;
+    uint64_t mapeos = 0;      // páginas virtuales vivas
+    uint64_t rss = 0;
+    uint64_t compartidas = 0; // físicas con más de un mapeo
+
+    PaginaFisica &operator[](uint32_t i) { return fisicas[i]; }
+    const PaginaFisica &operator[](uint32_t i) const { return fisicas[i]; }
+
+    uint64_t vivas() const { return fisicas.size() - libres.size(); }
+
+    // Física nueva sin marco ni mapeos; puede mover a las demás
+    uint32_t crear(uint64_t clave)
+    {
+        uint32_t i;
+        if (libres.empty())
+        {
+            i = (uint32_t)fisicas.size();
+            fisicas.push_back(PaginaFisica());
+        }
+        else
+        {
+            i = libres.back();
+            libres.pop_back();
+        }
+        fisicas[i] = {clave, -1, false, false, 0, NINGUNA};
+        return i;
+    }
+
+    void liberar(uint32_t i) { libres.push_back(i); }
+
+    // Clave de la copia privada que deja una escritura sobre una compartida
+    uint64_t claveCopia() { return clavePagina(PROCESO_COPIAS, ++copias); }
+
+    void ponerEnRAM(uint32_t i, int marco)
+    {
+        if (!fisicas[i].enRAM)
+            rss += fisicas[i].mapeos;
+        fisicas[i].enRAM = true;
+        fisicas[i].marco = marco;
+    }
+
+    void ponerEnSwap(uint32_t i, int marco)
+    {
+        if (fisicas[i].enRAM)
+            rss -= fisicas[i].mapeos;
+        fisicas[i].enRAM = false;
+        fisicas[i].marco = marco;
+    }
+
+    // La lista de mapeos la arma quien conoce las páginas virtuales
+    void sumarMapeo(uint32_t i)
+    {
+        PaginaFisica &f = fisicas[i];
+        compartidas += ++f.mapeos == 2;
+        rss += f.enRAM;
+        mapeos++;
+    }
+
+    void restarMapeo(uint32_t i)
+    {
+        PaginaFisica &f = fisicas[i];
+        compartidas -= f.mapeos-- == 2;
+        rss -= f.enRAM;
+        mapeos--;
+    }
+
+private:
+    std::vector<PaginaFisica> fisicas;
+    std::vector<uint32_t> libres;
+};
+
+#endif
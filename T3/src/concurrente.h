@@ -0,0 +1,280 @@
+#ifndef CONCURRENTE_H
+#define CONCURRENTE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cargas.h"
+#include "lru.h"
+#include "marcos.h"
+
+// Modo concurrente: varios hilos acceden a la vez a páginas de procesos
+// distintos sobre un mismo conjunto de marcos de RAM. Las páginas de todos
+// los procesos se numeran seguidas: proceso * paginasPorProceso + página.
+
+// Contadores y estado de cada hilo; en su propia línea de caché
+struct alignas(64) ContextoHilo
+{
+    uint64_t accesos = 0, faults = 0, desalojos = 0;
+    uint64_t desde = 0, hasta = 0; // posiciones de la manecilla reservadas (CLOCK)
+};
+
+class RAMConcurrente
+{
+public:
+    virtual ~RAMConcurrente() {}
+    virtual const char *nombre() const = 0;
+    virtual void acceder(uint32_t pagina, ContextoHilo &ctx) = 0;
+    // Con todos los hilos detenidos: cada marco y su página se apuntan entre sí
+    virtual bool verificar(std::string &error) const = 0;
+};
+
+// CLOCK sin locks. Cada marco tiene su dueño en un atómico (0 = libre,
+// TOMADO = alguien lo está reemplazando, si no página + 1) y su bit de
+// referencia. Para reemplazar se toma el marco con un CAS sobre el dueño, así
+// que dos hilos nunca desalojan el mismo. La manecilla es un contador
+// atómico del que cada hilo reserva tramos de LOTE_MANECILLA posiciones.
+class ClockConcurrente : public RAMConcurrente
+{
+public:
+    ClockConcurrente(int marcos, uint32_t paginas)
+        : n(marcos), marco(new Marco[marcos]), tabla(new std::atomic<int32_t>[paginas]), mano(0)
+    {
+        for (int m = 0; m < n; m++)
+        {
+            marco[m].dueno.store(LIBRE, std::memory_order_relaxed);
+            marco[m].ref.store(0, std::memory_order_relaxed);
+        }
+        for (uint32_t p = 0; p < paginas; p++)
+            tabla[p].store(-1, std::memory_order_relaxed);
+    }
+
+    const char *nombre() const override { return "CLOCK sin locks"; }
+
+    void acceder(uint32_t p, ContextoHilo &ctx) override
+    {
+        ctx.accesos++;
+        int32_t m = tabla[p].load(std::memory_order_acquire);
+        // la tabla puede estar atrasada: el marco manda
+        if (m >= 0 && marco[m].dueno.load(std::memory_order_acquire) == (uint64_t)p + 1)
+        {
+            if (!marco[m].ref.load(std::memory_order_relaxed))
+                marco[m].ref.store(1, std::memory_order_relaxed);
+            return;
+        }
+
+        ctx.faults++;
+        m = tomarMarco(ctx);
+        marco[m].ref.store(1, std::memory_order_relaxed);
+        tabla[p].store(m, std::memory_order_release);
+        marco[m].dueno.store((uint64_t)p + 1, std::memory_order_release);
+    }
+
+    bool verificar(std::string &error) const override
+    {
+        for (int m = 0; m < n; m++)
+        {
+            uint64_t d = marco[m].dueno.load();
+            if (d == TOMADO)
+                return error = "marco " + std::to_string(m) + " quedó tomado", false;
+            // como cada página apunta a un solo marco, esto también
+            // descarta que una página esté en dos marcos
+            if (d != LIBRE && tabla[d - 1].load() != m)
+                return error = "el marco " + std::to_string(m) + " y su página no coinciden", false;
+        }
+        return true;
+    }
+
+private:
+    static const uint64_t LIBRE = 0, TOMADO = UINT64_MAX;
+    static const uint64_t LOTE_MANECILLA = 64;
+
+    struct Marco
+    {
+        std::atomic<uint64_t> dueno;
+        std::atomic<uint8_t> ref;
+    };
+
+    int n;
+    std::unique_ptr<Marco[]> marco;
+    std::unique_ptr<std::atomic<int32_t>[]> tabla; // página -> marco (-1 si no está)
+    alignas(64) std::atomic<uint64_t> mano;
+
+    int tomarMarco(ContextoHilo &ctx)
+    {
+        while (true)
+        {
+            if (ctx.desde == ctx.hasta)
+            {
+                ctx.desde = mano.fetch_add(LOTE_MANECILLA, std::memory_order_relaxed);
+                ctx.hasta = ctx.desde + LOTE_MANECILLA;
+            }
+            int m = (int)(ctx.desde++ % (uint64_t)n);
+            Marco &mc = marco[m];
+            uint64_t d = mc.dueno.load(std::memory_order_acquire);
+            if (d == TOMADO)
+                continue;
+            if (d != LIBRE && mc.ref.load(std::memory_order_relaxed))
+            {
+                mc.ref.store(0, std::memory_order_relaxed);
+                continue;
+            }
+            if (!mc.dueno.compare_exchange_strong(d, TOMADO, std::memory_order_acq_rel))
+                continue;
+            if (d != LIBRE)
+            {
+                // la página desalojada deja de apuntar aquí, si nadie la movió antes
+                int32_t esperado = m;
+                tabla[d - 1].compare_exchange_strong(esperado, -1, std::memory_order_acq_rel);
+                ctx.desalojos++;
+            }
+            return m;
+        }
+    }
+};
+
+// LRU repartida en fragmentos, cada uno con su lock, su lista LRU y sus
+// marcos libres. Cada página cae siempre en el mismo fragmento (por hash),
+// así que es como tener 'fragmentos' RAM chicas independientes.
+class LRUFragmentada : public RAMConcurrente
+{
+public:
+    LRUFragmentada(int marcos, uint32_t paginas, int fragmentos)
+        : tabla(paginas, -1), frag(fragmentos)
+    {
+        int base = 0;
+        for (int i = 0; i < fragmentos; i++)
+        {
+            int tam = marcos / fragmentos + (i < marcos % fragmentos ? 1 : 0);
+            frag[i].reset(new Fragmento(base, tam));
+            base += tam;
+        }
+    }
+
+    const char *nombre() const override { return "LRU fragmentada"; }
+
+    void acceder(uint32_t p, ContextoHilo &ctx) override
+    {
+        ctx.accesos++;
+        Fragmento &f = *frag[fragmentoDe(p)];
+        std::lock_guard<std::mutex> lock(f.mutex);
+        int32_t m = tabla[p];
+        if (m >= 0)
+        {
+            f.lru.tocar(m - f.base);
+            return;
+        }
+
+        ctx.faults++;
+        int local = f.libres.tomar();
+        if (local == -1)
+        {
+            local = f.lru.victima();
+            f.lru.quitar(local);
+            tabla[f.paginaEn[local]] = -1;
+            ctx.desalojos++;
+        }
+        f.paginaEn[local] = p;
+        tabla[p] = f.base + local;
+        f.lru.tocar(local);
+    }
+
+    bool verificar(std::string &error) const override
+    {
+        for (const auto &fp : frag)
+        {
+            const Fragmento &f = *fp;
+            for (int local = 0; local < f.tam; local++)
+                if (!f.libres.estaLibre(local) && tabla[f.paginaEn[local]] != f.base + local)
+                    return error = "el marco " + std::to_string(f.base + local) + " y su página no coinciden", false;
+        }
+        return true;
+    }
+
+private:
+    struct alignas(64) Fragmento
+    {
+        std::mutex mutex;
+        int base, tam;
+        ListaLRU lru;
+        AsignadorMarcos libres;
+        std::vector<uint32_t> paginaEn;
+        Fragmento(int b, int t) : base(b), tam(t), lru(t), libres(t), paginaEn(t, 0) {}
+    };
+
+    std::vector<int32_t> tabla; // cada entrada la protege el lock de su fragmento
+    std::vector<std::unique_ptr<Fragmento>> frag;
+
+    size_t fragmentoDe(uint32_t p) const { return (size_t)(((uint64_t)(p * 2654435761u) * frag.size()) >> 32); }
+};
+
+struct ResultadoConcurrente
+{
+    uint64_t accesos, faults, desalojos;
+    double segundos;
+};
+
+// Cada hilo atiende los procesos p con p % hilos == su número: elige uno
+// al azar por ráfaga y le pide al generador 'rafaga' páginas de una vez
+inline ResultadoConcurrente ejecutarConcurrente(RAMConcurrente &ram, int hilos, const ParametrosCarga &carga,
+                                                int procesos, uint32_t paginasPorProceso, uint64_t accesos,
+                                                int rafaga, uint64_t semilla)
+{
+    std::vector<ContextoHilo> ctx(hilos);
+    std::vector<std::thread> trabajadores;
+    std::atomic<int> listos(0);
+    std::atomic<bool> largar(false);
+
+    auto trabajo = [&](int h) {
+        std::vector<int> mios;
+        for (int p = h; p < procesos; p += hilos)
+            mios.push_back(p);
+        GeneradorCarga generador(carga, semilla + h);
+        std::vector<EstadoCarga> estados(mios.size());
+        std::vector<uint32_t> lote(rafaga);
+        std::mt19937_64 genProceso(semilla ^ (0x9e3779b97f4a7c15ull * (h + 1)));
+        uint64_t cuota = accesos / hilos + (h < (int)(accesos % hilos) ? 1 : 0);
+
+        listos++;
+        while (!largar.load())
+            std::this_thread::yield();
+
+        for (uint64_t hechos = 0; hechos < cuota && !mios.empty();)
+        {
+            size_t i = genProceso() % mios.size();
+            size_t n = (size_t)std::min<uint64_t>(rafaga, cuota - hechos);
+            generador.generar(paginasPorProceso, estados[i], lote.data(), n);
+            uint32_t base = (uint32_t)mios[i] * paginasPorProceso;
+            for (size_t k = 0; k < n; k++)
+                ram.acceder(base + lote[k], ctx[h]);
+            hechos += n;
+        }
+    };
+
+    for (int h = 0; h < hilos; h++)
+        trabajadores.emplace_back(trabajo, h);
+    while (listos.load() < hilos)
+        std::this_thread::yield();
+    auto inicio = std::chrono::steady_clock::now();
+    largar = true;
+    for (auto &t : trabajadores)
+        t.join();
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    ResultadoConcurrente r = {0, 0, 0, segundos};
+    for (const ContextoHilo &c : ctx)
+    {
+        r.accesos += c.accesos;
+        r.faults += c.faults;
+        r.desalojos += c.desalojos;
+    }
+    return r;
+}
+
+#endif
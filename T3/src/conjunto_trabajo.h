@@ -0,0 +1,145 @@
+#ifndef CONJUNTO_TRABAJO_H
+#define CONJUNTO_TRABAJO_H
+
+#include <cstdint>
+#include <string>
+
+// Conjunto de trabajo por proceso con bits de referencia muestreados: cada
+// página lleva un byte de historia cuyo bit 0 se prende al usarla. Cuando el
+// proceso cumple 'ventana' accesos propios (su tiempo virtual) se recorren
+// sus páginas: están en el conjunto las que tienen algún bit prendido en las
+// últimas 'ventanas' ventanas, y la historia se corre un lugar.
+//
+// El control de carga mira la suma de los conjuntos de los procesos activos:
+// si pasa de 'alto' por los marcos de RAM suspende al proceso activo más
+// nuevo (todas sus páginas van a SWAP), y reanuda al suspendido más viejo
+// cuando su conjunto entra por debajo de 'bajo' por los marcos. Para que
+// nadie espere para siempre, si el más viejo ya esperó 'turno' muestras
+// entra igual, por turno, en lugar del activo que lleva más tiempo en RAM.
+struct ParametrosConjuntoTrabajo
+{
+    bool medir = false;      // --conjunto-trabajo
+    bool controlar = false;  // --control-carga (también mide)
+    int ventana = 512;       // accesos del proceso por ventana
+    int ventanas = 8;        // historia que cuenta: tau = ventana * ventanas (hasta 8)
+    double alto = 1.0, bajo = 0.8; // fracción de los marcos de RAM
+    int turno = 16;          // muestras que espera el suspendido más viejo antes de entrar por turno (0 = nunca)
+    double usAcceso = 0.1, usFallo = 100; // modelo de tiempo para el rendimiento
+
+    bool activo() const { return medir || controlar; }
+};
+
+inline bool validarConjuntoTrabajo(const ParametrosConjuntoTrabajo &p, std::string &error)
+{
+    if (p.ventana <= 0 || p.ventanas <= 0 || p.ventanas > 8)
+        return error = "la ventana tiene que ser positiva y las ventanas, de 1 a 8", false;
+    if (p.bajo <= 0 || p.bajo > p.alto)
+        return error = "los umbrales del control de carga tienen que cumplir 0 < bajo <= alto", false;
+    if (p.turno < 0)
+        return error = "el turno del control de carga no puede ser negativo", false;
+    if (p.usAcceso < 0 || p.usFallo < 0)
+        return error = "las latencias no pueden ser negativas", false;
+    return true;
+}
+
+// Lo que cada proceso lleva de su conjunto de trabajo
+struct ConjuntoProceso
+{
+    int paginas = 0;             // tamaño estimado del conjunto
+    int accesos = 0, fallos = 0; // de la ventana en curso
+    double pff = 0;              // fallos por acceso de la última ventana cerrada
+    uint64_t muestra = 0;        // muestra global en que entró a la RAM o salió de ella
+    bool corrio = false;         // estuvo activo alguna vez
+};
+
+// Cierra la ventana para una página: true si está en el conjunto
+inline bool cerrarVentanaPagina(uint8_t &historia, int ventanas)
+{
+    bool enConjunto = (historia & ((1u << ventanas) - 1)) != 0;
+    historia = (uint8_t)(historia << 1);
+    return enConjunto;
+}
+
+class ControlCarga
+{
+public:
+    enum Decision
+    {
+        SEGUIR,
+        SUSPENDER, // al activo más nuevo
+        REANUDAR,  // al suspendido más viejo
+        ROTAR      // el suspendido más viejo ya esperó su turno: entra por el que lleva más tiempo en RAM
+    };
+
+    uint64_t muestras = 0, sobrecargadas = 0;      // ventanas globales y cuántas con el conjunto por encima de la RAM
+    uint64_t accesosSobrecarga = 0, fallosSobrecarga = 0, accesosNormal = 0, fallosNormal = 0;
+    uint64_t suspensiones = 0, reanudaciones = 0, enEspera = 0, expulsadas = 0, turnos = 0;
+    int64_t conjuntoActivos = 0; // suma de los conjuntos de los procesos activos
+    int64_t conjuntoMaximo = 0;
+    double sumaConjunto = 0;
+
+    ControlCarga(const ParametrosConjuntoTrabajo &p, int marcos) : param(p), numMarcos(marcos), accesos(0), fallos(0) {}
+
+    const ParametrosConjuntoTrabajo &parametros() const { return param; }
+
+    bool sobrecarga() const { return conjuntoActivos > param.alto * numMarcos; }
+
+    // Un acceso de cualquier proceso; cada 'ventana' accesos se toma una muestra
+    // global y, con control, se decide. 'siguiente' es el conjunto del
+    // suspendido más viejo (-1 si no hay) y 'esperaDesde', la muestra en que
+    // se suspendió.
+    Decision acceso(bool fallo, int activos, int siguiente, uint64_t esperaDesde)
+    {
+        accesos++;
+        fallos += fallo;
+        if (accesos < (uint64_t)param.ventana)
+            return SEGUIR;
+        muestras++;
+        sumaConjunto += (double)conjuntoActivos;
+        conjuntoMaximo = conjuntoActivos > conjuntoMaximo ? conjuntoActivos : conjuntoMaximo;
+        bool sobre = sobrecarga();
+        sobrecargadas += sobre;
+        (sobre ? accesosSobrecarga : accesosNormal) += accesos;
+        (sobre ? fallosSobrecarga : fallosNormal) += fallos;
+        accesos = fallos = 0;
+        if (!param.controlar)
+            return SEGUIR;
+        if (sobre && activos > 1)
+            return SUSPENDER;
+        if (siguiente >= 0 && (activos == 0 || conjuntoActivos + siguiente <= param.bajo * numMarcos))
+            return REANUDAR;
+        if (siguiente >= 0 && param.turno > 0 && muestras - esperaDesde >= (uint64_t)param.turno)
+            return ROTAR;
+        return SEGUIR;
+    }
+
+    // Un proceso nuevo espera suspendido si ya hay otros esperando o si no entra
+    bool admitir(bool hayEspera) const { return !param.controlar || (!hayEspera && !sobrecarga()); }
+
+    // Hasta ver una ventana, el conjunto de un proceso se estima con lo más
+    // que puede tocar: sus páginas, sin pasar de tau
+    int conjuntoInicial(int paginas) const
+    {
+        int tau = param.ventana * param.ventanas;
+        return paginas < tau ? paginas : tau;
+    }
+
+    double pffSobrecarga() const { return accesosSobrecarga ? (double)fallosSobrecarga / accesosSobrecarga : 0; }
+    double pffNormal() const { return accesosNormal ? (double)fallosNormal / accesosNormal : 0; }
+    double conjuntoPromedio() const { return muestras ? sumaConjunto / muestras : 0; }
+
+    // Accesos por segundo con el modelo: cada acceso cuesta usAcceso y cada
+    // fault o página expulsada al suspender, usFallo
+    double rendimiento(uint64_t totalAccesos, uint64_t totalFallos) const
+    {
+        double us = totalAccesos * param.usAcceso + (double)(totalFallos + expulsadas) * param.usFallo;
+        return us > 0 ? totalAccesos / us * 1e6 : 0;
+    }
+
+private:
+    ParametrosConjuntoTrabajo param;
+    int numMarcos;
+    uint64_t accesos, fallos; // de la ventana global en curso
+};
+
+#endif
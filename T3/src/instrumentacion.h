@@ -0,0 +1,194 @@
+#ifndef INSTRUMENTACION_H
+#define INSTRUMENTACION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Series de tiempo de una corrida en cubetas de 'cubeta' accesos: fallos,
+// desalojos, procesos creados y finalizados, ocupación, páginas residentes
+// de cada proceso y accesos a cada marco de RAM (el mapa de calor, con los
+// marcos agrupados en 'columnas' columnas). Por acceso se suman dos
+// contadores; las residencias las lleva el simulador al mover páginas, y al
+// cerrar una cubeta se copian junto con la ocupación, sin recorrer los marcos.
+//
+// Al final se escriben PREFIJO.json con todo y tres CSV: PREFIJO_series.csv
+// (una fila por cubeta), PREFIJO_residencia.csv (cubeta, proceso, páginas)
+// y PREFIJO_marcos.csv (una fila por cubeta, una columna por grupo de marcos).
+struct ParametrosInstrumentacion
+{
+    std::string prefijo; // vacío = sin métricas
+    int cubeta = 1000;   // accesos por cubeta
+    int columnas = 64;   // del mapa de calor
+
+    bool activo() const { return !prefijo.empty(); }
+};
+
+inline bool validarInstrumentacion(const ParametrosInstrumentacion &p, std::string &error)
+{
+    if (p.cubeta <= 0 || p.columnas <= 0)
+        return error = "la cubeta y las columnas del mapa tienen que ser positivas", false;
+    return true;
+}
+
+class Instrumentacion
+{
+public:
+    struct Cubeta
+    {
+        uint64_t primerAcceso, accesos, faults, desalojos;
+        uint32_t creados, finalizados;
+        int ramOcupados, swapOcupados, activos, suspendidos;
+        uint32_t primeraResidencia, residencias; // tramo de 'residencia'
+    };
+
+    struct Residencia
+    {
+        uint32_t proceso, paginas;
+    };
+
+    Instrumentacion(const ParametrosInstrumentacion &p, int marcos)
+        : param(p), numMarcos(marcos), porColumna((marcos + p.columnas - 1) / p.columnas),
+          totalMarco(marcos, 0), actual(), totalAccesos(0)
+    {
+        columnas = (numMarcos + porColumna - 1) / porColumna;
+        mapa.assign(columnas, 0);
+    }
+
+    const ParametrosInstrumentacion &parametros() const { return param; }
+
+    // El acceso ya resuelto: 'marco' es donde quedó la página (-1 si ya no está en RAM)
+    void acceso(int marco, bool fallo)
+    {
+        actual.accesos++;
+        actual.faults += fallo;
+        if (marco >= 0)
+        {
+            mapa[mapa.size() - columnas + marco / porColumna]++;
+            totalMarco[marco]++;
+        }
+    }
+    void desalojo() { actual.desalojos++; }
+    void creado() { actual.creados++; }
+    void finalizado() { actual.finalizados++; }
+
+    bool cubetaLlena() const { return actual.accesos >= (uint64_t)param.cubeta; }
+    bool cubetaVacia() const { return actual.accesos == 0; }
+
+    // Entre cerrar() y el cierre anterior: las residencias de la cubeta
+    void residencia(uint32_t proceso, uint32_t paginas) { residencias.push_back({proceso, paginas}); }
+
+    void cerrar(int ramOcupados, int swapOcupados, int activos, int suspendidos)
+    {
+        actual.primerAcceso = totalAccesos;
+        actual.ramOcupados = ramOcupados;
+        actual.swapOcupados = swapOcupados;
+        actual.activos = activos;
+        actual.suspendidos = suspendidos;
+        actual.primeraResidencia = serie.empty() ? 0 : serie.back().primeraResidencia + serie.back().residencias;
+        actual.residencias = (uint32_t)residencias.size() - actual.primeraResidencia;
+        totalAccesos += actual.accesos;
+        serie.push_back(actual);
+        actual = Cubeta();
+        mapa.resize(mapa.size() + columnas, 0); // la fila de la cubeta siguiente
+    }
+
+    const std::vector<Cubeta> &cubetas() const { return serie; }
+
+    // Fracción de los accesos que recibió el 'fraccion' de marcos más usados
+    double concentracion(double fraccion) const
+    {
+        std::vector<uint64_t> orden(totalMarco);
+        std::sort(orden.begin(), orden.end(), [](uint64_t a, uint64_t b) { return a > b; });
+        uint64_t suma = 0, total = 0;
+        size_t n = (size_t)(orden.size() * fraccion);
+        for (size_t i = 0; i < orden.size(); i++)
+        {
+            total += orden[i];
+            if (i < n)
+                suma += orden[i];
+        }
+        return total ? (double)suma / total : 0;
+    }
+
+    // Marcos que no recibieron ningún acceso en toda la corrida
+    int marcosFrios() const { return (int)std::count(totalMarco.begin(), totalMarco.end(), 0); }
+
+    bool escribir(std::string &error) const
+    {
+        std::ofstream json(param.prefijo + ".json"), series(param.prefijo + "_series.csv"),
+            residencia(param.prefijo + "_residencia.csv"), marcos(param.prefijo + "_marcos.csv");
+        if (!json || !series || !residencia || !marcos)
+            return error = "no se pudieron crear los archivos de " + param.prefijo, false;
+
+        series << "cubeta,primer_acceso,accesos,faults,tasa_fallos,desalojos,creados,finalizados,"
+                  "ram_ocupados,swap_ocupados,activos,suspendidos\n";
+        residencia << "cubeta,proceso,paginas\n";
+        marcos << "cubeta";
+        for (int c = 0; c < columnas; c++)
+            marcos << ",marcos_" << c * porColumna;
+        marcos << "\n";
+
+        json << "{\n  \"cubeta\": " << param.cubeta << ", \"marcos\": " << numMarcos << ", \"columnas\": " << columnas
+             << ", \"marcos_por_columna\": " << porColumna << ",\n  \"series\": [";
+        for (size_t i = 0; i < serie.size(); i++)
+        {
+            const Cubeta &c = serie[i];
+            double tasa = c.accesos ? (double)c.faults / c.accesos : 0;
+            series << i << ',' << c.primerAcceso << ',' << c.accesos << ',' << c.faults << ',' << tasa << ','
+                   << c.desalojos << ',' << c.creados << ',' << c.finalizados << ',' << c.ramOcupados << ','
+                   << c.swapOcupados << ',' << c.activos << ',' << c.suspendidos << "\n";
+            json << (i ? ",\n    " : "\n    ") << "{\"primer_acceso\": " << c.primerAcceso << ", \"accesos\": " << c.accesos
+                 << ", \"faults\": " << c.faults << ", \"tasa_fallos\": " << tasa << ", \"desalojos\": " << c.desalojos
+                 << ", \"creados\": " << c.creados << ", \"finalizados\": " << c.finalizados
+                 << ", \"ram_ocupados\": " << c.ramOcupados << ", \"swap_ocupados\": " << c.swapOcupados
+                 << ", \"activos\": " << c.activos << ", \"suspendidos\": " << c.suspendidos << ", \"residencia\": {";
+            for (uint32_t r = 0; r < c.residencias; r++)
+            {
+                const Residencia &res = residencias[c.primeraResidencia + r];
+                residencia << i << ',' << res.proceso << ',' << res.paginas << "\n";
+                json << (r ? ", " : "") << '"' << res.proceso << "\": " << res.paginas;
+            }
+            json << "}}";
+
+            marcos << i;
+            for (int col = 0; col < columnas; col++)
+                marcos << ',' << mapa[i * columnas + col];
+            marcos << "\n";
+        }
+        json << "\n  ],\n  \"mapa\": [";
+        for (size_t i = 0; i < serie.size(); i++)
+        {
+            json << (i ? ",\n    [" : "\n    [");
+            for (int col = 0; col < columnas; col++)
+                json << (col ? ", " : "") << mapa[i * columnas + col];
+            json << "]";
+        }
+        json << "\n  ],\n  \"accesos_por_marco\": [";
+        for (int m = 0; m < numMarcos; m++)
+            json << (m ? (m % 32 ? ", " : ",\n    ") : "\n    ") << totalMarco[m];
+        json << "\n  ]\n}\n";
+
+        json.close();
+        series.close();
+        residencia.close();
+        marcos.close();
+        if (!json || !series || !residencia || !marcos)
+            return error = "no se pudieron escribir los archivos de " + param.prefijo, false;
+        return true;
+    }
+
+private:
+    ParametrosInstrumentacion param;
+    int numMarcos, porColumna, columnas;
+    std::vector<uint64_t> totalMarco; // de toda la corrida
+    std::vector<uint64_t> mapa;       // cubetas x columnas, más la fila de la cubeta en curso
+    std::vector<Residencia> residencias;
+    std::vector<Cubeta> serie;
+    Cubeta actual;
+    uint64_t totalAccesos;
+};
+
+#endif
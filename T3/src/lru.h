@@ -0,0 +1,89 @@
+#ifndef LRU_H
+#define LRU_H
+
+#include <vector>
+
+// Lista doblemente enlazada intrusiva sobre los marcos de RAM: cada marco
+// guarda el anterior (más viejo) y el siguiente (más nuevo), así que tocar
+// una página, sacarla o elegir la víctima es O(1).
+//
+// Las páginas que nunca se accedieron (recién creadas) forman un tramo al
+// principio, en el orden en que se colocaron; las accedidas van detrás.
+class ListaLRU
+{
+public:
+    explicit ListaLRU(int marcos = 0)
+        : ant(marcos, -1), sig(marcos, -1), enLista(marcos, 0), frio(marcos, 0),
+          menosReciente(-1), masReciente(-1), ultimoFrio(-1) {}
+
+    // Página colocada sin acceso: al final del tramo de las nunca usadas
+    void insertarFrio(int marco)
+    {
+        if (ultimoFrio == -1)
+            enlazarDespues(marco, -1);
+        else
+            enlazarDespues(marco, ultimoFrio);
+        frio[marco] = 1;
+        ultimoFrio = marco;
+    }
+
+    // Acceso (HIT o página recién traída): pasa a ser la más reciente
+    void tocar(int marco)
+    {
+        if (enLista[marco])
+        {
+            if (marco == masReciente && !frio[marco])
+                return;
+            quitar(marco);
+        }
+        enlazarDespues(marco, masReciente);
+    }
+
+    void quitar(int marco)
+    {
+        if (!enLista[marco])
+            return;
+        if (marco == ultimoFrio)
+            ultimoFrio = ant[marco];
+        frio[marco] = 0;
+
+        if (ant[marco] != -1)
+            sig[ant[marco]] = sig[marco];
+        else
+            menosReciente = sig[marco];
+        if (sig[marco] != -1)
+            ant[sig[marco]] = ant[marco];
+        else
+            masReciente = ant[marco];
+
+        ant[marco] = sig[marco] = -1;
+        enLista[marco] = 0;
+    }
+
+    // Marco de la página usada hace más tiempo, -1 si la RAM está vacía
+    int victima() const { return menosReciente; }
+
+private:
+    std::vector<int> ant, sig;
+    std::vector<char> enLista, frio;
+    int menosReciente, masReciente, ultimoFrio;
+
+    // después de 'previo' (-1 = al principio, como la más vieja)
+    void enlazarDespues(int marco, int previo)
+    {
+        int siguiente = previo == -1 ? menosReciente : sig[previo];
+        ant[marco] = previo;
+        sig[marco] = siguiente;
+        if (previo != -1)
+            sig[previo] = marco;
+        else
+            menosReciente = marco;
+        if (siguiente != -1)
+            ant[siguiente] = marco;
+        else
+            masReciente = marco;
+        enLista[marco] = 1;
+    }
+};
+
+#endif
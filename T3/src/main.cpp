@@ -1,13 +1,33 @@
 #include <iostream>
 #include <vector>
-#include <map>       // Usar map para gestionar procesos por ID
 #include <random>    // Para generación de números aleatorios
 #include <chrono>    // Para manejo de tiempo de alta resolución
 #include <thread>    // Para manejo de hilos y pausas
+#include <atomic>
+#include <cstdio>
 #include <iomanip>   // Para manipulación de salida
 #include <algorithm> // Para algoritmos como sort, find, etc.
 #include <limits>    // Para límites de tipos de datos
 #include <climits>   // Para constantes de límites de tipos de datos
+#include <memory>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include "marcos.h"    // Marcos libres de RAM y SWAP (pila + bitmap)
+#include "politicas.h" // LRU, FIFO, CLOCK, 2Q, ARC y OPT
+#include "traza.h"     // Eventos de la corrida para comparar políticas
+#include "archivo_traza.h" // Trazas de accesos (texto o binario) para el modo traza
+#include "arena.h"     // Páginas de todos los procesos en tramos contiguos
+#include "cargas.h"    // Generadores de accesos con localidad
+#include "tlb.h"         // TLB asociativo por conjuntos
+#include "respaldo.h"    // RAM en mmap y SWAP en un archivo, con E/S real por lotes
+#include "prebusqueda.h" // Prebúsqueda secuencial o por zancada en los page faults
+#include "paginas_grandes.h" // Páginas grandes junto a las normales en el modo traza
+#include "swap_comprimida.h" // Pool de páginas comprimidas entre la RAM y la SWAP
+#include "conjunto_trabajo.h" // Conjunto de trabajo por proceso y control de carga
+#include "compartidas.h"  // Fork con copy-on-write y bibliotecas compartidas
+#include "instrumentacion.h" // Series de tiempo por cubetas y mapa de calor de los marcos
+#include "concurrente.h" // Varios hilos sobre los mismos marcos (CLOCK sin locks, LRU fragmentada)
 
 using namespace std;
 
@@ -26,34 +46,174 @@ struct Pagina
 {
     int procesoId;
     int numeroPagina;
-    bool enRAM;
-    int marco;                       // marco en RAM (-1 si está en swap)
+    uint32_t fisica;                 // en 'fisicas': dónde está el contenido (RAM o SWAP)
+    uint32_t siguienteMapeo;         // otra página virtual con la misma física
     unsigned long long ultimoAcceso; // Contador de accesos en lugar de tiempo
+    uint8_t referencias;             // bits de referencia de las últimas ventanas (conjunto de trabajo)
 
-    Pagina(int pid, int numPag) : procesoId(pid), numeroPagina(numPag),
-                                  enRAM(false), marco(-1), ultimoAcceso(0) {}
+    Pagina(int pid = 0, int numPag = 0) : procesoId(pid), numeroPagina(numPag), fisica(TablaFisicas::NINGUNA),
+                                          siguienteMapeo(TablaFisicas::NINGUNA), ultimoAcceso(0), referencias(0) {}
 };
 
+static const uint32_t SIN_PAGINA = UINT32_MAX; // marco vacío en RAM o SWAP
+
 struct Proceso
 {
     int id;
     int tamanio;
     int numeroPaginas;
-    vector<Pagina *> paginas;
+    int paginasPropias;     // las primeras; después vienen las de las bibliotecas
+    uint32_t primeraPagina; // sus páginas son paginas[primeraPagina .. + numeroPaginas)
+    EstadoCarga carga;      // posición de su recorrido para el generador de accesos
+    ConjuntoProceso conjunto;
     time_t tiempoCreacion;
 
-    Proceso(int pid, int tam, int tamPagina) : id(pid), tamanio(tam),
+    Proceso(int pid, int tam, int tamPagina) : id(pid), tamanio(tam), primeraPagina(0),
                                                tiempoCreacion(time(0))
     {
         numeroPaginas = (tamanio * 1024) / tamPagina; // convertir MB a KB
         if ((tamanio * 1024) % tamPagina != 0)
             numeroPaginas++;
+        paginasPropias = numeroPaginas;
     }
 };
 
+// Resumen de la E/S real de la SWAP al final de una corrida
+static void imprimirRespaldo(MemoriaRespaldada &r, ostream &os = cout)
+{
+    r.esperar();
+    os << "E/S de SWAP: " << r.lecturas << " lecturas y " << r.escrituras << " escrituras de "
+       << r.bytesPagina() / 1024 << " KB en " << r.lotes << " lotes, " << fixed << setprecision(1)
+       << r.megabytesMovidos() << " MB en " << setprecision(3) << r.segundosIO << " s ("
+       << setprecision(1) << (r.segundosIO > 0 ? r.megabytesMovidos() / r.segundosIO : 0) << " MB/s)" << endl;
+    os << "Latencia por fault: mediana " << r.latencia(0.5) << " µs, p99 " << r.latencia(0.99) << " µs" << endl;
+    if (r.corruptas || r.erroresIO)
+        os << RED << "[ERROR] " << r.corruptas << " páginas leídas no eran las esperadas, "
+           << r.erroresIO << " errores de E/S" << RESET << endl;
+}
+
+// Resumen de la prebúsqueda al final de una corrida
+static void imprimirPrebusqueda(const Prebuscador &p, ostream &os = cout)
+{
+    os << "Prebúsqueda " << NOMBRES_PREBUSQUEDA[p.parametros().tipo] << " (ventana de " << p.parametros().ventana
+       << "): " << p.traidas << " páginas traídas, " << p.utiles << " útiles, " << p.desperdiciadas
+       << " desperdiciadas (" << fixed << setprecision(1) << p.precision() * 100 << "% de precisión), "
+       << p.pendientes() << " sin usar al final, " << p.desalojos << " desalojos para traerlas" << endl;
+}
+
+static void imprimirSwapComprimida(const SwapComprimida &z, ostream &os = cout)
+{
+    const ParametrosSwapComprimida &p = z.parametros();
+    os << "Pool comprimido: " << p.presupuestoMB << " MB, " << NOMBRES_POOL[p.politica] << ", razón " << fixed
+       << setprecision(1) << p.razon << " modelada; al final " << z.paginasEnPool() << " páginas en "
+       << setprecision(2) << z.bytesUsados() / (1024.0 * 1024.0) << " MB (razón " << z.razonActual() << ")" << endl;
+    os << "Faults con datos: " << z.aciertos << " del pool y " << z.fallos << " de la SWAP (" << setprecision(1)
+       << z.tasaAciertos() * 100 << "% de aciertos del pool); " << z.nuevas << " de páginas nuevas" << endl;
+    os << "Desalojos: " << z.guardadas << " comprimidas, " << z.rechazadas << " incompresibles directo a la SWAP, "
+       << z.devueltas << " devueltas del pool a la SWAP; " << z.lecturasSwap << " lecturas y " << z.escriturasSwap
+       << " escrituras en la SWAP" << endl;
+    os << "Tiempo modelado: " << setprecision(2) << (z.aciertos ? z.usAciertos / z.aciertos : 0) << " µs por fault del pool, "
+       << (z.fallos ? z.usFallos / z.fallos : 0) << " µs por fault de la SWAP, " << z.usPorFallo() << " µs en promedio; "
+       << z.usTotal() / 1000 << " ms en total (sin el pool y con los mismos desalojos: " << z.usSinPool() / 1000 << " ms)" << endl;
+}
+
+static void imprimirConjuntoTrabajo(const ControlCarga &c, uint64_t accesos, uint64_t faults, int esperando,
+                                    int sinCorrer, ostream &os = cout)
+{
+    const ParametrosConjuntoTrabajo &p = c.parametros();
+    os << "Conjunto de trabajo (ventanas de " << p.ventana << " accesos, tau = " << p.ventana * p.ventanas
+       << "): " << fixed << setprecision(0) << c.conjuntoPromedio() << " páginas en promedio entre los activos, "
+       << c.conjuntoMaximo << " como máximo" << endl;
+    os << "Sobrecarga: " << c.sobrecargadas << " de " << c.muestras << " muestras con el conjunto por encima de la RAM; "
+       << setprecision(2) << c.pffSobrecarga() * 100 << "% de fallos en ellas y " << c.pffNormal() * 100 << "% en el resto" << endl;
+    if (p.controlar)
+        os << "Control de carga: " << c.suspensiones << " suspensiones (" << c.expulsadas << " páginas a SWAP), "
+           << c.reanudaciones << " reanudaciones (" << c.turnos << " por turno), " << c.enEspera
+           << " procesos creados en espera; al final esperan " << esperando << ", " << sinCorrer
+           << " sin haber corrido nunca" << endl;
+    os << "Rendimiento modelado: " << setprecision(0) << c.rendimiento(accesos, faults) << " accesos/s ("
+       << setprecision(1) << p.usAcceso << " µs por acceso, " << p.usFallo << " µs por fault o página expulsada)" << endl;
+}
+
+// Huella con fork y bibliotecas: 'ocupados' son los marcos de RAM (la suma
+// de los PSS) y 'privadas' las residentes con un solo mapeo (la de los USS)
+static void imprimirCompartir(const TablaFisicas &t, const ParametrosCompartir &p, int procesos, int ocupados,
+                              uint64_t privadas, ostream &os = cout)
+{
+    os << "Compartir (fork " << fixed << setprecision(2) << p.fork << ", " << setprecision(0) << p.escrituras * 100 << "% de escrituras, "
+       << p.bibliotecas << " bibliotecas de " << p.bibliotecaMB << " MB): " << t.forks << " forks, " << t.copias
+       << " copias por escritura (" << t.copiasConFallo << " con fault del original), " << t.bibliotecasCargadas
+       << " páginas de bibliotecas cargadas" << endl;
+    os << "Huella: " << t.mapeos << " páginas virtuales sobre " << t.vivas() << " físicas (" << t.compartidas
+       << " compartidas); sin compartir harían falta " << t.mapeos - t.vivas() << " marcos más" << endl;
+    double n = procesos ? procesos : 1;
+    os << "En RAM: RSS sumado " << t.rss << " páginas, PSS sumado " << ocupados << ", USS sumado " << privadas
+       << "; por proceso RSS " << setprecision(1) << t.rss / n << ", PSS " << ocupados / n << ", USS " << privadas / n << endl;
+}
+
+static void imprimirInstrumentacion(const Instrumentacion &m, ostream &os = cout)
+{
+    const vector<Instrumentacion::Cubeta> &serie = m.cubetas();
+    size_t peor = 0;
+    double minima = 1, maxima = 0;
+    for (size_t i = 0; i < serie.size(); i++)
+    {
+        double tasa = serie[i].accesos ? (double)serie[i].faults / serie[i].accesos : 0;
+        minima = min(minima, tasa);
+        if (tasa > maxima)
+            maxima = tasa, peor = i;
+    }
+    os << "Métricas: " << serie.size() << " cubetas de " << m.parametros().cubeta << " accesos; tasa de fallos de "
+       << fixed << setprecision(1) << (serie.empty() ? 0 : minima) * 100 << "% a " << maxima * 100
+       << "% (la más alta en la cubeta " << peor << ")" << endl;
+    os << "Mapa de marcos: el 10% más usado recibió el " << m.concentracion(0.1) * 100 << "% de los accesos; "
+       << m.marcosFrios() << " marcos sin ningún acceso" << endl;
+}
+
+// Resumen de las páginas grandes al final de una corrida en el modo traza
+static void imprimirPaginasGrandes(const RAMMixta &ram, const ParametrosPaginasGrandes &p, ostream &os = cout)
+{
+    os << "Páginas grandes (" << NOMBRES_GRANDES[p.modo] << ", " << p.paginaGrandeKB << " KB = " << ram.marcosPorGrande()
+       << " páginas" << (p.degradar ? ", se degradan" : "") << "): " << ram.grandesCreadas << " creadas, "
+       << ram.promociones << " por promoción, " << ram.degradaciones << " degradaciones, " << ram.grandesEnRAM()
+       << " en RAM al final" << endl;
+    os << "Compactación: " << ram.compactaciones << " bloques armados moviendo " << ram.migradas
+       << " páginas; fragmentación " << fixed << setprecision(1) << ram.fragmentacionPromedio() * 100
+       << "% en promedio al pedir un bloque, " << ram.fragmentacionActual() * 100 << "% al final" << endl;
+    os << "Subpáginas: " << ram.rellenadas << " rellenadas sin pedirlas, " << ram.liberadasSinUso
+       << " soltadas sin uso al degradar; " << ram.usoGrandes() * 100 << "% usadas en las grandes que quedan" << endl;
+    os << "E/S de SWAP: " << ram.paginasLeidas << " páginas leídas y " << ram.paginasEscritas << " escritas" << endl;
+}
+
+// Cadena JSON entre comillas; los nombres del simulador no traen caracteres de control
+static string textoJSON(const string &texto)
+{
+    string r = "\"";
+    for (char c : texto)
+    {
+        if (c == '"' || c == '\\')
+            r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
+// Resumen del TLB al final de una corrida
+static void imprimirTLB(const TLB &tlb, ostream &os = cout)
+{
+    os << "TLB: " << tlb.aciertos << " aciertos, " << tlb.fallos << " fallos (" << fixed << setprecision(2)
+       << tlb.tasaAciertos() * 100 << "% de aciertos), " << tlb.vaciados << " vaciados, "
+       << tlb.invalidaciones << " invalidaciones" << endl;
+    os << "Costo de traducción: " << setprecision(2) << tlb.ciclosPorTraduccion() << " ciclos por acceso ("
+       << tlb.parametros().ciclosAcierto << " por acierto, " << tlb.parametros().ciclosRecorrido
+       << " más por recorrido)" << endl;
+}
+
 class SimuladorPaginacion
 {
 private:
+    ostream &salida; // cout, o un flujo sin búfer que descarta todo
+
     int memoriaFisicaMB;
     int memoriaFisicaKB;
     int memoriaVirtualKB;
@@ -63,22 +223,66 @@ private:
     int minTamProceso;
     int maxTamProceso;
 
-    vector<Pagina *> RAM;
-    vector<Pagina *> SWAP;
-    map<int, Proceso *> procesos;
+    vector<uint32_t> RAM;  // índice en 'fisicas' de la página de cada marco
+    vector<uint32_t> SWAP;
+    ArenaRangos<Pagina> paginas;
+    TablaFisicas fisicas;  // una por página, salvo las compartidas por fork o bibliotecas
+    vector<Proceso> procesos; // denso: se elige uno al azar en O(1)
+    unique_ptr<Politica> politica; // decide la víctima entre los marcos ocupados de RAM
+    AsignadorMarcos libresRAM;
+    AsignadorMarcos libresSWAP;
 
     int contadorProcesos;
     int pageFaults;
+    uint64_t accesos;
     unsigned long long contadorReloj; // Contador global para LRU preciso
 
-    random_device rd;
+    // Para el resumen en JSON
+    ParametrosCarga cargaElegida;
+    uint64_t semilla;
+    int pasosEjecutados;
+    const char *motivoFin; // "pasos", "memoria" o "error"
+    double segundos;
+    vector<ResultadoPolitica> comparacion;
+
+    bool registrarEventos; // para compararPoliticas() al final
+    vector<EventoMemoria> eventos;
+
     mt19937 gen;
+    GeneradorCarga generador; // qué página de un proceso se accede
+    unique_ptr<TLB> tlb;      // nullptr si se pidió --tlb 0
+    unique_ptr<MemoriaRespaldada> respaldo; // bytes reales de RAM y SWAP (--swap-real)
+    unique_ptr<Prebuscador> prebuscador;    // nullptr sin --prebusqueda o con --comparar
+    unique_ptr<SwapComprimida> zswap;       // nullptr sin --zswap
+    unique_ptr<ControlCarga> control;       // nullptr sin --conjunto-trabajo ni --control-carga
+    vector<Proceso> suspendidos;            // por orden de suspensión; no se acceden ni se finalizan
+    ParametrosCompartir compartir;
+    int paginasBiblioteca;
+    vector<vector<uint32_t>> bibliotecas;   // física de cada página (SIN_PAGINA si no está cargada)
+    unique_ptr<Instrumentacion> metricas;   // nullptr sin --metricas
+    vector<int> residentesPorProceso;       // páginas en RAM de cada proceso por id, con métricas
+    vector<uint64_t> candidatas;
 
 public:
-    SimuladorPaginacion(int memFisica, int tamPag, int minProc, int maxProc)
-        : memoriaFisicaMB(memFisica), tamanioPagina(tamPag),
+    // Lo que el barrido toma de cada corrida
+    struct Resumen
+    {
+        uint64_t accesos, faults;
+        int pasos, procesos;
+        double segundos;
+        const char *fin;
+    };
+
+    SimuladorPaginacion(int memFisica, int tamPag, int minProc, int maxProc,
+                        const string &nombrePolitica, bool comparar, const ParametrosCarga &carga,
+                        const ParametrosTLB &paramTLB, const ParametrosPrebusqueda &paramPre,
+                        const ParametrosSwapComprimida &paramZ, const ParametrosConjuntoTrabajo &paramWS,
+                        const ParametrosCompartir &paramComp, uint64_t semillaSim, ostream &os = cout)
+        : salida(os), memoriaFisicaMB(memFisica), tamanioPagina(tamPag),
           minTamProceso(minProc), maxTamProceso(maxProc),
-          contadorProcesos(0), pageFaults(0), contadorReloj(0), gen(rd())
+          contadorProcesos(0), pageFaults(0), accesos(0), contadorReloj(0),
+          cargaElegida(carga), semilla(semillaSim), pasosEjecutados(0), motivoFin("pasos"), segundos(0),
+          registrarEventos(comparar), gen((mt19937::result_type)semillaSim), generador(carga, gen()), compartir(paramComp)
     {
 
         //  Parte 1: Configurar memoria física y virtual -----------------------
@@ -91,292 +295,416 @@ public:
         double factor = dist(gen);
         memoriaVirtualKB = (int)(memoriaFisicaKB * factor);
 
-        numMarcosRAM = memoriaFisicaKB / tamanioPagina;
+        // el pool comprimido sale de la RAM; sus páginas conservan el marco de SWAP, como en zswap
+        numMarcosRAM = (memoriaFisicaKB - paramZ.presupuestoMB * 1024) / tamanioPagina;
         numMarcosSwap = (memoriaVirtualKB - memoriaFisicaKB) / tamanioPagina;
 
-        RAM.resize(numMarcosRAM, nullptr);
-        SWAP.resize(numMarcosSwap, nullptr);
-
-        cout << BOLD << CYAN << "\n========== CONFIGURACIÓN DEL SISTEMA ==========" << RESET << endl;
-        cout << GREEN << "Memoria Física: " << RESET << memoriaFisicaMB << " MB (" << memoriaFisicaKB << " KB)" << endl;
-        cout << BLUE << "Memoria Virtual: " << RESET << (memoriaVirtualKB / 1024) << " MB (" << memoriaVirtualKB << " KB)" << endl;
-        cout << "Tamaño de Página: " << tamanioPagina << " KB" << endl;
-        cout << GREEN << "Marcos en RAM: " << RESET << numMarcosRAM << endl;
-        cout << BLUE << "Marcos en SWAP: " << RESET << numMarcosSwap << endl;
-        cout << "Rango de tamaño de procesos: " << minTamProceso << "-" << maxTamProceso << " MB" << endl;
-        cout << YELLOW << "Política de reemplazo: LRU (Least Recently Used)" << RESET << endl;
-        cout << BOLD << CYAN << "===============================================\n" << RESET << endl;
+        RAM.resize(numMarcosRAM, SIN_PAGINA);
+        SWAP.resize(numMarcosSwap, SIN_PAGINA);
+        politica = crearPolitica(nombrePolitica, numMarcosRAM);
+        libresRAM = AsignadorMarcos(numMarcosRAM);
+        libresSWAP = AsignadorMarcos(numMarcosSwap);
+        if (paramTLB.entradas > 0)
+            tlb.reset(new TLB(paramTLB));
+        // la comparación repite los eventos sin prebúsqueda: con ella no coincidirían
+        if (paramPre.tipo != PREBUSQUEDA_NO && !comparar)
+            prebuscador.reset(new Prebuscador(paramPre));
+        if (paramZ.presupuestoMB > 0)
+            zswap.reset(new SwapComprimida(paramZ, (uint64_t)tamanioPagina * 1024));
+        if (paramWS.activo())
+            control.reset(new ControlCarga(paramWS, numMarcosRAM));
+        paginasBiblioteca = (compartir.bibliotecaMB * 1024 + tamanioPagina - 1) / tamanioPagina;
+        bibliotecas.assign(compartir.bibliotecas, vector<uint32_t>(paginasBiblioteca, SIN_PAGINA));
+
+        salida << BOLD << CYAN << "\n========== CONFIGURACIÓN DEL SISTEMA ==========" << RESET << '\n';
+        salida << GREEN << "Memoria Física: " << RESET << memoriaFisicaMB << " MB (" << memoriaFisicaKB << " KB)" << '\n';
+        salida << BLUE << "Memoria Virtual: " << RESET << (memoriaVirtualKB / 1024) << " MB (" << memoriaVirtualKB << " KB)" << '\n';
+        salida << "Tamaño de Página: " << tamanioPagina << " KB" << '\n';
+        salida << GREEN << "Marcos en RAM: " << RESET << numMarcosRAM << '\n';
+        salida << BLUE << "Marcos en SWAP: " << RESET << numMarcosSwap << '\n';
+        salida << "Rango de tamaño de procesos: " << minTamProceso << "-" << maxTamProceso << " MB" << '\n';
+        salida << YELLOW << "Política de reemplazo: " << politica->descripcion() << RESET << '\n';
+        salida << "Carga de accesos: " << describirCarga(carga) << '\n';
+        salida << "TLB: " << (tlb ? describirTLB(paramTLB, tamanioPagina) : "no") << '\n';
+        salida << "Semilla: " << semilla << '\n';
+        if (paramPre.tipo != PREBUSQUEDA_NO)
+            salida << "Prebúsqueda: " << (prebuscador ? NOMBRES_PREBUSQUEDA[paramPre.tipo] : "solo sin --comparar")
+                   << " (ventana de " << paramPre.ventana << ")" << '\n';
+        if (zswap)
+            salida << "Pool comprimido: " << paramZ.presupuestoMB << " MB de la RAM (" << NOMBRES_POOL[paramZ.politica]
+                   << ", razón " << fixed << setprecision(1) << paramZ.razon << ")" << '\n';
+        if (control)
+            salida << "Conjunto de trabajo: ventanas de " << paramWS.ventana << " accesos, tau = "
+                   << paramWS.ventana * paramWS.ventanas << (paramWS.controlar ? ", con control de carga" : "") << '\n';
+        if (compartir.activo())
+            salida << "Compartir: fork con probabilidad " << fixed << setprecision(2) << compartir.fork << ", " << setprecision(0)
+                   << compartir.escrituras * 100 << "% de escrituras, " << compartir.bibliotecas << " bibliotecas de " << compartir.bibliotecaMB << " MB ("
+                   << paginasBiblioteca << " páginas) en cada proceso" << '\n';
+        salida << BOLD << CYAN << "===============================================\n" << RESET << '\n';
     }
 
-    ~SimuladorPaginacion() // DESTRUIIIRRRRRRRRRR RAHHHH
+    // RAM en mmap y SWAP en un archivo; antes de crear procesos
+    bool abrirRespaldo(const ParametrosRespaldo &p, string &error)
     {
-        for (auto &par : procesos)
+        respaldo.reset(new MemoriaRespaldada());
+        if (!respaldo->abrir(numMarcosRAM, (uint64_t)tamanioPagina * 1024, p, error))
         {
-            for (auto pagina : par.second->paginas)
-            {
-                delete pagina;
-            }
-            delete par.second;
+            respaldo.reset();
+            return false;
         }
+        salida << "SWAP real: " << p.rutaSwap << " (" << p.hilos << " hilos de E/S, lotes de " << p.lote
+               << (p.directo ? ", O_DIRECT" : "") << ")\n" << '\n';
+        return true;
+    }
+
+    // Series de tiempo y mapa de calor; antes de crear procesos
+    void instrumentar(const ParametrosInstrumentacion &p)
+    {
+        metricas.reset(new Instrumentacion(p, numMarcosRAM));
+        salida << "Métricas: cubetas de " << p.cubeta << " accesos, mapa de " << p.columnas << " columnas, en "
+               << p.prefijo << ".json y " << p.prefijo << "_*.csv\n" << '\n';
+    }
+
+    bool escribirMetricas(string &error) const
+    {
+        return metricas->escribir(error);
     }
 
     // Parte 2: Gestión de procesos y páginas
     
     bool crearProceso()
     {
+        // Con --fork, a veces el proceso nuevo es hijo de uno activo y nace con sus mismas páginas
+        int padre = -1;
+        if (compartir.fork > 0 && !procesos.empty() && uniform_real_distribution<>(0, 1)(gen) < compartir.fork)
+            padre = uniform_int_distribution<>(0, procesos.size() - 1)(gen);
+
         uniform_int_distribution<> dist(minTamProceso, maxTamProceso);
-        int tamanio = dist(gen);
+        int tamanio = padre >= 0 ? procesos[padre].tamanio : dist(gen);
 
         contadorProcesos++;
-        Proceso *proc = new Proceso(contadorProcesos, tamanio, tamanioPagina);
+        Proceso proc(contadorProcesos, tamanio, tamanioPagina);
+        if (metricas)
+            residentesPorProceso.resize(contadorProcesos + 1, 0);
+        proc.numeroPaginas += compartir.bibliotecas * paginasBiblioteca;
+        proc.primeraPagina = paginas.reservar(proc.numeroPaginas);
+
+        salida << GREEN << "[CREAR] " << RESET << "Proceso " << proc.id << " creado. Tamaño: "
+               << proc.tamanio << " MB, Páginas: " << proc.numeroPaginas << '\n';
+
+        // Con control de carga, si no entra espera suspendido y sus páginas van a SWAP
+        bool admitido = !control || control->admitir(!suspendidos.empty());
+        if (control)
+        {
+            proc.conjunto.paginas = control->conjuntoInicial(proc.numeroPaginas);
+            proc.conjunto.muestra = control->muestras;
+            proc.conjunto.corrio = admitido;
+        }
 
-        cout << GREEN << "[CREAR] " << RESET << "Proceso " << proc->id << " creado. Tamaño: "
-             << proc->tamanio << " MB, Páginas: " << proc->numeroPaginas << endl;
+        if (padre >= 0)
+        {
+            // copy-on-write: el hijo mapea las físicas del padre y no ocupa marcos
+            const Proceso &p = procesos[padre];
+            for (int i = 0; i < proc.numeroPaginas; i++)
+            {
+                const Pagina &original = paginas[p.primeraPagina + i];
+                Pagina &pag = paginas[proc.primeraPagina + i];
+                pag = Pagina(proc.id, i);
+                pag.referencias = original.referencias;
+                mapear(proc.primeraPagina + i, original.fisica);
+            }
+            proc.carga = p.carga;
+            if (control)
+                proc.conjunto.paginas = p.conjunto.paginas;
+            fisicas.forks++;
+            salida << GREEN << "[FORK] " << RESET << "Proceso " << proc.id << " es hijo del " << p.id
+                   << ": comparte sus " << proc.numeroPaginas << " páginas hasta que las escriba" << '\n';
+        }
 
         // Intentar asignar páginas
         int paginasEnRAM = 0;
         int paginasEnSwap = 0;
+        int deBibliotecas = 0;
 
-        for (int i = 0; i < proc->numeroPaginas; i++)
+        for (int i = padre >= 0 ? proc.numeroPaginas : 0; i < proc.numeroPaginas; i++)
         {
-            Pagina *pag = new Pagina(proc->id, i);
-            proc->paginas.push_back(pag);
+            uint32_t indice = proc.primeraPagina + i;
+            paginas[indice] = Pagina(proc.id, i);
+
+            // las páginas de una biblioteca ya cargada solo se mapean
+            int biblioteca = -1, numero = i;
+            if (i >= proc.paginasPropias)
+            {
+                biblioteca = (i - proc.paginasPropias) / paginasBiblioteca;
+                numero = (i - proc.paginasPropias) % paginasBiblioteca;
+                if (bibliotecas[biblioteca][numero] != SIN_PAGINA)
+                {
+                    mapear(indice, bibliotecas[biblioteca][numero]);
+                    deBibliotecas++;
+                    continue;
+                }
+            }
+            uint32_t f = fisicas.crear(biblioteca >= 0 ? claveBiblioteca(biblioteca, numero) : clavePagina(proc.id, i));
+            uint64_t clave = fisicas[f].clave;
+            registrar(EV_COLOCAR, f);
 
             // Intentar colocar en RAM primero
-            int marcoLibre = buscarMarcoLibre(RAM);
+            int marcoLibre = admitido ? libresRAM.tomar() : -1;
             if (marcoLibre != -1)
             {
-                RAM[marcoLibre] = pag;
-                pag->enRAM = true;
-                pag->marco = marcoLibre;
+                RAM[marcoLibre] = f;
+                fisicas.ponerEnRAM(f, marcoLibre);
+                politica->colocar(marcoLibre, clave);
+                if (respaldo)
+                    respaldo->fallo(marcoLibre, -1, -1, clave);
                 paginasEnRAM++;
             }
             else
             {
                 // Colocar en SWAP
-                int marcoSwap = buscarMarcoLibre(SWAP);
+                int marcoSwap = libresSWAP.tomar();
                 if (marcoSwap != -1)
                 {
-                    SWAP[marcoSwap] = pag;
-                    pag->enRAM = false;
-                    pag->marco = marcoSwap;
+                    SWAP[marcoSwap] = f;
+                    fisicas.ponerEnSwap(f, marcoSwap);
+                    if (respaldo)
+                        respaldo->escribirSwap(marcoSwap, clave);
                     paginasEnSwap++;
                 }
                 else
                 {
-                    cout << RED << "\n[ERROR] No hay memoria disponible (RAM ni SWAP). Finalizando simulación..." << RESET << endl;
+                    salida << RED << "\n[ERROR] No hay memoria disponible (RAM ni SWAP). Finalizando simulación..." << RESET << '\n';
 
                     // Limpiar correctamente las páginas ya asignadas
+                    fisicas.liberar(f);
                     for (int j = 0; j < i; j++)
-                    {
-                        Pagina *p = proc->paginas[j];
-                        if (p->enRAM)
-                        {
-                            RAM[p->marco] = nullptr;
-                        }
-                        else
-                        {
-                            SWAP[p->marco] = nullptr;
-                        }
-                        delete p;
-                    }
-                    delete pag;
-                    delete proc;
+                        liberarPagina(proc.primeraPagina + j);
+                    paginas.liberar(proc.primeraPagina, proc.numeroPaginas);
                     return false;
                 }
             }
+            mapear(indice, f);
+            if (biblioteca >= 0)
+            {
+                bibliotecas[biblioteca][numero] = f;
+                fisicas.bibliotecasCargadas++;
+            }
         }
 
         if (paginasEnSwap > 0)
         {
-            cout << YELLOW << "   → " << paginasEnRAM << " páginas en RAM, "
-                 << paginasEnSwap << " páginas en SWAP" << RESET << endl;
+            salida << YELLOW << "   → " << paginasEnRAM << " páginas en RAM, "
+                   << paginasEnSwap << " páginas en SWAP" << RESET << '\n';
         }
+        if (deBibliotecas > 0)
+            salida << "   → " << deBibliotecas << " páginas de bibliotecas ya cargadas por otros procesos" << '\n';
 
-        procesos[proc->id] = proc;
+        if (admitido)
+        {
+            procesos.push_back(proc);
+            if (control)
+                control->conjuntoActivos += proc.conjunto.paginas;
+        }
+        else
+        {
+            suspendidos.push_back(proc);
+            control->enEspera++;
+            salida << MAGENTA << "[CARGA] " << RESET << "Proceso " << proc.id << " en espera: los conjuntos de trabajo ya llenan la RAM" << '\n';
+        }
+        if (metricas)
+            metricas->creado();
         mostrarEstadoMemoria();
         return true;
     }
 
     // Finaliza un proceso aleatorio
 
-    void finalizarProcesoAleatorio() 
+    void finalizarProcesoAleatorio()
     {
         if (procesos.empty())
             return;
 
         uniform_int_distribution<> dist(0, procesos.size() - 1);
-        auto it = procesos.begin();
-        advance(it, dist(gen));
-
-        int pid = it->first;
-        Proceso *proc = it->second;
-
-        cout << MAGENTA << "\n[FINALIZAR] " << RESET << "Proceso " << pid << " finalizando..." << endl;
-
-        // Liberar todas las páginas del proceso
-        for (auto pagina : proc->paginas)
-        {
-            if (pagina->enRAM)
-            {
-                RAM[pagina->marco] = nullptr;
-            }
-            else
-            {
-                SWAP[pagina->marco] = nullptr;
-            }
-            delete pagina;
-        }
-
-        delete proc;
-        procesos.erase(pid);
-
-        cout << MAGENTA << "[FINALIZAR] " << RESET << "Proceso " << pid << " finalizado. Memoria liberada." << endl;
+        size_t elegido = dist(gen);
+        Proceso proc = procesos[elegido];
+        int pid = proc.id;
+
+        salida << MAGENTA << "\n[FINALIZAR] " << RESET << "Proceso " << pid << " finalizando..." << '\n';
+
+        // Liberar todas las páginas del proceso y su tramo de la arena
+        for (int i = 0; i < proc.numeroPaginas; i++)
+            liberarPagina(proc.primeraPagina + i);
+        paginas.liberar(proc.primeraPagina, proc.numeroPaginas);
+        if (prebuscador)
+            prebuscador->olvidarProceso(pid);
+        if (control)
+            control->conjuntoActivos -= proc.conjunto.paginas;
+
+        // el último proceso pasa a ocupar su lugar: O(1)
+        procesos[elegido] = procesos.back();
+        procesos.pop_back();
+        if (metricas)
+            metricas->finalizado();
+
+        salida << MAGENTA << "[FINALIZAR] " << RESET << "Proceso " << pid << " finalizado. Memoria liberada." << '\n';
         mostrarEstadoMemoria();
     }
 
     void accederDireccionVirtual()
     {
+        if (procesos.empty() && !suspendidos.empty())
+            reanudarProceso();
         if (procesos.empty())
         {
-            cout << YELLOW << "\n[ACCESO] No hay procesos activos para acceder." << RESET << endl;
+            salida << YELLOW << "\n[ACCESO] No hay procesos activos para acceder." << RESET << '\n';
             return;
         }
 
         // Seleccionar proceso aleatorio
         uniform_int_distribution<> distProc(0, procesos.size() - 1);
-        auto it = procesos.begin();
-        advance(it, distProc(gen));
-        Proceso *proc = it->second;
+        Proceso &proc = procesos[distProc(gen)];
+
+        // La página la elige el generador según la carga (por defecto, uniforme)
+        int numPagina = generador.siguiente(proc.numeroPaginas, proc.carga);
+        // las bibliotecas son de solo lectura
+        bool escritura = compartir.escrituras > 0 && uniform_real_distribution<>(0, 1)(gen) < compartir.escrituras &&
+                         numPagina < proc.paginasPropias;
 
-        // Generar número de página aleatorio
-        uniform_int_distribution<> distPag(0, proc->numeroPaginas - 1);
-        int numPagina = distPag(gen);
+        int direccionVirtual = (proc.id * 10000) + (numPagina * tamanioPagina);
 
-        int direccionVirtual = (proc->id * 10000) + (numPagina * tamanioPagina);
+        salida << CYAN << "\n[ACCESO] " << RESET << "Accediendo a dirección virtual: " << BOLD << direccionVirtual << RESET
+               << " (Proceso " << proc.id << ", Página " << numPagina << (escritura ? ", escritura" : "") << ")" << '\n';
 
-        cout << CYAN << "\n[ACCESO] " << RESET << "Accediendo a dirección virtual: " << BOLD << direccionVirtual << RESET
-             << " (Proceso " << proc->id << ", Página " << numPagina << ")" << endl;
+        uint32_t indice = proc.primeraPagina + numPagina;
+        Pagina &pagina = paginas[indice];
+        registrar(EV_ACCESO, pagina.fisica);
+        accesos++;
 
-        Pagina *pagina = proc->paginas[numPagina];
+        // Primero la traducción: un acierto del TLB evita recorrer la tabla
+        if (tlb)
+        {
+            if (tlb->traducir(clavePagina(pagina.procesoId, pagina.numeroPagina)))
+                salida << GREEN << "[TLB] Traducción encontrada en el TLB." << RESET << '\n';
+            else
+                salida << YELLOW << "[TLB] Fallo de TLB: se recorre la tabla de páginas." << RESET << '\n';
+        }
 
-        if (pagina->enRAM)
+        pagina.referencias |= 1;
+        PaginaFisica &fisica = fisicas[pagina.fisica];
+        bool fallo = !fisica.enRAM;
+        if (fisica.enRAM)
         {
-            cout << GREEN << "[ACCESO] Página encontrada en RAM (Marco " << pagina->marco << "). HIT!" << RESET << endl;
-            pagina->ultimoAcceso = ++contadorReloj; // Actualizar con contador
+            salida << GREEN << "[ACCESO] Página encontrada en RAM (Marco " << fisica.marco << "). HIT!" << RESET << '\n';
+            pagina.ultimoAcceso = ++contadorReloj; // Actualizar con contador
+            politica->acceder(fisica.marco);
+            if (fisica.prebuscada)
+            {
+                // la prebúsqueda acertó: se sigue adelantando al proceso
+                salida << GREEN << "[PREBÚSQUEDA] La página había sido prebuscada." << RESET << '\n';
+                fisica.prebuscada = false;
+                prebuscador->utiles++;
+                prebuscar(proc, numPagina);
+            }
         }
         else
         {
-            cout << RED << "[ACCESO] Página NO encontrada en RAM. PAGE FAULT!" << RESET << endl;
+            salida << RED << "[ACCESO] Página NO encontrada en RAM. PAGE FAULT!" << RESET << '\n';
             pageFaults++;
 
-            // IMPORTANTE: Guardar el marco SWAP de la página entrante ANTES de buscar espacio
-            int marcoSwapOrigen = pagina->marco;
-
-            // Buscar marco libre en RAM
-            int marcoLibre = buscarMarcoLibre(RAM);
+            bool desalojo = traerPagina(pagina.fisica, true);
+            pagina.ultimoAcceso = ++contadorReloj; // Actualizar con contador
 
-            if (marcoLibre == -1)
+            if (respaldo)
             {
-                // No hay marco libre - Aplicar política LRU
-                cout << YELLOW << "[SWAP] No hay marcos libres. Aplicando política LRU..." << RESET << endl;
-                marcoLibre = aplicarLRU();
-
-                if (marcoLibre == -1)
-                {
-                    cout << RED << "[ERROR] LRU no pudo encontrar marco víctima. Finalizando..." << RESET << endl;
-                    throw runtime_error("LRU falló");
-                }
-
-                Pagina *paginaVictima = RAM[marcoLibre];
-
-                cout << YELLOW << "[SWAP] Víctima seleccionada: Proceso " << paginaVictima->procesoId
-                     << ", Página " << paginaVictima->numeroPagina << " (menos recientemente usada)" << RESET << endl;
-
-                // CORRECCIÓN CRÍTICA: Liberar primero el espacio de la página entrante en SWAP
-                SWAP[marcoSwapOrigen] = nullptr;
-
-                // Ahora buscar espacio para la víctima (encontrará al menos el hueco que dejamos)
-                int marcoSwap = buscarMarcoLibre(SWAP);
-                if (marcoSwap == -1)
-                {
-                    cout << RED << "[ERROR] No hay espacio en SWAP después de liberar. Finalizando..." << RESET << endl;
-                    throw runtime_error("Sin espacio en SWAP");
-                }
-
-                SWAP[marcoSwap] = paginaVictima;
-                paginaVictima->enRAM = false;
-                paginaVictima->marco = marcoSwap;
-
-                cout << BLUE << "[SWAP] Página víctima movida a SWAP (Marco " << marcoSwap << ")" << RESET << endl;
-            }
-            else
-            {
-                cout << GREEN << "[SWAP] Marco libre encontrado (Marco " << marcoLibre << "). No se requiere reemplazo." << RESET << endl;
-                // Liberar el marco SWAP de la página entrante
-                SWAP[marcoSwapOrigen] = nullptr;
+                respaldo->esperar();
+                salida << BLUE << "[E/S] " << (desalojo ? "Escritura y lectura" : "Lectura")
+                       << " en la SWAP real: " << fixed << setprecision(1) << respaldo->latencias.back() << " µs" << RESET << '\n';
             }
-
-            // Traer página a RAM
-            RAM[marcoLibre] = pagina;
-            pagina->enRAM = true;
-            pagina->marco = marcoLibre;
-            pagina->ultimoAcceso = ++contadorReloj; // Actualizar con contador
-
-            cout << BLUE << "[SWAP] Página solicitada cargada en RAM (Marco " << marcoLibre << ")" << RESET << endl;
+            if (prebuscador)
+                prebuscar(proc, numPagina);
+        }
+        if (escritura && fisica.mapeos > 1)
+        {
+            fisicas.copiasConFallo += fallo;
+            copiarAlEscribir(indice);
         }
+        if (metricas)
+        {
+            // la prebúsqueda pudo haber desalojado a la página recién traída
+            const PaginaFisica &destino = fisicas[pagina.fisica];
+            metricas->acceso(destino.enRAM ? destino.marco : -1, fallo);
+            if (metricas->cubetaLlena())
+                cerrarCubeta();
+        }
+        // al final: suspender o reanudar cambia 'procesos' y 'proc' deja de valer
+        if (control)
+            contarConjunto(proc, fallo);
     }
 
     void mostrarEstadoMemoria()
     {
-        int paginasEnRAM = 0, paginasEnSwap = 0;
-
-        for (auto pag : RAM)
+        // los asignadores llevan la cuenta: no hace falta recorrer RAM y SWAP
+        int paginasEnRAM = libresRAM.ocupados(), paginasEnSwap = libresSWAP.ocupados();
+
+        salida << "\n--- Estado de Memoria ---" << '\n';
+        salida << "Procesos activos: " << procesos.size() << '\n';
+        salida << GREEN << "RAM: " << RESET << paginasEnRAM << "/" << numMarcosRAM << " marcos ocupados ("
+               << fixed << setprecision(1) << (paginasEnRAM * 100.0 / numMarcosRAM) << "%)" << '\n';
+        salida << BLUE << "SWAP: " << RESET << paginasEnSwap << "/" << numMarcosSwap << " marcos ocupados ("
+               << fixed << setprecision(1) << (paginasEnSwap * 100.0 / numMarcosSwap) << "%)" << '\n';
+        if (zswap)
+            salida << "Pool comprimido: " << zswap->paginasEnPool() << " páginas en " << setprecision(2)
+                   << zswap->bytesUsados() / (1024.0 * 1024.0) << "/" << zswap->parametros().presupuestoMB << " MB" << '\n';
+        if (control)
         {
-            if (pag != nullptr)
-                paginasEnRAM++;
-        }
-
-        for (auto pag : SWAP)
-        {
-            if (pag != nullptr)
-                paginasEnSwap++;
+            double pff = 0;
+            for (const Proceso &p : procesos)
+                pff += p.conjunto.pff;
+            salida << "Conjunto de trabajo de los activos: " << control->conjuntoActivos << " páginas de " << numMarcosRAM
+                   << " marcos (PFF promedio " << setprecision(1) << (procesos.empty() ? 0 : pff / procesos.size() * 100)
+                   << "%); " << suspendidos.size() << " procesos suspendidos" << '\n';
         }
-
-        cout << "\n--- Estado de Memoria ---" << endl;
-        cout << "Procesos activos: " << procesos.size() << endl;
-        cout << GREEN << "RAM: " << RESET << paginasEnRAM << "/" << numMarcosRAM << " marcos ocupados ("
-             << fixed << setprecision(1) << (paginasEnRAM * 100.0 / numMarcosRAM) << "%)" << endl;
-        cout << BLUE << "SWAP: " << RESET << paginasEnSwap << "/" << numMarcosSwap << " marcos ocupados ("
-             << fixed << setprecision(1) << (paginasEnSwap * 100.0 / numMarcosSwap) << "%)" << endl;
-        cout << "Page Faults totales: " << pageFaults << endl;
-        cout << "-------------------------\n"
-             << endl;
+        if (compartir.activo())
+            salida << "Compartidas: " << fisicas.mapeos << " páginas virtuales sobre " << fisicas.vivas() << " físicas ("
+                   << fisicas.compartidas << " compartidas); RSS sumado " << fisicas.rss << " páginas en "
+                   << paginasEnRAM << " marcos" << '\n';
+        salida << "Page Faults totales: " << pageFaults << '\n';
+        salida << "-------------------------\n\n";
     }
 
-    void ejecutarSimulacion()
+    // Con 'pasos' = 0 cada paso es un segundo real y se sigue hasta quedarse
+    // sin memoria. Con 'pasos' > 0 no hay pausas: el paso hace de segundo y
+    // se corren a lo sumo 'pasos' pasos. 'accesosPorPaso' suma accesos a los
+    // del calendario original (uno cada 5 pasos desde el 30).
+    void ejecutarSimulacion(int pasos = 0, int accesosPorPaso = 0)
     {
-        cout << BOLD << GREEN << "\n========== INICIANDO SIMULACIÓN ==========" << RESET << endl;
+        salida << BOLD << GREEN << "\n========== INICIANDO SIMULACIÓN ==========" << RESET << '\n';
         auto inicio = chrono::steady_clock::now();
+        motivoFin = "pasos";
 
         try
         {
-            while (true)
+            for (int paso = 0; pasos == 0 || paso < pasos; paso++)
             {
                 auto ahora = chrono::steady_clock::now();
-                auto duracion = chrono::duration_cast<chrono::seconds>(ahora - inicio).count();
+                auto duracion = pasos ? paso : chrono::duration_cast<chrono::seconds>(ahora - inicio).count();
+                pasosEjecutados = paso + 1;
 
-                cout << BOLD << "\n>>> Tiempo transcurrido: " << duracion << " segundos <<<" << RESET << endl;
+                salida << BOLD << "\n>>> Tiempo transcurrido: " << duracion << " segundos <<<" << RESET << '\n';
 
                 // Crear proceso cada 2 segundos
                 if (duracion % 2 == 0)
                 {
                     if (!crearProceso())
                     {
+                        motivoFin = "memoria";
                         break;
                     }
                 }
 
+                for (int k = 0; k < accesosPorPaso; k++)
+                    accederDireccionVirtual();
+
                 // A partir de los 30 segundos
                 if (duracion >= 30)
                 {
@@ -384,90 +712,1456 @@ public:
                     if (duracion % 5 == 0)
                     {
                         finalizarProcesoAleatorio();
-                        this_thread::sleep_for(chrono::milliseconds(500));
+                        if (!pasos)
+                        {
+                            salida.flush();
+                            this_thread::sleep_for(chrono::milliseconds(500));
+                        }
                         accederDireccionVirtual();
                     }
                 }
 
-                this_thread::sleep_for(chrono::seconds(1));
+                if (!pasos)
+                {
+                    salida.flush();
+                    this_thread::sleep_for(chrono::seconds(1));
+                }
             }
         }
         catch (const exception &e)
         {
-            cout << RED << "\n[ERROR] " << e.what() << RESET << endl;
+            salida << RED << "\n[ERROR] " << e.what() << RESET << '\n';
+            motivoFin = "error";
         }
+        segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (metricas && !metricas->cubetaVacia())
+            cerrarCubeta();
 
-        cout << BOLD << RED << "\n========== SIMULACIÓN FINALIZADA ==========" << RESET << endl;
+        salida << BOLD << RED << "\n========== SIMULACIÓN FINALIZADA ==========" << RESET << '\n';
         mostrarEstadoMemoria();
-        cout << "\nEstadísticas finales:" << endl;
-        cout << "Total de procesos creados: " << contadorProcesos << endl;
-        cout << "Total de page faults: " << pageFaults << endl;
-        cout << "===========================================" << endl;
+        salida << "\nEstadísticas finales:" << '\n';
+        salida << "Total de procesos creados: " << contadorProcesos << '\n';
+        salida << "Total de accesos: " << accesos << '\n';
+        salida << "Total de page faults: " << pageFaults << '\n';
+        if (tlb)
+            imprimirTLB(*tlb, salida);
+        if (respaldo)
+            imprimirRespaldo(*respaldo, salida);
+        if (prebuscador)
+            imprimirPrebusqueda(*prebuscador, salida);
+        if (zswap)
+            imprimirSwapComprimida(*zswap, salida);
+        if (control)
+        {
+            int sinCorrer = 0;
+            for (const Proceso &p : suspendidos)
+                sinCorrer += !p.conjunto.corrio;
+            imprimirConjuntoTrabajo(*control, accesos, pageFaults, (int)suspendidos.size(), sinCorrer, salida);
+        }
+        if (compartir.activo())
+            imprimirCompartir(fisicas, compartir, procesos.size() + suspendidos.size(), libresRAM.ocupados(),
+                              privadasEnRAM(), salida);
+        if (metricas)
+            imprimirInstrumentacion(*metricas, salida);
+        salida << "===========================================" << '\n';
+
+        if (registrarEventos)
+        {
+            salida << BOLD << CYAN << "\n========== COMPARACIÓN DE POLÍTICAS ==========" << RESET << '\n';
+            salida << "Mismos " << eventos.size() << " eventos repetidos con cada política sobre "
+                   << numMarcosRAM << " marcos de RAM:" << '\n';
+            salida.flush();
+            comparacion = compararPoliticas(eventos, numMarcosRAM);
+            imprimirComparacion(comparacion, salida);
+            salida << "==============================================" << '\n';
+        }
+    }
+
+    Resumen resumen() const
+    {
+        return {accesos, (uint64_t)pageFaults, pasosEjecutados, contadorProcesos, segundos, motivoFin};
+    }
+
+    // Resumen de la corrida en JSON, para barridos de configuraciones
+    void escribirJSON(ostream &salida)
+    {
+        ostringstream os; // formato propio, sin heredar 'fixed' de la salida
+        os << "{\n  \"configuracion\": {\"memoria_fisica_mb\": " << memoriaFisicaMB
+           << ", \"memoria_virtual_kb\": " << memoriaVirtualKB << ", \"pagina_kb\": " << tamanioPagina
+           << ", \"marcos_ram\": " << numMarcosRAM << ", \"marcos_swap\": " << numMarcosSwap
+           << ", \"proceso_min_mb\": " << minTamProceso << ", \"proceso_max_mb\": " << maxTamProceso
+           << ", \"politica\": " << textoJSON(politica->nombre()) << ", \"carga\": " << textoJSON(describirCarga(cargaElegida))
+           << ", \"semilla\": " << semilla << "},\n";
+        os << "  \"resultado\": {\"fin\": " << textoJSON(motivoFin) << ", \"pasos\": " << pasosEjecutados
+           << ", \"segundos\": " << segundos << ", \"procesos_creados\": " << contadorProcesos
+           << ", \"procesos_activos\": " << procesos.size() << ", \"accesos\": " << accesos
+           << ", \"page_faults\": " << pageFaults << ", \"tasa_aciertos\": " << (accesos ? 1.0 - (double)pageFaults / accesos : 0.0)
+           << ", \"ram_ocupados\": " << libresRAM.ocupados() << ", \"swap_ocupados\": " << libresSWAP.ocupados() << "}";
+        if (tlb)
+            os << ",\n  \"tlb\": {\"entradas\": " << tlb->parametros().entradas << ", \"vias\": " << tlb->parametros().vias
+               << ", \"aciertos\": " << tlb->aciertos << ", \"fallos\": " << tlb->fallos << ", \"vaciados\": " << tlb->vaciados
+               << ", \"invalidaciones\": " << tlb->invalidaciones << ", \"ciclos_por_traduccion\": " << tlb->ciclosPorTraduccion() << "}";
+        if (respaldo)
+        {
+            respaldo->esperar();
+            os << ",\n  \"swap_real\": {\"lecturas\": " << respaldo->lecturas << ", \"escrituras\": " << respaldo->escrituras
+               << ", \"lotes\": " << respaldo->lotes << ", \"megabytes\": " << respaldo->megabytesMovidos()
+               << ", \"segundos_io\": " << respaldo->segundosIO << ", \"latencia_mediana_us\": " << respaldo->latencia(0.5)
+               << ", \"latencia_p99_us\": " << respaldo->latencia(0.99) << ", \"corruptas\": " << respaldo->corruptas
+               << ", \"errores_io\": " << respaldo->erroresIO << "}";
+        }
+        if (prebuscador)
+            os << ",\n  \"prebusqueda\": {\"tipo\": " << textoJSON(NOMBRES_PREBUSQUEDA[prebuscador->parametros().tipo])
+               << ", \"ventana\": " << prebuscador->parametros().ventana << ", \"traidas\": " << prebuscador->traidas
+               << ", \"utiles\": " << prebuscador->utiles << ", \"desperdiciadas\": " << prebuscador->desperdiciadas
+               << ", \"desalojos\": " << prebuscador->desalojos << "}";
+        if (zswap)
+            os << ",\n  \"swap_comprimida\": {\"presupuesto_mb\": " << zswap->parametros().presupuestoMB
+               << ", \"politica\": " << textoJSON(NOMBRES_POOL[zswap->parametros().politica])
+               << ", \"razon_modelo\": " << zswap->parametros().razon << ", \"aciertos\": " << zswap->aciertos
+               << ", \"fallos\": " << zswap->fallos << ", \"nuevas\": " << zswap->nuevas << ", \"guardadas\": " << zswap->guardadas
+               << ", \"rechazadas\": " << zswap->rechazadas << ", \"devueltas\": " << zswap->devueltas
+               << ", \"lecturas_swap\": " << zswap->lecturasSwap << ", \"escrituras_swap\": " << zswap->escriturasSwap
+               << ", \"paginas_en_pool\": " << zswap->paginasEnPool() << ", \"bytes_en_pool\": " << zswap->bytesUsados()
+               << ", \"us_por_fallo\": " << zswap->usPorFallo() << ", \"us_total\": " << zswap->usTotal()
+               << ", \"us_sin_pool\": " << zswap->usSinPool() << "}";
+        if (control)
+            os << ",\n  \"conjunto_trabajo\": {\"ventana\": " << control->parametros().ventana
+               << ", \"ventanas\": " << control->parametros().ventanas << ", \"control\": "
+               << (control->parametros().controlar ? "true" : "false") << ", \"promedio\": " << control->conjuntoPromedio()
+               << ", \"maximo\": " << control->conjuntoMaximo << ", \"muestras\": " << control->muestras
+               << ", \"sobrecargadas\": " << control->sobrecargadas << ", \"pff_sobrecarga\": " << control->pffSobrecarga()
+               << ", \"pff_normal\": " << control->pffNormal() << ", \"suspensiones\": " << control->suspensiones
+               << ", \"reanudaciones\": " << control->reanudaciones << ", \"turnos\": " << control->turnos
+               << ", \"en_espera\": " << control->enEspera
+               << ", \"expulsadas\": " << control->expulsadas << ", \"suspendidos\": " << suspendidos.size()
+               << ", \"rendimiento\": " << control->rendimiento(accesos, pageFaults) << "}";
+        if (compartir.activo())
+            os << ",\n  \"compartir\": {\"fork\": " << compartir.fork << ", \"escrituras\": " << compartir.escrituras
+               << ", \"bibliotecas\": " << compartir.bibliotecas << ", \"biblioteca_mb\": " << compartir.bibliotecaMB
+               << ", \"forks\": " << fisicas.forks << ", \"copias\": " << fisicas.copias
+               << ", \"copias_con_fallo\": " << fisicas.copiasConFallo << ", \"paginas_bibliotecas\": " << fisicas.bibliotecasCargadas
+               << ", \"paginas_virtuales\": " << fisicas.mapeos << ", \"paginas_fisicas\": " << fisicas.vivas()
+               << ", \"compartidas\": " << fisicas.compartidas << ", \"rss\": " << fisicas.rss
+               << ", \"pss\": " << libresRAM.ocupados() << ", \"uss\": " << privadasEnRAM() << "}";
+        if (!comparacion.empty())
+        {
+            os << ",\n  \"comparacion\": [";
+            for (size_t i = 0; i < comparacion.size(); i++)
+                os << (i ? ",\n    " : "\n    ") << "{\"politica\": " << textoJSON(comparacion[i].nombre)
+                   << ", \"accesos\": " << comparacion[i].accesos << ", \"faults\": " << comparacion[i].faults
+                   << ", \"desalojos\": " << comparacion[i].desalojos << ", \"segundos\": " << comparacion[i].segundos << "}";
+            os << "\n  ]";
+        }
+        os << "\n}\n";
+        salida << os.str() << flush;
     }
 
 private:
-    int buscarMarcoLibre(vector<Pagina *> &memoria)
+    // Trae a RAM una página física que está en SWAP, desalojando una víctima
+    // si no hay marco libre. 'detalle' imprime cada paso (las prebuscadas se
+    // resumen en una línea). true si hubo desalojo.
+    bool traerPagina(uint32_t f, bool detalle)
+    {
+        uint64_t clave = fisicas[f].clave;
+
+        // IMPORTANTE: Guardar el marco SWAP de la página entrante ANTES de buscar espacio
+        int marcoSwapOrigen = fisicas[f].marco;
+        // con pool comprimido la entrante sale primero de él, y deja lugar para la víctima
+        SwapComprimida::Origen origen = SwapComprimida::ORIGEN_SWAP;
+        if (zswap)
+            origen = zswap->traer(clave);
+
+        int marcoSwapVictima = -1;
+        int marcoLibre = marcoParaEntrar(clave, marcoSwapOrigen, detalle, marcoSwapVictima);
+
+        // Traer página a RAM
+        RAM[marcoLibre] = f;
+        fisicas.ponerEnRAM(f, marcoLibre);
+        contarResidentes(f, 1);
+        politica->cargar(marcoLibre, clave);
+        if (respaldo)
+            respaldo->fallo(marcoLibre, marcoSwapVictima, marcoSwapOrigen, clave);
+
+        if (detalle && origen == SwapComprimida::ORIGEN_POOL)
+            salida << BLUE << "[ZSWAP] Página solicitada descomprimida desde el pool a RAM (Marco " << marcoLibre << ")"
+                   << RESET << '\n';
+        else if (detalle)
+            salida << BLUE << "[SWAP] Página solicitada cargada en RAM (Marco " << marcoLibre << ")" << RESET << '\n';
+        return marcoSwapVictima != -1;
+    }
+
+    // Marco de RAM para la página 'clave', que deja libre su marco de SWAP
+    // 'marcoSwapOrigen' (-1 si no tiene). Si hay que desalojar, la víctima
+    // queda en 'marcoSwapVictima'.
+    int marcoParaEntrar(uint64_t clave, int marcoSwapOrigen, bool detalle, int &marcoSwapVictima)
     {
-        for (size_t i = 0; i < memoria.size(); i++)
+        // Buscar marco libre en RAM
+        int marcoLibre = libresRAM.tomar();
+
+        if (marcoLibre == -1)
         {
-            if (memoria[i] == nullptr)
+            // No hay marco libre - Aplicar la política de reemplazo
+            if (detalle)
+                salida << YELLOW << "[SWAP] No hay marcos libres. Aplicando política " << politica->nombre() << "..." << RESET << '\n';
+            marcoLibre = elegirVictima(clave);
+
+            if (marcoLibre == -1)
+            {
+                salida << RED << "[ERROR] " << politica->nombre() << " no pudo encontrar marco víctima. Finalizando..." << RESET << '\n';
+                throw runtime_error(string(politica->nombre()) + " falló");
+            }
+
+            uint32_t victima = RAM[marcoLibre];
+            PaginaFisica &paginaVictima = fisicas[victima];
+
+            if (detalle)
             {
-                return i;
+                const Pagina &mapeo = paginas[paginaVictima.primerMapeo];
+                salida << YELLOW << "[SWAP] Víctima seleccionada: Proceso " << mapeo.procesoId << ", Página " << mapeo.numeroPagina;
+                if (paginaVictima.mapeos > 1)
+                    salida << " (compartida por " << paginaVictima.mapeos << " procesos)";
+                salida << " (elegida por " << politica->nombre() << ")" << RESET << '\n';
             }
+
+            // CORRECCIÓN CRÍTICA: Liberar primero el espacio de la página entrante en SWAP
+            if (marcoSwapOrigen != -1)
+            {
+                SWAP[marcoSwapOrigen] = SIN_PAGINA;
+                libresSWAP.liberar(marcoSwapOrigen);
+            }
+
+            // Ahora buscar espacio para la víctima (encontrará al menos el hueco que dejamos)
+            int marcoSwap = libresSWAP.tomar();
+            if (marcoSwap == -1)
+            {
+                salida << RED << "[ERROR] No hay espacio en SWAP después de liberar. Finalizando..." << RESET << '\n';
+                throw runtime_error("Sin espacio en SWAP");
+            }
+
+            SWAP[marcoSwap] = victima;
+            fisicas.ponerEnSwap(victima, marcoSwap);
+            marcoSwapVictima = marcoSwap;
+            contarResidentes(victima, -1);
+            if (metricas)
+                metricas->desalojo();
+            invalidarMapeos(victima);
+            if (paginaVictima.prebuscada)
+            {
+                paginaVictima.prebuscada = false;
+                prebuscador->desperdiciadas++;
+            }
+
+            uint64_t comprimida = 0, devueltas = zswap ? zswap->devueltas : 0;
+            if (zswap)
+                comprimida = zswap->guardar(paginaVictima.clave);
+            if (detalle && comprimida)
+                salida << BLUE << "[ZSWAP] Página víctima comprimida a " << comprimida << " bytes en el pool (conserva el marco "
+                       << marcoSwap << " de SWAP)" << RESET << '\n';
+            else if (detalle)
+                salida << BLUE << "[SWAP] Página víctima movida a SWAP (Marco " << marcoSwap << ")" << RESET << '\n';
+            if (detalle && zswap && zswap->devueltas > devueltas)
+                salida << BLUE << "[ZSWAP] " << zswap->devueltas - devueltas << " páginas devueltas del pool a la SWAP"
+                       << RESET << '\n';
+        }
+        else
+        {
+            if (detalle)
+                salida << GREEN << "[SWAP] Marco libre encontrado (Marco " << marcoLibre << "). No se requiere reemplazo." << RESET << '\n';
+            // Liberar el marco SWAP de la página entrante
+            if (marcoSwapOrigen != -1)
+            {
+                SWAP[marcoSwapOrigen] = SIN_PAGINA;
+                libresSWAP.liberar(marcoSwapOrigen);
+            }
+        }
+        return marcoLibre;
+    }
+
+    // Escritura sobre una física que el proceso comparte desde un fork: se
+    // queda con una copia propia en otro marco de RAM y los demás siguen con
+    // la original
+    void copiarAlEscribir(uint32_t indice)
+    {
+        uint32_t copia = fisicas.crear(fisicas.claveCopia());
+        uint64_t clave = fisicas[copia].clave;
+        // el acceso ya quedó registrado sobre la original
+        registrar(EV_COPIA, copia);
+
+        int marcoSwapVictima = -1;
+        int marco = marcoParaEntrar(clave, -1, true, marcoSwapVictima);
+        RAM[marco] = copia;
+        fisicas.ponerEnRAM(copia, marco);
+        politica->cargar(marco, clave);
+        if (respaldo)
+            respaldo->fallo(marco, marcoSwapVictima, -1, clave);
+
+        Pagina &pag = paginas[indice];
+        uint32_t original = pag.fisica;
+        desmapear(indice);
+        mapear(indice, copia);
+        // la traducción del que escribió ahora apunta a otro marco
+        if (tlb)
+            tlb->invalidar(clavePagina(pag.procesoId, pag.numeroPagina));
+        salida << MAGENTA << "[COW] " << RESET << "Copia privada en el marco " << marco << "; la original queda con "
+               << fisicas[original].mapeos << (fisicas[original].mapeos == 1 ? " proceso" : " procesos") << '\n';
+    }
+
+    // Las páginas virtuales de una física se encadenan por siguienteMapeo
+    void mapear(uint32_t indice, uint32_t f)
+    {
+        Pagina &pag = paginas[indice];
+        pag.fisica = f;
+        pag.siguienteMapeo = fisicas[f].primerMapeo;
+        fisicas[f].primerMapeo = indice;
+        fisicas.sumarMapeo(f);
+        if (metricas && fisicas[f].enRAM)
+            residentesPorProceso[pag.procesoId]++;
+    }
+
+    void desmapear(uint32_t indice)
+    {
+        Pagina &pag = paginas[indice];
+        uint32_t *enlace = &fisicas[pag.fisica].primerMapeo;
+        while (*enlace != indice)
+            enlace = &paginas[*enlace].siguienteMapeo;
+        *enlace = pag.siguienteMapeo;
+        fisicas.restarMapeo(pag.fisica);
+        if (metricas && fisicas[pag.fisica].enRAM)
+            residentesPorProceso[pag.procesoId]--;
+        pag.fisica = pag.siguienteMapeo = TablaFisicas::NINGUNA;
+    }
+
+    // Una física dejó la RAM: ningún proceso que la mapea puede seguir traduciéndola
+    void invalidarMapeos(uint32_t f)
+    {
+        if (!tlb)
+            return;
+        for (uint32_t i = fisicas[f].primerMapeo; i != TablaFisicas::NINGUNA; i = paginas[i].siguienteMapeo)
+            tlb->invalidar(clavePagina(paginas[i].procesoId, paginas[i].numeroPagina));
+    }
+
+    // Con métricas, cada proceso que mapea 'f' gana o pierde una página en RAM
+    void contarResidentes(uint32_t f, int cambio)
+    {
+        if (!metricas)
+            return;
+        for (uint32_t i = fisicas[f].primerMapeo; i != TablaFisicas::NINGUNA; i = paginas[i].siguienteMapeo)
+            residentesPorProceso[paginas[i].procesoId] += cambio;
+    }
+
+    // Cierra la cubeta de métricas con las páginas residentes de cada proceso
+    // (su RSS: una compartida cuenta para todos los que la mapean)
+    void cerrarCubeta()
+    {
+        for (const Proceso &p : procesos)
+            if (residentesPorProceso[p.id])
+                metricas->residencia(p.id, residentesPorProceso[p.id]);
+        for (const Proceso &p : suspendidos)
+            if (residentesPorProceso[p.id])
+                metricas->residencia(p.id, residentesPorProceso[p.id]);
+        metricas->cerrar(libresRAM.ocupados(), libresSWAP.ocupados(), (int)procesos.size(), (int)suspendidos.size());
+    }
+
+    // Residentes con un solo mapeo: la suma de los USS
+    uint64_t privadasEnRAM() const
+    {
+        uint64_t privadas = 0;
+        for (uint32_t f : RAM)
+            privadas += f != SIN_PAGINA && fisicas[f].mapeos == 1;
+        return privadas;
+    }
+
+    // Después de un fault o del primer uso de una prebuscada: trae las
+    // candidatas del prebuscador que existen y no están en RAM
+    void prebuscar(const Proceso &proc, int numPagina)
+    {
+        prebuscador->observar(proc.id, numPagina, candidatas);
+        int traidas = 0, desalojos = 0;
+        for (uint64_t c : candidatas)
+        {
+            if (c >= (uint64_t)proc.numeroPaginas)
+                break;
+            uint32_t f = paginas[proc.primeraPagina + (uint32_t)c].fisica;
+            if (fisicas[f].enRAM)
+                continue;
+            bool desalojo = traerPagina(f, false);
+            desalojos += desalojo;
+            prebuscador->desalojos += desalojo;
+            fisicas[f].prebuscada = true;
+            prebuscador->traidas++;
+            traidas++;
         }
-        return -1;
+        if (traidas == 0)
+            return;
+        if (respaldo)
+            respaldo->esperar(); // un solo lote para toda la ventana
+        salida << CYAN << "[PREBÚSQUEDA] " << RESET << traidas << " páginas traídas después de la "
+               << numPagina << " (" << desalojos << " desalojos)" << '\n';
     }
 
-    int aplicarLRU()
+    // Cuenta el acceso en el conjunto de trabajo del proceso y, cada tanto,
+    // deja decidir al control de carga
+    void contarConjunto(Proceso &proc, bool fallo)
     {
-        // Encuentra la página con el acceso más antiguo
-        int marcoVictima = -1;
-        unsigned long long tiempoMasAntiguo = ULLONG_MAX;
+        const ParametrosConjuntoTrabajo &p = control->parametros();
+        ConjuntoProceso &c = proc.conjunto;
+        c.accesos++;
+        c.fallos += fallo;
+        if (c.accesos >= p.ventana)
+        {
+            int enConjunto = 0;
+            for (int i = 0; i < proc.numeroPaginas; i++)
+                enConjunto += cerrarVentanaPagina(paginas[proc.primeraPagina + i].referencias, p.ventanas);
+            control->conjuntoActivos += enConjunto - c.paginas;
+            c.paginas = enConjunto;
+            c.pff = (double)c.fallos / c.accesos;
+            c.accesos = c.fallos = 0;
+        }
+        ControlCarga::Decision d = control->acceso(fallo, (int)procesos.size(),
+                                                   suspendidos.empty() ? -1 : suspendidos.front().conjunto.paginas,
+                                                   suspendidos.empty() ? 0 : suspendidos.front().conjunto.muestra);
+        if (d == ControlCarga::SUSPENDER)
+            suspenderProceso(false);
+        else if (d == ControlCarga::REANUDAR)
+            reanudarProceso();
+        else if (d == ControlCarga::ROTAR && suspenderProceso(true))
+        {
+            // el suspendido queda al final: vuelve primero el que esperaba
+            control->turnos++;
+            reanudarProceso();
+        }
+    }
 
-        for (size_t i = 0; i < RAM.size(); i++)
+    // El activo más nuevo (o, por turno, el que lleva más tiempo en RAM) deja
+    // la RAM y pasa al final de la espera; las páginas que comparte con otros
+    // procesos se quedan. false si no hubo lugar en SWAP
+    bool suspenderProceso(bool porTurno)
+    {
+        size_t elegido = 0;
+        for (size_t i = 1; i < procesos.size(); i++)
+        {
+            const Proceso &p = procesos[i], &e = procesos[elegido];
+            if (porTurno ? p.conjunto.muestra < e.conjunto.muestra : p.id > e.id)
+                elegido = i;
+        }
+        Proceso proc = procesos[elegido];
+        int residentes = 0;
+        for (int i = 0; i < proc.numeroPaginas; i++)
+            residentes += privadaEnRAM(proc.primeraPagina + i);
+        if (residentes > libresSWAP.libres())
         {
-            if (RAM[i] != nullptr && RAM[i]->ultimoAcceso < tiempoMasAntiguo)
+            salida << YELLOW << "[CARGA] No hay lugar en SWAP para suspender al proceso " << proc.id << RESET << '\n';
+            return false;
+        }
+        for (int i = 0; i < proc.numeroPaginas; i++)
+            if (privadaEnRAM(proc.primeraPagina + i))
+                expulsarPagina(paginas[proc.primeraPagina + i].fisica);
+        if (respaldo)
+            respaldo->esperar();
+        control->conjuntoActivos -= proc.conjunto.paginas;
+        control->suspensiones++;
+        control->expulsadas += residentes;
+        procesos[elegido] = procesos.back();
+        procesos.pop_back();
+        proc.conjunto.muestra = control->muestras;
+        suspendidos.push_back(proc);
+        salida << MAGENTA << "[CARGA] " << RESET << "Proceso " << proc.id << " suspendido: " << residentes
+               << " páginas a SWAP (conjunto de trabajo de los activos: " << control->conjuntoActivos << " páginas)" << '\n';
+        return true;
+    }
+
+    // El suspendido más viejo vuelve; sus páginas se traen por demanda
+    void reanudarProceso()
+    {
+        Proceso proc = suspendidos.front();
+        suspendidos.erase(suspendidos.begin());
+        proc.conjunto.muestra = control->muestras;
+        proc.conjunto.corrio = true;
+        procesos.push_back(proc);
+        control->conjuntoActivos += proc.conjunto.paginas;
+        control->reanudaciones++;
+        salida << MAGENTA << "[CARGA] " << RESET << "Proceso " << proc.id << " reanudado (conjunto de trabajo estimado: "
+               << proc.conjunto.paginas << " páginas)" << '\n';
+    }
+
+    bool privadaEnRAM(uint32_t indice) const
+    {
+        const PaginaFisica &f = fisicas[paginas[indice].fisica];
+        return f.enRAM && f.mapeos == 1;
+    }
+
+    // Una página en RAM pasa a SWAP sin que entre otra; hay marco de SWAP libre
+    void expulsarPagina(uint32_t f)
+    {
+        PaginaFisica &pag = fisicas[f];
+        uint64_t clave = pag.clave;
+        int marcoSwap = libresSWAP.tomar();
+        politica->quitar(pag.marco);
+        RAM[pag.marco] = SIN_PAGINA;
+        libresRAM.liberar(pag.marco);
+        if (respaldo)
+            respaldo->fallo(pag.marco, marcoSwap, -1, clave);
+        if (zswap)
+            zswap->guardar(clave);
+        invalidarMapeos(f);
+        if (pag.prebuscada)
+        {
+            pag.prebuscada = false;
+            prebuscador->desperdiciadas++;
+        }
+        SWAP[marcoSwap] = f;
+        fisicas.ponerEnSwap(f, marcoSwap);
+        contarResidentes(f, -1);
+        if (metricas)
+            metricas->desalojo();
+    }
+
+    // Marco víctima para traer 'entrante'; ya sale de la política
+    int elegirVictima(uint64_t entrante)
+    {
+        return politica->desalojar(entrante);
+    }
+
+    // Un proceso que se va suelta una página; el marco (de RAM o SWAP) se
+    // devuelve cuando ningún otro proceso la mapea
+    void liberarPagina(uint32_t indice)
+    {
+        const Pagina &pagVirtual = paginas[indice];
+        if (tlb)
+            tlb->invalidar(clavePagina(pagVirtual.procesoId, pagVirtual.numeroPagina));
+        uint32_t f = pagVirtual.fisica;
+        desmapear(indice);
+        PaginaFisica &pag = fisicas[f];
+        if (pag.mapeos > 0)
+            return;
+        registrar(EV_LIBERAR, f);
+        if (pag.enRAM)
+        {
+            if (pag.prebuscada)
+                prebuscador->desperdiciadas++;
+            RAM[pag.marco] = SIN_PAGINA;
+            libresRAM.liberar(pag.marco);
+            politica->quitar(pag.marco);
+        }
+        else
+        {
+            SWAP[pag.marco] = SIN_PAGINA;
+            libresSWAP.liberar(pag.marco);
+            if (zswap)
+                zswap->olvidar(pag.clave);
+        }
+        int biblioteca = bibliotecaDe(pag.clave);
+        if (biblioteca >= 0)
+            bibliotecas[biblioteca][pag.clave & ((1ull << 40) - 1)] = SIN_PAGINA;
+        fisicas.liberar(f);
+    }
+
+    void registrar(TipoEvento tipo, uint32_t f)
+    {
+        if (registrarEventos)
+            eventos.push_back({fisicas[f].clave, (uint8_t)tipo});
+    }
+};
+
+// Genera una traza binaria sintética: 'procesos' procesos de 'tamProcesoMB'
+// que se turnan en ráfagas; cada ráfaga es un lote del generador
+static int generarTraza(const string &ruta, const ParametrosCarga &carga, uint64_t accesos, int procesos,
+                        int tamProcesoMB, int paginaKB, int rafaga, uint64_t semilla)
+{
+    uint32_t paginasPorProceso = (uint32_t)((uint64_t)tamProcesoMB * 1024 / paginaKB);
+    uint64_t bytesPagina = (uint64_t)paginaKB * 1024;
+    if (procesos <= 0 || paginasPorProceso == 0 || rafaga <= 0)
+    {
+        cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
+        return 1;
+    }
+
+    EscritorTraza salida;
+    string error;
+    if (!salida.abrir(ruta, error))
+    {
+        cout << RED << "[ERROR] " << error << RESET << endl;
+        return 1;
+    }
+
+    GeneradorCarga generador(carga, semilla);
+    vector<EstadoCarga> estados(procesos);
+    vector<uint32_t> lote(rafaga);
+    mt19937_64 genProceso(semilla ^ 0x9e3779b97f4a7c15ull);
+
+    auto inicio = chrono::steady_clock::now();
+    for (uint64_t hechos = 0; hechos < accesos;)
+    {
+        int p = (int)(genProceso() % procesos);
+        size_t n = (size_t)min<uint64_t>(rafaga, accesos - hechos);
+        generador.generar(paginasPorProceso, estados[p], lote.data(), n);
+        for (size_t i = 0; i < n; i++)
+            salida.agregar(p + 1, lote[i] * bytesPagina);
+        hechos += n;
+    }
+    if (!salida.cerrar(error))
+    {
+        cout << RED << "[ERROR] " << error << RESET << endl;
+        return 1;
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    cout << GREEN << "[TRAZA] " << RESET << accesos << " accesos escritos en " << ruta << endl;
+    cout << "Carga: " << describirCarga(carga) << ", " << procesos << " procesos de " << tamProcesoMB
+         << " MB (" << paginasPorProceso << " páginas de " << paginaKB << " KB), ráfagas de " << rafaga << endl;
+    cout << "Tiempo: " << fixed << setprecision(3) << segundos << " s ("
+         << setprecision(1) << (segundos > 0 ? accesos / segundos / 1e6 : 0) << " millones de accesos/s)" << endl;
+    return 0;
+}
+
+// Modo traza: pasa un archivo de accesos por la RAM simulada a toda
+// velocidad, sin pausas ni salida por acceso, y resume al final
+static int ejecutarModoTraza(const string &ruta, int ramMB, int paginaKB, const string &nombrePolitica,
+                             bool comparar, const string &rutaBinaria, const ParametrosTLB &paramTLB,
+                             const ParametrosRespaldo &paramRespaldo, const ParametrosPrebusqueda &paramPre,
+                             const ParametrosPaginasGrandes &paramGrandes, const ParametrosSwapComprimida &paramZ)
+{
+    ArchivoTraza traza;
+    string error;
+    if (!traza.abrir(ruta, error))
+    {
+        cout << RED << "[ERROR] " << error << RESET << endl;
+        return 1;
+    }
+
+    if (!rutaBinaria.empty())
+    {
+        uint64_t escritos = 0;
+        if (!escribirTrazaBinaria(traza, rutaBinaria, escritos, error))
+        {
+            cout << RED << "[ERROR] " << error << RESET << endl;
+            return 1;
+        }
+        cout << GREEN << "[TRAZA] " << RESET << escritos << " accesos escritos en " << rutaBinaria << endl;
+        return 0;
+    }
+
+    int marcos = (int)((long long)ramMB * 1024 / paginaKB);
+    uint64_t bytesPagina = (uint64_t)paginaKB * 1024;
+    if (marcos <= 0)
+    {
+        cout << RED << "[ERROR] La RAM no alcanza para un marco." << RESET << endl;
+        return 1;
+    }
+
+    cout << BOLD << CYAN << "========== MODO TRAZA ==========" << RESET << endl;
+    cout << "Traza: " << ruta << (traza.esBinaria() ? " (binaria)" : " (texto)") << endl;
+    cout << GREEN << "RAM: " << RESET << ramMB << " MB, páginas de " << paginaKB << " KB → " << marcos << " marcos" << endl;
+    // el TLB no depende mucho de la política: se simula solo sin --comparar
+    unique_ptr<TLB> tlb;
+    if (paramTLB.entradas > 0 && !comparar)
+        tlb.reset(new TLB(paramTLB));
+    cout << "TLB: " << (tlb ? describirTLB(paramTLB, paginaKB) : paramTLB.entradas > 0 ? "solo sin --comparar" : "no") << endl;
+    // igual con la SWAP real: se mide con una sola política
+    unique_ptr<MemoriaRespaldada> respaldo;
+    if (!paramRespaldo.rutaSwap.empty() && !comparar)
+    {
+        respaldo.reset(new MemoriaRespaldada());
+        if (!respaldo->abrir(marcos, bytesPagina, paramRespaldo, error))
+        {
+            cout << RED << "[ERROR] " << error << RESET << endl;
+            return 1;
+        }
+        cout << "SWAP real: " << paramRespaldo.rutaSwap << " (" << paramRespaldo.hilos << " hilos de E/S, lotes de "
+             << paramRespaldo.lote << (paramRespaldo.directo ? ", O_DIRECT" : "") << ")" << endl;
+    }
+    // y con la prebúsqueda, que además se compara contra la misma política sin ella
+    unique_ptr<Prebuscador> prebuscador;
+    if (paramPre.tipo != PREBUSQUEDA_NO && !comparar)
+        prebuscador.reset(new Prebuscador(paramPre));
+    if (paramPre.tipo != PREBUSQUEDA_NO)
+        cout << "Prebúsqueda: " << (prebuscador ? NOMBRES_PREBUSQUEDA[paramPre.tipo] : "solo sin --comparar") << endl;
+    // y con las páginas grandes, que se comparan contra las normales
+    bool grandes = paramGrandes.modo != GRANDES_NO && !comparar;
+    if (grandes && !RAMMixta::validar(paramGrandes, marcos, bytesPagina, error))
+    {
+        cout << RED << "[ERROR] " << error << RESET << endl;
+        return 1;
+    }
+    if (paramGrandes.modo != GRANDES_NO)
+        cout << "Páginas grandes: " << (grandes ? NOMBRES_GRANDES[paramGrandes.modo] : "solo sin --comparar") << endl;
+    // y con el pool comprimido, que le quita marcos a la RAM y se compara contra la RAM entera sin pool
+    unique_ptr<SwapComprimida> zswap;
+    int marcosRAM = marcos;
+    if (paramZ.presupuestoMB > 0 && !comparar)
+    {
+        if (!SwapComprimida::validar(paramZ, ramMB, error))
+        {
+            cout << RED << "[ERROR] " << error << RESET << endl;
+            return 1;
+        }
+        zswap.reset(new SwapComprimida(paramZ, bytesPagina));
+        marcos -= (int)((zswap->bytesPresupuesto() + bytesPagina - 1) / bytesPagina);
+        cout << "Pool comprimido: " << paramZ.presupuestoMB << " MB de la RAM (" << NOMBRES_POOL[paramZ.politica]
+             << "); quedan " << marcos << " marcos para páginas" << endl;
+    }
+    else if (paramZ.presupuestoMB > 0)
+        cout << "Pool comprimido: solo sin --comparar" << endl;
+
+    // OPT necesita una pasada previa para saber cuándo se vuelve a usar cada página
+    vector<uint64_t> proximos;
+    bool hayOPT = comparar || crearPolitica(nombrePolitica, 0)->necesitaFuturo();
+    if (hayOPT)
+    {
+        if (!proximosUsosTraza(traza, bytesPagina, proximos, error))
+        {
+            cout << RED << "[ERROR] " << error << RESET << endl;
+            return 1;
+        }
+    }
+
+    vector<ResultadoPolitica> resultados;
+    unique_ptr<RAMMixta> ram;
+    for (const char *nombre : NOMBRES_POLITICAS)
+    {
+        if (!comparar && nombrePolitica != nombre)
+            continue;
+        unique_ptr<Politica> p = crearPolitica(nombre, marcos);
+        if (grandes)
+        {
+            ram.reset(new RAMMixta(marcos, bytesPagina, paramGrandes, *p, tlb.get()));
+            resultados.push_back(ejecutarTrazaMixta(traza, *ram, *p, error));
+        }
+        else
+            resultados.push_back(ejecutarTraza(traza, marcos, bytesPagina, *p, p->necesitaFuturo() ? &proximos : nullptr,
+                                               error, tlb.get(), respaldo.get(), prebuscador.get(), zswap.get()));
+        if (!error.empty())
+        {
+            cout << RED << "[ERROR] " << error << RESET << endl;
+            return 1;
+        }
+    }
+
+    if (comparar)
+    {
+        cout.flush();
+        imprimirComparacion(resultados);
+    }
+    else
+    {
+        const ResultadoPolitica &r = resultados[0];
+        cout << YELLOW << "Política de reemplazo: " << RESET << crearPolitica(nombrePolitica, 0)->descripcion() << endl;
+        cout << "Accesos: " << r.accesos << endl;
+        // los desalojos de la prebúsqueda no son de ningún fault: van aparte
+        uint64_t desalojosPre = prebuscador ? prebuscador->desalojos : 0;
+        cout << RED << "Page faults: " << RESET << r.faults << " (" << r.desalojos - desalojosPre << " con reemplazo)";
+        if (prebuscador)
+            cout << ", más " << desalojosPre << " desalojos de la prebúsqueda";
+        cout << endl;
+        cout << GREEN << "Tasa de aciertos: " << RESET << fixed << setprecision(2) << r.tasaAciertos() * 100 << "%" << endl;
+        cout << "Tiempo: " << setprecision(3) << r.segundos << " s" << endl;
+        cout << "Accesos por segundo: " << setprecision(0) << (r.segundos > 0 ? r.accesos / r.segundos : 0) << endl;
+        if (tlb)
+            imprimirTLB(*tlb);
+        if (respaldo)
+            imprimirRespaldo(*respaldo);
+        if (prebuscador)
+        {
+            imprimirPrebusqueda(*prebuscador);
+            unique_ptr<Politica> p = crearPolitica(nombrePolitica, marcos);
+            ResultadoPolitica sin = ejecutarTraza(traza, marcos, bytesPagina, *p, nullptr, error);
+            cout << "Page faults sin prebúsqueda: " << sin.faults << " → con prebúsqueda: " << r.faults << " ("
+                 << setprecision(1) << (sin.faults ? 100.0 * ((double)r.faults - sin.faults) / sin.faults : 0) << "%)" << endl;
+        }
+        if (zswap)
+        {
+            imprimirSwapComprimida(*zswap);
+            // la misma política con la RAM entera: cada desalojo va a la SWAP
+            ParametrosSwapComprimida sinPool = paramZ;
+            sinPool.presupuestoMB = 0;
+            SwapComprimida soloSwap(sinPool, bytesPagina);
+            unique_ptr<Politica> p = crearPolitica(nombrePolitica, marcosRAM);
+            unique_ptr<Prebuscador> preSin(prebuscador ? new Prebuscador(paramPre) : nullptr);
+            ResultadoPolitica sin = ejecutarTraza(traza, marcosRAM, bytesPagina, *p, p->necesitaFuturo() ? &proximos : nullptr,
+                                                  error, nullptr, nullptr, preSin.get(), &soloSwap);
+            cout << "Sin pool, con los " << marcosRAM << " marcos: " << sin.faults << " page faults, "
+                 << soloSwap.lecturasSwap << " lecturas y " << soloSwap.escriturasSwap << " escrituras en la SWAP, "
+                 << setprecision(1) << soloSwap.usTotal() / 1000 << " ms" << endl;
+            cout << "Con el pool, con " << marcos << " marcos: " << r.faults << " page faults, " << zswap->lecturasSwap
+                 << " lecturas y " << zswap->escriturasSwap << " escrituras en la SWAP, " << zswap->usTotal() / 1000 << " ms";
+            if (soloSwap.usTotal() > 0)
+                cout << " (" << 100.0 * (zswap->usTotal() - soloSwap.usTotal()) / soloSwap.usTotal() << "%)";
+            cout << endl;
+        }
+        if (ram)
+        {
+            imprimirPaginasGrandes(*ram, paramGrandes);
+            // la misma política y el mismo TLB, solo con páginas normales
+            unique_ptr<Politica> p = crearPolitica(nombrePolitica, marcos);
+            unique_ptr<TLB> tlbSin(tlb ? new TLB(paramTLB) : nullptr);
+            ResultadoPolitica sin = ejecutarTraza(traza, marcos, bytesPagina, *p, nullptr, error, tlbSin.get());
+            cout << "Page faults solo con páginas normales: " << sin.faults << " → con grandes: " << r.faults << " ("
+                 << setprecision(1) << (sin.faults ? 100.0 * ((double)r.faults - sin.faults) / sin.faults : 0) << "%)" << endl;
+            // un fault normal mueve una página; uno grande, hasta una página grande entera
+            cout << "Páginas movidas con la SWAP solo con páginas normales: " << sin.faults + sin.desalojos
+                 << " → con grandes: " << ram->paginasLeidas + ram->paginasEscritas << endl;
+            if (tlb)
+                cout << "Aciertos del TLB solo con páginas normales: " << setprecision(2) << tlbSin->tasaAciertos() * 100
+                     << "% → con grandes: " << tlb->tasaAciertos() * 100 << "%; ciclos por traducción "
+                     << tlbSin->ciclosPorTraduccion() << " → " << tlb->ciclosPorTraduccion() << endl;
+        }
+    }
+    cout << BOLD << CYAN << "================================" << RESET << endl;
+    return 0;
+}
+
+// Modo concurrente: 'hilos' hilos se reparten los procesos y acceden a la
+// vez a la misma RAM; mide accesos por segundo y verifica la RAM al final
+static int ejecutarModoConcurrente(const string &tipo, int hilos, int fragmentos, const ParametrosCarga &carga,
+                                   int ramMB, int paginaKB, int procesos, int tamProcesoMB, uint64_t accesos,
+                                   int rafaga, uint64_t semilla)
+{
+    int marcos = (int)((long long)ramMB * 1024 / paginaKB);
+    uint64_t paginasPorProceso = (uint64_t)tamProcesoMB * 1024 / paginaKB;
+    uint64_t paginasTotales = paginasPorProceso * (uint64_t)max(procesos, 0);
+    if (hilos <= 0 || procesos < hilos || paginasPorProceso == 0 || paginasTotales > UINT32_MAX ||
+        rafaga <= 0 || fragmentos <= 0 || marcos < 2 * hilos || marcos < fragmentos)
+    {
+        cout << RED << "\n[ERROR] Parámetros inválidos (se necesitan al menos tantos procesos como hilos"
+             << " y más marcos que hilos y fragmentos)." << RESET << endl;
+        return 1;
+    }
+
+    unique_ptr<RAMConcurrente> ram;
+    if (tipo == "clock")
+        ram.reset(new ClockConcurrente(marcos, (uint32_t)paginasTotales));
+    else if (tipo == "lru")
+        ram.reset(new LRUFragmentada(marcos, (uint32_t)paginasTotales, fragmentos));
+    else
+    {
+        cout << RED << "[ERROR] Modo concurrente desconocido: " << tipo << " (clock o lru)" << RESET << endl;
+        return 1;
+    }
+
+    cout << BOLD << CYAN << "========== MODO CONCURRENTE ==========" << RESET << endl;
+    cout << GREEN << "RAM: " << RESET << ramMB << " MB, páginas de " << paginaKB << " KB → " << marcos << " marcos" << endl;
+    cout << "Procesos: " << procesos << " de " << tamProcesoMB << " MB (" << paginasPorProceso << " páginas), carga "
+         << describirCarga(carga) << endl;
+    cout << YELLOW << "Reemplazo: " << RESET << ram->nombre();
+    if (tipo == "lru")
+        cout << " (" << fragmentos << " fragmentos)";
+    cout << ", " << hilos << " hilos (" << thread::hardware_concurrency() << " CPUs)" << endl;
+
+    ResultadoConcurrente r = ejecutarConcurrente(*ram, hilos, carga, procesos, (uint32_t)paginasPorProceso,
+                                                 accesos, rafaga, semilla);
+    string error;
+    if (!ram->verificar(error))
+    {
+        cout << RED << "[ERROR] RAM inconsistente: " << error << RESET << endl;
+        return 1;
+    }
+
+    cout << "Accesos: " << r.accesos << endl;
+    cout << RED << "Page faults: " << RESET << r.faults << " (" << r.desalojos << " con reemplazo)" << endl;
+    cout << GREEN << "Tasa de aciertos: " << RESET << fixed << setprecision(2)
+         << (r.accesos ? 100.0 * (r.accesos - r.faults) / r.accesos : 0) << "%" << endl;
+    cout << "Tiempo: " << setprecision(3) << r.segundos << " s" << endl;
+    cout << "Accesos por segundo: " << setprecision(0) << (r.segundos > 0 ? r.accesos / r.segundos : 0)
+         << " (" << (r.segundos > 0 ? r.accesos / r.segundos / hilos : 0) << " por hilo)" << endl;
+    cout << BOLD << CYAN << "======================================" << RESET << endl;
+    return 0;
+}
+
+// "16,32,64", "16:256:x2" (de 16 a 256 multiplicando por 2) o "1:8:1" (sumando 1),
+// y combinaciones separadas por comas; false si algún valor no es un entero > 0
+static bool leerLista(const string &texto, vector<int> &valores)
+{
+    valores.clear();
+    stringstream partes(texto);
+    string parte;
+    while (getline(partes, parte, ','))
+    {
+        int desde, hasta, paso = 1;
+        char multiplica = 0;
+        if (sscanf(parte.c_str(), "%d:%d:x%d", &desde, &hasta, &paso) == 3)
+            multiplica = 1;
+        else if (sscanf(parte.c_str(), "%d:%d:%d", &desde, &hasta, &paso) < 2)
+        {
+            if (sscanf(parte.c_str(), "%d", &desde) != 1)
+                return false;
+            hasta = desde;
+        }
+        if (desde <= 0 || hasta < desde || paso < 1 || (multiplica && paso < 2))
+            return false;
+        for (long long v = desde; v <= hasta; v = multiplica ? v * paso : v + paso)
+            valores.push_back((int)v);
+    }
+    return !valores.empty();
+}
+
+// Barrido de configuraciones: cada combinación de RAM, página, rango de
+// procesos y política es un SimuladorPaginacion independiente y sin salida,
+// y un grupo de hilos las reparte. Todas usan la misma semilla, así que el
+// resultado no depende de cuántos hilos haya.
+static int ejecutarBarrido(const string &listaRAM, const string &listaPagina, const string &listaMin,
+                           const string &listaMax, const string &listaPoliticas, const ParametrosCarga &carga,
+                           const ParametrosTLB &paramTLB, const ParametrosPrebusqueda &paramPre,
+                           const ParametrosSwapComprimida &paramZ, const ParametrosConjuntoTrabajo &paramWS,
+                           const ParametrosCompartir &paramComp, int pasos, int accesosPorPaso, uint64_t semilla, int hilos, const string &rutaJSON)
+{
+    // con el JSON en stdout, todo lo demás va a stderr para no mezclarse
+    bool jsonEnSalida = rutaJSON == "-";
+    ostream &texto = jsonEnSalida ? cerr : cout;
+    FILE *tabla = jsonEnSalida ? stderr : stdout;
+
+    vector<int> rams, paginasKB, minimos, maximos;
+    if (!leerLista(listaRAM, rams) || !leerLista(listaPagina, paginasKB) || !leerLista(listaMin, minimos) ||
+        !leerLista(listaMax, maximos) || hilos <= 0)
+    {
+        texto << RED << "\n[ERROR] Parámetros inválidos (listas como 16,32 o 16:256:x2 o 1:8:1)." << RESET << endl;
+        return 1;
+    }
+    vector<string> politicas;
+    stringstream nombres(listaPoliticas);
+    for (string nombre; getline(nombres, nombre, ',');)
+    {
+        unique_ptr<Politica> p = crearPolitica(nombre, 0);
+        if (!p || p->necesitaFuturo())
+        {
+            texto << RED << "[ERROR] Política inválida para el barrido: " << nombre << RESET << endl;
+            return 1;
+        }
+        politicas.push_back(nombre);
+    }
+
+    struct Punto
+    {
+        int ramMB, paginaKB, minMB, maxMB;
+        string politica;
+    };
+    vector<Punto> puntos;
+    for (int ram : rams)
+        for (int pagina : paginasKB)
+            for (int minimo : minimos)
+                for (int maximo : maximos)
+                    for (const string &politica : politicas)
+                        if (maximo >= minimo)
+                            puntos.push_back({ram, pagina, minimo, maximo, politica});
+    if (puntos.empty())
+    {
+        texto << RED << "[ERROR] Ninguna combinación tiene proceso-max >= proceso-min." << RESET << endl;
+        return 1;
+    }
+    string error;
+    for (int ram : rams)
+        if (paramZ.presupuestoMB > 0 && !SwapComprimida::validar(paramZ, ram, error))
+        {
+            texto << RED << "[ERROR] " << error << " (RAM de " << ram << " MB)" << RESET << endl;
+            return 1;
+        }
+
+    hilos = min(hilos, (int)puntos.size());
+    texto << BOLD << CYAN << "========== BARRIDO ==========" << RESET << endl;
+    texto << puntos.size() << " configuraciones, " << pasos << " pasos con " << accesosPorPaso
+         << " accesos por paso, carga " << describirCarga(carga) << ", semilla " << semilla << endl;
+    texto << hilos << " hilos (" << thread::hardware_concurrency() << " CPUs)" << endl;
+
+    vector<SimuladorPaginacion::Resumen> resumenes(puntos.size());
+    vector<string> json(rutaJSON.empty() ? 0 : puntos.size());
+    atomic<size_t> siguiente(0);
+    auto inicio = chrono::steady_clock::now();
+    auto trabajar = [&]()
+    {
+        ostream nulo(nullptr); // cada hilo el suyo: los simuladores no escriben nada
+        for (size_t i; (i = siguiente.fetch_add(1)) < puntos.size();)
+        {
+            const Punto &p = puntos[i];
+            SimuladorPaginacion sim(p.ramMB, p.paginaKB, p.minMB, p.maxMB, p.politica, false, carga,
+                                    paramTLB, paramPre, paramZ, paramWS, paramComp, semilla, nulo);
+            sim.ejecutarSimulacion(pasos, accesosPorPaso);
+            resumenes[i] = sim.resumen();
+            if (!json.empty())
             {
-                tiempoMasAntiguo = RAM[i]->ultimoAcceso;
-                marcoVictima = i;
+                ostringstream os;
+                sim.escribirJSON(os);
+                json[i] = os.str();
             }
         }
+    };
+    vector<thread> grupo;
+    for (int h = 0; h < hilos; h++)
+        grupo.emplace_back(trabajar);
+    for (thread &t : grupo)
+        t.join();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    fprintf(tabla, "%7s %7s %9s %-6s %6s %10s %10s %8s %12s %s\n", "RAM MB", "pág KB", "proc MB", "pol.", "pasos",
+           "accesos", "faults", "fallos", "accesos/s", "fin");
+    for (size_t i = 0; i < puntos.size(); i++)
+    {
+        const Punto &p = puntos[i];
+        const SimuladorPaginacion::Resumen &r = resumenes[i];
+        char procesos[32];
+        snprintf(procesos, sizeof(procesos), "%d-%d", p.minMB, p.maxMB);
+        fprintf(tabla, "%7d %7d %9s %-6s %6d %10llu %10llu %7.2f%% %12.0f %s\n", p.ramMB, p.paginaKB, procesos,
+               p.politica.c_str(), r.pasos, (unsigned long long)r.accesos, (unsigned long long)r.faults,
+               r.accesos ? 100.0 * r.faults / r.accesos : 0.0, r.segundos > 0 ? r.accesos / r.segundos : 0.0, r.fin);
+    }
+    fprintf(tabla, "%zu configuraciones en %.2f s (%.1f por segundo)\n", puntos.size(), segundos, puntos.size() / segundos);
 
-        return marcoVictima;
+    if (!rutaJSON.empty())
+    {
+        // un arreglo con el resumen de cada configuración, en el orden de la tabla
+        string arreglo = "[\n";
+        for (size_t i = 0; i < json.size(); i++)
+            arreglo += json[i].substr(0, json[i].size() - 1) + (i + 1 < json.size() ? ",\n" : "\n");
+        arreglo += "]\n";
+        if (jsonEnSalida)
+        {
+            cout << arreglo << flush;
+            return 0;
+        }
+        ofstream archivo(rutaJSON);
+        archivo << arreglo;
+        if (!archivo)
+        {
+            texto << RED << "[ERROR] No se pudo escribir " << rutaJSON << RESET << endl;
+            return 1;
+        }
     }
-};
+    return 0;
+}
 
-int main()
+int main(int argc, char **argv)
 {
-    cout << BOLD << CYAN << "========================================" << RESET << endl;
-    cout << BOLD << CYAN << "  SIMULADOR DE PAGINACIÓN DE MEMORIA" << RESET << endl;
-    cout << BOLD << CYAN << "  Sistemas Operativos - Tarea 3" << RESET << endl;
-    cout << BOLD << CYAN << "========================================\n"
-         << RESET << endl;
+    // Opciones: --politica <lru|fifo|clock|2q|arc|opt> y --comparar; con
+    // --traza no se piden datos por entrada estándar (--ram, --pagina)
+    string nombrePolitica = "lru", rutaTraza, rutaBinaria, rutaGenerada;
+    bool comparar = false;
+    int ramMB = 64, paginaKB = 4;
+    // Carga de accesos (--carga, --zipf, --conjunto, --fase) y generación de
+    // trazas sintéticas (--generar con --accesos, --procesos, --tam-proceso, --rafaga)
+    ParametrosCarga carga;
+    uint64_t accesos = 1000000;
+    int procesosTraza = 8, tamProcesoMB = 16, rafaga = 64;
+    // Modo concurrente: --concurrente clock|lru con --hilos y --fragmentos (LRU)
+    string tipoConcurrente;
+    int hilos = max(1, (int)thread::hardware_concurrency()), fragmentos = 64;
+    // TLB: --tlb ENTRADAS (0 = sin TLB), --tlb-vias, --tlb-sin-asid, --tlb-recorrido CICLOS
+    ParametrosTLB paramTLB;
+    // SWAP real: --swap-real ARCHIVO con --hilos-io, --lote-io y --swap-directo
+    ParametrosRespaldo paramRespaldo;
+    // Prebúsqueda: --prebusqueda no|secuencial|zancada con --ventana N
+    ParametrosPrebusqueda paramPre;
+    // Corrida sin pausas ni preguntas: --pasos N con --ram, --pagina, --proceso-min y
+    // --proceso-max (y --accesos-paso K más por paso); --semilla fija la aleatoriedad y --json ARCHIVO (- = salida) el resumen
+    int pasos = 0, accesosPorPaso = 0, procesoMinMB = 1, procesoMaxMB = 16;
+    uint64_t semilla = 42;
+    bool semillaFija = false, silencioso = false;
+    string rutaJSON;
+    // Páginas grandes (modo traza): --paginas-grandes no|siempre|promover con
+    // --pagina-grande KB, --umbral-promocion F y --degradar
+    ParametrosPaginasGrandes paramGrandes;
+    // Pool comprimido: --zswap MB con --zswap-razon R, --zswap-incompresibles F,
+    // --zswap-politica lru|mayores y --latencia-swap US
+    ParametrosSwapComprimida paramZ;
+    // Conjunto de trabajo: --conjunto-trabajo (solo mide) o --control-carga, con
+    // --ws-ventana N, --ws-ventanas K, --carga-alta/--carga-baja F y --carga-turno N
+    ParametrosConjuntoTrabajo paramWS;
+    // Páginas compartidas: --fork P y --escrituras F (copy-on-write), --bibliotecas N
+    // con --biblioteca-mb MB
+    ParametrosCompartir paramComp;
+    // Métricas por cubetas: --metricas PREFIJO con --cubeta ACCESOS y --mapa-columnas K
+    ParametrosInstrumentacion paramMetricas;
+    // Barrido: --barrido; --ram, --pagina, --proceso-min, --proceso-max y --politica
+    // aceptan listas ("16,32", "16:256:x2", "1:8:1", "lru,arc")
+    bool barrido = false;
+    string listaRAM = "64", listaPagina = "4", listaMin = "1", listaMax = "16";
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--politica" && i + 1 < argc)
+            nombrePolitica = argv[++i];
+        else if (arg == "--comparar")
+            comparar = true;
+        else if (arg == "--traza" && i + 1 < argc)
+            rutaTraza = argv[++i];
+        else if (arg == "--ram" && i + 1 < argc)
+        {
+            listaRAM = argv[++i];
+            ramMB = atoi(argv[i]);
+        }
+        else if (arg == "--pagina" && i + 1 < argc)
+        {
+            listaPagina = argv[++i];
+            paginaKB = atoi(argv[i]);
+        }
+        else if (arg == "--convertir" && i + 1 < argc)
+            rutaBinaria = argv[++i];
+        else if (arg == "--carga" && i + 1 < argc)
+        {
+            if (!tipoCargaDesdeNombre(argv[++i], carga.tipo))
+            {
+                cout << RED << "[ERROR] Carga desconocida: " << argv[i] << RESET << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--zipf" && i + 1 < argc)
+            carga.zipfS = atof(argv[++i]);
+        else if (arg == "--conjunto" && i + 1 < argc)
+            carga.conjunto = atof(argv[++i]);
+        else if (arg == "--fase" && i + 1 < argc)
+            carga.largoFase = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--generar" && i + 1 < argc)
+            rutaGenerada = argv[++i];
+        else if (arg == "--accesos" && i + 1 < argc)
+            accesos = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--procesos" && i + 1 < argc)
+            procesosTraza = atoi(argv[++i]);
+        else if (arg == "--tam-proceso" && i + 1 < argc)
+            tamProcesoMB = atoi(argv[++i]);
+        else if (arg == "--rafaga" && i + 1 < argc)
+            rafaga = atoi(argv[++i]);
+        else if (arg == "--concurrente" && i + 1 < argc)
+            tipoConcurrente = argv[++i];
+        else if (arg == "--hilos" && i + 1 < argc)
+            hilos = atoi(argv[++i]);
+        else if (arg == "--fragmentos" && i + 1 < argc)
+            fragmentos = atoi(argv[++i]);
+        else if (arg == "--tlb" && i + 1 < argc)
+            paramTLB.entradas = atoi(argv[++i]);
+        else if (arg == "--tlb-vias" && i + 1 < argc)
+            paramTLB.vias = atoi(argv[++i]);
+        else if (arg == "--tlb-sin-asid")
+            paramTLB.conASID = false;
+        else if (arg == "--tlb-recorrido" && i + 1 < argc)
+            paramTLB.ciclosRecorrido = atof(argv[++i]);
+        else if (arg == "--swap-real" && i + 1 < argc)
+            paramRespaldo.rutaSwap = argv[++i];
+        else if (arg == "--hilos-io" && i + 1 < argc)
+            paramRespaldo.hilos = atoi(argv[++i]);
+        else if (arg == "--lote-io" && i + 1 < argc)
+            paramRespaldo.lote = atoi(argv[++i]);
+        else if (arg == "--swap-directo")
+            paramRespaldo.directo = true;
+        else if (arg == "--prebusqueda" && i + 1 < argc)
+        {
+            if (!tipoPrebusquedaDesdeNombre(argv[++i], paramPre.tipo))
+            {
+                cout << RED << "[ERROR] Prebúsqueda desconocida: " << argv[i] << RESET << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--ventana" && i + 1 < argc)
+            paramPre.ventana = atoi(argv[++i]);
+        else if (arg == "--pasos" && i + 1 < argc)
+            pasos = atoi(argv[++i]);
+        else if (arg == "--accesos-paso" && i + 1 < argc)
+            accesosPorPaso = atoi(argv[++i]);
+        else if (arg == "--proceso-min" && i + 1 < argc)
+        {
+            listaMin = argv[++i];
+            procesoMinMB = atoi(argv[i]);
+        }
+        else if (arg == "--proceso-max" && i + 1 < argc)
+        {
+            listaMax = argv[++i];
+            procesoMaxMB = atoi(argv[i]);
+        }
+        else if (arg == "--barrido")
+            barrido = true;
+        else if (arg == "--paginas-grandes" && i + 1 < argc)
+        {
+            if (!modoGrandesDesdeNombre(argv[++i], paramGrandes.modo))
+            {
+                cout << RED << "[ERROR] Modo de páginas grandes desconocido: " << argv[i] << RESET << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--pagina-grande" && i + 1 < argc)
+            paramGrandes.paginaGrandeKB = atoi(argv[++i]);
+        else if (arg == "--umbral-promocion" && i + 1 < argc)
+            paramGrandes.umbral = atof(argv[++i]);
+        else if (arg == "--degradar")
+            paramGrandes.degradar = true;
+        else if (arg == "--zswap" && i + 1 < argc)
+            paramZ.presupuestoMB = atoi(argv[++i]);
+        else if (arg == "--zswap-razon" && i + 1 < argc)
+            paramZ.razon = atof(argv[++i]);
+        else if (arg == "--zswap-incompresibles" && i + 1 < argc)
+            paramZ.incompresibles = atof(argv[++i]);
+        else if (arg == "--zswap-politica" && i + 1 < argc)
+        {
+            if (!politicaPoolDesdeNombre(argv[++i], paramZ.politica))
+            {
+                cout << RED << "[ERROR] Política del pool desconocida: " << argv[i] << RESET << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--latencia-swap" && i + 1 < argc)
+            paramZ.usSwap = atof(argv[++i]);
+        else if (arg == "--conjunto-trabajo")
+            paramWS.medir = true;
+        else if (arg == "--control-carga")
+            paramWS.controlar = true;
+        else if (arg == "--ws-ventana" && i + 1 < argc)
+            paramWS.ventana = atoi(argv[++i]);
+        else if (arg == "--ws-ventanas" && i + 1 < argc)
+            paramWS.ventanas = atoi(argv[++i]);
+        else if (arg == "--carga-alta" && i + 1 < argc)
+            paramWS.alto = atof(argv[++i]);
+        else if (arg == "--carga-baja" && i + 1 < argc)
+            paramWS.bajo = atof(argv[++i]);
+        else if (arg == "--carga-turno" && i + 1 < argc)
+            paramWS.turno = atoi(argv[++i]);
+        else if (arg == "--fork" && i + 1 < argc)
+            paramComp.fork = atof(argv[++i]);
+        else if (arg == "--escrituras" && i + 1 < argc)
+            paramComp.escrituras = atof(argv[++i]);
+        else if (arg == "--bibliotecas" && i + 1 < argc)
+            paramComp.bibliotecas = atoi(argv[++i]);
+        else if (arg == "--biblioteca-mb" && i + 1 < argc)
+            paramComp.bibliotecaMB = atoi(argv[++i]);
+        else if (arg == "--metricas" && i + 1 < argc)
+            paramMetricas.prefijo = argv[++i];
+        else if (arg == "--cubeta" && i + 1 < argc)
+            paramMetricas.cubeta = atoi(argv[++i]);
+        else if (arg == "--mapa-columnas" && i + 1 < argc)
+            paramMetricas.columnas = atoi(argv[++i]);
+        else if (arg == "--semilla" && i + 1 < argc)
+        {
+            semilla = strtoull(argv[++i], nullptr, 10);
+            semillaFija = true;
+        }
+        else if (arg == "--json" && i + 1 < argc)
+            rutaJSON = argv[++i];
+        else if (arg == "--silencioso")
+            silencioso = true;
+        else
+        {
+            cout << RED << "[ERROR] Opción desconocida: " << arg << RESET << endl;
+            cout << "Uso: " << argv[0] << " [--politica lru|fifo|clock|2q|arc] [--comparar]" << endl;
+            cout << "     " << argv[0] << " --traza ARCHIVO [--ram MB] [--pagina KB] [--politica lru|fifo|clock|2q|arc|opt] [--comparar]" << endl;
+            cout << "     " << argv[0] << " --traza ARCHIVO --convertir SALIDA.t3tr" << endl;
+            cout << "     " << argv[0] << " --generar SALIDA.t3tr [--accesos N] [--procesos P] [--tam-proceso MB] [--pagina KB] [--rafaga R]" << endl;
+            cout << "     " << argv[0] << " --concurrente clock|lru [--hilos T] [--fragmentos F] [--ram MB] [--pagina KB] [--accesos N] [--procesos P] [--tam-proceso MB] [--rafaga R]" << endl;
+            cout << "TLB: --tlb ENTRADAS (64, 0 = sin TLB) [--tlb-vias V] [--tlb-sin-asid] [--tlb-recorrido CICLOS]" << endl;
+            cout << "SWAP real: --swap-real ARCHIVO [--hilos-io N] [--lote-io K] [--swap-directo]" << endl;
+            cout << "Prebúsqueda: --prebusqueda no|secuencial|zancada [--ventana N]" << endl;
+            cout << "Páginas grandes (con --traza): --paginas-grandes no|siempre|promover [--pagina-grande KB] [--umbral-promocion F] [--degradar]" << endl;
+            cout << "Pool comprimido: --zswap MB [--zswap-razon R] [--zswap-incompresibles F] [--zswap-politica lru|mayores] [--latencia-swap US]" << endl;
+            cout << "Conjunto de trabajo: --conjunto-trabajo | --control-carga [--ws-ventana N] [--ws-ventanas K] [--carga-alta F] [--carga-baja F] [--carga-turno N]" << endl;
+            cout << "Compartir: [--fork P] [--escrituras F] [--bibliotecas N] [--biblioteca-mb MB]" << endl;
+            cout << "Métricas: --metricas PREFIJO [--cubeta ACCESOS] [--mapa-columnas K]" << endl;
+            cout << "Barrido: --barrido [--ram LISTA] [--pagina LISTA] [--proceso-min LISTA] [--proceso-max LISTA] [--politica LISTA] [--hilos T] [--pasos N] [--accesos-paso K] [--json ARCHIVO|-]" << endl;
+            cout << "Sin pausas: --pasos N [--ram MB] [--pagina KB] [--proceso-min MB] [--proceso-max MB] [--accesos-paso K] [--semilla S] [--json ARCHIVO|-] [--silencioso]" << endl;
+            cout << "Cargas: --carga uniforme|zipf|secuencial|bucle|fases [--zipf S] [--conjunto FRACCION] [--fase ACCESOS]" << endl;
+            return 1;
+        }
+    }
+    if (carga.zipfS <= 0 || carga.conjunto <= 0 || carga.conjunto > 1 || carga.largoFase == 0)
+    {
+        cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
+        return 1;
+    }
+    string errorTLB;
+    if (paramTLB.entradas != 0 && !TLB::validar(paramTLB, errorTLB))
+    {
+        cout << RED << "[ERROR] " << errorTLB << RESET << endl;
+        return 1;
+    }
+    if (paramRespaldo.hilos <= 0 || paramRespaldo.lote <= 0 || paramPre.ventana <= 0)
+    {
+        cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
+        return 1;
+    }
+    if (!rutaGenerada.empty())
+    {
+        if (paginaKB <= 0)
+        {
+            cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
+            return 1;
+        }
+        return generarTraza(rutaGenerada, carga, accesos, procesosTraza, tamProcesoMB, paginaKB, rafaga, semilla);
+    }
+    if (!tipoConcurrente.empty())
+    {
+        if (ramMB <= 0 || paginaKB <= 0)
+        {
+            cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
+            return 1;
+        }
+        return ejecutarModoConcurrente(tipoConcurrente, hilos, fragmentos, carga, ramMB, paginaKB, procesosTraza,
+                                       tamProcesoMB, accesos, rafaga, semilla);
+    }
+    // el pool trabaja sobre claves de página; la SWAP real, sobre sus marcos de SWAP
+    if (paramZ.presupuestoMB > 0 && (!paramRespaldo.rutaSwap.empty() || paramGrandes.modo != GRANDES_NO))
+    {
+        cout << RED << "[ERROR] El pool comprimido no se puede combinar con --swap-real ni con páginas grandes." << RESET << endl;
+        return 1;
+    }
+    // una sola latencia de SWAP para el pool y para el rendimiento modelado
+    paramWS.usFallo = paramZ.usSwap;
+    if (paramWS.activo())
+    {
+        string errorWS;
+        if (!validarConjuntoTrabajo(paramWS, errorWS))
+        {
+            cout << RED << "[ERROR] " << errorWS << RESET << endl;
+            return 1;
+        }
+        // la traza no tiene procesos que se creen, terminen o se suspendan
+        if (!rutaTraza.empty())
+        {
+            cout << RED << "[ERROR] El conjunto de trabajo y el control de carga son de la simulación normal, no del modo traza." << RESET << endl;
+            return 1;
+        }
+    }
+    string errorCompartir;
+    if (!validarCompartir(paramComp, errorCompartir))
+    {
+        cout << RED << "[ERROR] " << errorCompartir << RESET << endl;
+        return 1;
+    }
+    // en la traza cada proceso es un número; no hay creación ni escrituras
+    if (paramComp.activo() && !rutaTraza.empty())
+    {
+        cout << RED << "[ERROR] El fork y las bibliotecas compartidas son de la simulación normal, no del modo traza." << RESET << endl;
+        return 1;
+    }
+    string errorMetricas;
+    if (!validarInstrumentacion(paramMetricas, errorMetricas))
+    {
+        cout << RED << "[ERROR] " << errorMetricas << RESET << endl;
+        return 1;
+    }
+    // las series son de una sola corrida de la simulación normal
+    if (paramMetricas.activo() && (!rutaTraza.empty() || barrido))
+    {
+        cout << RED << "[ERROR] Las métricas por cubetas son de la simulación normal, no del modo traza ni del barrido." << RESET << endl;
+        return 1;
+    }
+    if (paramGrandes.modo != GRANDES_NO && rutaTraza.empty())
+    {
+        cout << RED << "[ERROR] Las páginas grandes solo están en el modo traza (--traza)." << RESET << endl;
+        return 1;
+    }
+    if (barrido)
+    {
+        // sin pausas siempre; por defecto 1000 pasos con 100 accesos cada uno
+        if (pasos < 0 || accesosPorPaso < 0)
+        {
+            cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
+            return 1;
+        }
+        return ejecutarBarrido(listaRAM, listaPagina, listaMin, listaMax, nombrePolitica, carga, paramTLB, paramPre, paramZ, paramWS, paramComp,
+                               pasos ? pasos : 1000, accesosPorPaso ? accesosPorPaso : 100, semilla, hilos, rutaJSON);
+    }
+    unique_ptr<Politica> elegida = crearPolitica(nombrePolitica, 0);
+    if (!elegida)
+    {
+        cout << RED << "[ERROR] Política desconocida: " << nombrePolitica << RESET << endl;
+        return 1;
+    }
+    if (!rutaTraza.empty())
+    {
+        if (ramMB <= 0 || paginaKB <= 0)
+        {
+            cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
+            return 1;
+        }
+        // OPT marca cada página con el próximo uso del acceso actual: no sabría cuándo se usa una prebuscada
+        if (elegida->necesitaFuturo() && paramPre.tipo != PREBUSQUEDA_NO && !comparar)
+        {
+            cout << RED << "[ERROR] La prebúsqueda no se puede combinar con OPT." << RESET << endl;
+            return 1;
+        }
+        // con páginas grandes la RAM no es de marcos sueltos: ni OPT, ni SWAP real, ni prebúsqueda
+        if (paramGrandes.modo != GRANDES_NO && !comparar &&
+            (elegida->necesitaFuturo() || !paramRespaldo.rutaSwap.empty() || paramPre.tipo != PREBUSQUEDA_NO))
+        {
+            cout << RED << "[ERROR] Las páginas grandes no se pueden combinar con OPT, --swap-real ni --prebusqueda." << RESET << endl;
+            return 1;
+        }
+        return ejecutarModoTraza(rutaTraza, ramMB, paginaKB, nombrePolitica, comparar, rutaBinaria, paramTLB,
+                                 paramRespaldo, paramPre, paramGrandes, paramZ);
+    }
+    if (elegida->necesitaFuturo())
+    {
+        cout << RED << "[ERROR] OPT necesita conocer los accesos futuros: solo está en la comparación (--comparar) y en el modo traza." << RESET << endl;
+        return 1;
+    }
 
-    int memoriaFisica, tamanioPagina, minTamProceso, maxTamProceso;
+    int memoriaFisica = ramMB, tamanioPagina = paginaKB, minTamProceso = procesoMinMB, maxTamProceso = procesoMaxMB;
 
-    cout << "Ingrese el tamaño de la memoria física (en MB): ";
-    cin >> memoriaFisica;
+    if (pasos == 0)
+    {
+        cout << BOLD << CYAN << "========================================" << RESET << endl;
+        cout << BOLD << CYAN << "  SIMULADOR DE PAGINACIÓN DE MEMORIA" << RESET << endl;
+        cout << BOLD << CYAN << "  Sistemas Operativos - Tarea 3" << RESET << endl;
+        cout << BOLD << CYAN << "========================================\n"
+             << RESET << endl;
 
-    cout << "Ingrese el tamaño de cada página (en KB): ";
-    cin >> tamanioPagina;
+        cout << "Ingrese el tamaño de la memoria física (en MB): ";
+        cin >> memoriaFisica;
 
-    cout << "Ingrese el tamaño mínimo de proceso (en MB): ";
-    cin >> minTamProceso;
+        cout << "Ingrese el tamaño de cada página (en KB): ";
+        cin >> tamanioPagina;
 
-    cout << "Ingrese el tamaño máximo de proceso (en MB): ";
-    cin >> maxTamProceso;
+        cout << "Ingrese el tamaño mínimo de proceso (en MB): ";
+        cin >> minTamProceso;
+
+        cout << "Ingrese el tamaño máximo de proceso (en MB): ";
+        cin >> maxTamProceso;
+    }
 
     if (memoriaFisica <= 0 || tamanioPagina <= 0 || minTamProceso <= 0 ||
-        maxTamProceso < minTamProceso)
+        maxTamProceso < minTamProceso || pasos < 0 || accesosPorPaso < 0)
     {
         cout << RED << "\n[ERROR] Parámetros inválidos." << RESET << endl;
         return 1;
     }
+    string errorZswap;
+    if (paramZ.presupuestoMB > 0 && !SwapComprimida::validar(paramZ, memoriaFisica, errorZswap))
+    {
+        cout << RED << "[ERROR] " << errorZswap << RESET << endl;
+        return 1;
+    }
+    if (!semillaFija)
+        semilla = random_device()();
+
+    // Sin un streambuf el flujo queda en error y descarta todo sin formatear.
+    // Con --json - la salida estándar es solo del JSON: el registro va a cerr
+    ostream nulo(nullptr);
+    ostream &registro = silencioso ? nulo : (rutaJSON == "-" ? cerr : cout);
+    SimuladorPaginacion simulador(memoriaFisica, tamanioPagina, minTamProceso, maxTamProceso,
+                                  nombrePolitica, comparar, carga, paramTLB, paramPre, paramZ, paramWS, paramComp, semilla,
+                                  registro);
+    string errorRespaldo;
+    if (!paramRespaldo.rutaSwap.empty() && !simulador.abrirRespaldo(paramRespaldo, errorRespaldo))
+    {
+        cout << RED << "[ERROR] " << errorRespaldo << RESET << endl;
+        return 1;
+    }
+    if (paramMetricas.activo())
+        simulador.instrumentar(paramMetricas);
+    simulador.ejecutarSimulacion(pasos, accesosPorPaso);
 
-    SimuladorPaginacion simulador(memoriaFisica, tamanioPagina, minTamProceso, maxTamProceso);
-    simulador.ejecutarSimulacion();
+    string errorEscritura;
+    if (paramMetricas.activo() && !simulador.escribirMetricas(errorEscritura))
+    {
+        cout << RED << "[ERROR] " << errorEscritura << RESET << endl;
+        return 1;
+    }
+
+    if (rutaJSON == "-")
+        simulador.escribirJSON(cout);
+    else if (!rutaJSON.empty())
+    {
+        ofstream archivo(rutaJSON);
+        simulador.escribirJSON(archivo);
+        if (!archivo)
+        {
+            cout << RED << "[ERROR] No se pudo escribir " << rutaJSON << RESET << endl;
+            return 1;
+        }
+    }
 
     return 0;
 }
\ No newline at end of file
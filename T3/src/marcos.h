@@ -0,0 +1,136 @@
+#ifndef MARCOS_H
+#define MARCOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Marcos libres de una memoria (RAM o SWAP).
+//
+// - Un bitmap con un bit por marco (1 = libre) en palabras de 64 bits.
+// - Una pila con los marcos liberados: tomar() usa primero el último
+//   liberado, en O(1).
+// - Si la pila está vacía, se busca con ctz desde 'cursor'. Todo marco libre
+//   por debajo del cursor está en la pila, así que el cursor nunca retrocede
+//   y el recorrido completo cuesta O(marcos / 64) en toda la corrida.
+class AsignadorMarcos
+{
+public:
+    explicit AsignadorMarcos(int marcos = 0)
+        : bits((marcos + 63) / 64, ~0ull), numMarcos(marcos), numLibres(marcos), cursor(0)
+    {
+        // los bits sobrantes de la última palabra no son marcos
+        if (marcos % 64)
+            bits.back() = (1ull << (marcos % 64)) - 1;
+    }
+
+    // Reserva un marco libre; -1 si no queda ninguno
+    int tomar()
+    {
+        while (!pila.empty())
+        {
+            int m = pila.back();
+            pila.pop_back();
+            if (estaLibre(m))
+            {
+                ocupar(m);
+                return m;
+            }
+        }
+
+        std::size_t w = (std::size_t)cursor / 64;
+        for (; w < bits.size(); w++)
+        {
+            if (bits[w])
+            {
+                int m = (int)(w * 64) + __builtin_ctzll(bits[w]);
+                cursor = m;
+                ocupar(m);
+                return m;
+            }
+        }
+        cursor = numMarcos;
+        return -1;
+    }
+
+    void liberar(int marco)
+    {
+        if (estaLibre(marco))
+            return;
+        bits[marco / 64] |= 1ull << (marco % 64);
+        numLibres++;
+        if (marco < cursor)
+            pila.push_back(marco);
+    }
+
+    // Ocupa un marco en particular (para armar un bloque contiguo); false si no estaba libre
+    bool reservar(int marco)
+    {
+        if (!estaLibre(marco))
+            return false;
+        ocupar(marco);
+        return true;
+    }
+
+    // Bloques alineados de 'n' marcos (n potencia de 2): el bloque b es
+    // [b * n, (b + 1) * n). Con n >= 64 un bloque son n / 64 palabras enteras.
+    int libresEnBloque(int b, int n) const
+    {
+        std::size_t primero = (std::size_t)b * n;
+        if (n < 64)
+            return __builtin_popcountll((bits[primero / 64] >> (primero % 64)) & ((1ull << n) - 1));
+        int libresBloque = 0;
+        for (std::size_t w = primero / 64; w < (primero + n) / 64; w++)
+            libresBloque += __builtin_popcountll(bits[w]);
+        return libresBloque;
+    }
+
+    // Bloques enteramente libres, listos para una página grande
+    int bloquesLibres(int n) const
+    {
+        int completos = 0;
+        for (int b = 0; b < numMarcos / n; b++)
+            completos += libresEnBloque(b, n) == n;
+        return completos;
+    }
+
+    // El bloque con más marcos libres, o sea el que menos cuesta compactar; -1 si no hay
+    int bloqueMasLibre(int n) const
+    {
+        int mejor = -1, masLibres = -1;
+        for (int b = 0; b < numMarcos / n && masLibres < n; b++)
+        {
+            int l = libresEnBloque(b, n);
+            if (l > masLibres)
+                mejor = b, masLibres = l;
+        }
+        return mejor;
+    }
+
+    // Fragmentación para bloques de 'n': fracción de los marcos libres que no
+    // forman un bloque completo (0 = todos sirven para páginas grandes)
+    double fragmentacion(int n) const
+    {
+        return numLibres ? 1.0 - (double)bloquesLibres(n) * n / numLibres : 0.0;
+    }
+
+    bool estaLibre(int marco) const { return (bits[marco / 64] >> (marco % 64)) & 1; }
+    int libres() const { return numLibres; }
+    int ocupados() const { return numMarcos - numLibres; }
+    int total() const { return numMarcos; }
+
+private:
+    std::vector<uint64_t> bits;
+    std::vector<int> pila;
+    int numMarcos;
+    int numLibres;
+    int cursor; // marcos >= cursor: libres según el bitmap, nunca en la pila
+
+    void ocupar(int marco)
+    {
+        bits[marco / 64] &= ~(1ull << (marco % 64));
+        numLibres--;
+    }
+};
+
+#endif
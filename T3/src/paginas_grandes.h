@@ -0,0 +1,381 @@
+#ifndef PAGINAS_GRANDES_H
+#define PAGINAS_GRANDES_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "marcos.h"
+#include "politicas.h"
+#include "tlb.h"
+
+// Páginas grandes (por ejemplo de 2 MB) junto a las normales, para el modo
+// traza. Una página grande cubre una región alineada del proceso y ocupa un
+// bloque alineado de marcos contiguos; para la política y el TLB es una
+// sola entrada.
+//
+// - siempre: un fault trae la región entera como página grande
+// - promover: los faults traen páginas normales, y la región se promueve
+//   cuando el fault la deja con al menos 'umbral' de sus páginas en RAM
+//
+// En los dos casos las páginas normales que la región ya tenía en RAM pasan
+// al bloque y las que faltan se rellenan. Con 'degradar', una página grande
+// elegida como víctima se parte: las subpáginas usadas quedan como páginas
+// normales y las demás se liberan.
+enum ModoPaginasGrandes
+{
+    GRANDES_NO,
+    GRANDES_SIEMPRE,
+    GRANDES_PROMOVER
+};
+
+static const char *const NOMBRES_GRANDES[] = {"no", "siempre", "promover"};
+
+struct ParametrosPaginasGrandes
+{
+    ModoPaginasGrandes modo = GRANDES_NO;
+    int paginaGrandeKB = 2048;
+    double umbral = 0.5;   // promover: fracción de la región en RAM
+    bool degradar = false; // partir la víctima en vez de desalojarla entera
+};
+
+inline bool modoGrandesDesdeNombre(const std::string &nombre, ModoPaginasGrandes &modo)
+{
+    for (int i = 0; i < (int)(sizeof(NOMBRES_GRANDES) / sizeof(NOMBRES_GRANDES[0])); i++)
+        if (nombre == NOMBRES_GRANDES[i])
+        {
+            modo = (ModoPaginasGrandes)i;
+            return true;
+        }
+    return false;
+}
+
+// RAM con páginas de dos tamaños. La política no ve marcos sino "unidades"
+// (una página normal o una grande), así una página se puede mover de marco
+// sin que la política se entere. Eso permite compactar: si no hay un bloque
+// libre pero sí suficientes marcos libres, las páginas del bloque con más
+// marcos libres se mudan a otros marcos. Si no alcanzan los marcos libres,
+// primero se desaloja lo que elija la política.
+class RAMMixta
+{
+public:
+    uint64_t accesos = 0, faults = 0, desalojos = 0;
+    uint64_t grandesCreadas = 0, promociones = 0, degradaciones = 0;
+    uint64_t compactaciones = 0, migradas = 0;      // páginas normales movidas para armar bloques
+    uint64_t rellenadas = 0, liberadasSinUso = 0;   // subpáginas traídas sin pedirlas / soltadas al degradar
+    uint64_t paginasLeidas = 0, paginasEscritas = 0; // E/S de SWAP en páginas normales
+
+    RAMMixta(int marcos, uint64_t bytesPagina, const ParametrosPaginasGrandes &p, Politica &pol, TLB *t)
+        : param(p), politica(pol), tlb(t), libres(marcos), slots(marcos), unidades(marcos), slotEn(marcos, -1),
+          usadas((marcos + 63) / 64, 0), bytesPag(bytesPagina),
+          porGrande((int)((uint64_t)p.paginaGrandeKB * 1024 / bytesPagina)), sumaFragmentacion(0)
+    {
+    }
+
+    // La página grande tiene que ser potencia de 2 páginas y la RAM, bloques enteros
+    static bool validar(const ParametrosPaginasGrandes &p, int marcos, uint64_t bytesPagina, std::string &error)
+    {
+        uint64_t bytesGrande = (uint64_t)p.paginaGrandeKB * 1024;
+        if (p.paginaGrandeKB <= 0 || bytesGrande <= bytesPagina || bytesGrande % bytesPagina != 0)
+            return error = "la página grande tiene que ser un múltiplo mayor de la página", false;
+        uint64_t n = bytesGrande / bytesPagina;
+        if (n & (n - 1))
+            return error = "la página grande tiene que ser una potencia de 2 páginas", false;
+        if (marcos % n != 0)
+            return error = "la RAM tiene que ser un múltiplo de la página grande", false;
+        if (p.umbral < 0 || p.umbral > 1)
+            return error = "el umbral de promoción va de 0 a 1", false;
+        return true;
+    }
+
+    int marcosPorGrande() const { return porGrande; }
+    int grandesEnRAM() const
+    {
+        int n = 0;
+        for (const auto &r : regiones)
+            n += r.second.slotGrande >= 0;
+        return n;
+    }
+
+    // Promedio de la fragmentación vista al pedir cada bloque
+    double fragmentacionPromedio() const { return grandesCreadas ? sumaFragmentacion / grandesCreadas : 0; }
+    double fragmentacionActual() const { return libres.fragmentacion(porGrande); }
+
+    // Fracción de las subpáginas de las grandes en RAM que se usaron
+    double usoGrandes() const
+    {
+        uint64_t usadasTotal = 0, total = 0;
+        for (const auto &r : regiones)
+            if (r.second.slotGrande >= 0)
+            {
+                int base = unidades[r.second.slotGrande].marco;
+                for (int w = base / 64; w < (base + porGrande + 63) / 64; w++)
+                    usadasTotal += __builtin_popcountll(usadas[w] & mascaraBloque(base));
+                total += porGrande;
+            }
+        return total ? (double)usadasTotal / total : 0;
+    }
+
+    // false si la política no pudo elegir víctima
+    bool acceder(uint32_t proceso, uint64_t direccion)
+    {
+        accesos++;
+        uint64_t pagina = direccion / bytesPag;
+        uint64_t region = pagina / porGrande;
+        int sub = (int)(pagina % porGrande);
+        uint64_t claveG = claveGrande(proceso, region);
+        auto r = regiones.find(claveG);
+        if (r != regiones.end() && r->second.slotGrande >= 0)
+        {
+            int s = r->second.slotGrande;
+            traducir(claveG);
+            politica.acceder(s);
+            marcarUsada(unidades[s].marco + sub);
+            return true;
+        }
+        uint64_t clave = clavePagina(proceso, pagina);
+        auto it = slotDe.find(clave);
+        if (it != slotDe.end())
+        {
+            traducir(clave);
+            politica.acceder(it->second);
+            return true;
+        }
+
+        faults++;
+        Region &reg = regiones[claveG];
+        if (param.modo == GRANDES_SIEMPRE || reg.residentes + 1 >= param.umbral * porGrande)
+        {
+            if (!formarGrande(proceso, region, sub, claveG))
+                return false;
+            traducir(claveG);
+            return true;
+        }
+        int m = marcoLibre(clave);
+        if (m == -1)
+            return false;
+        int s = slots.tomar();
+        ocuparUnidad(s, clave, m);
+        slotDe[clave] = s;
+        reg.residentes++;
+        politica.cargar(s, clave);
+        paginasLeidas++;
+        traducir(clave);
+        return true;
+    }
+
+private:
+    struct Unidad
+    {
+        uint64_t clave = 0;
+        int marco = -1; // el primero del bloque si es grande
+    };
+    struct Region
+    {
+        int slotGrande = -1; // unidad de la página grande, -1 si no está como grande
+        int residentes = 0;  // páginas normales de la región en RAM
+    };
+
+    // Bit 39 del número de página: las claves grandes no chocan con las normales
+    static const uint64_t BIT_GRANDE = 1ull << 39;
+
+    ParametrosPaginasGrandes param;
+    Politica &politica;
+    TLB *tlb;
+    AsignadorMarcos libres; // marcos físicos
+    AsignadorMarcos slots;  // unidades de la política
+    std::vector<Unidad> unidades;
+    std::vector<int> slotEn;       // unidad que ocupa cada marco
+    std::vector<uint64_t> usadas;  // un bit por marco: subpágina de una grande usada
+    std::unordered_map<uint64_t, int> slotDe; // páginas normales en RAM
+    std::unordered_map<uint64_t, Region> regiones; // nunca se borran: se toman referencias
+    uint64_t bytesPag;
+    int porGrande;
+    double sumaFragmentacion;
+
+    static uint64_t claveGrande(uint32_t proceso, uint64_t region) { return clavePagina(proceso, region | BIT_GRANDE); }
+    static bool esGrande(uint64_t clave) { return clave & BIT_GRANDE; }
+
+    uint64_t claveRegion(uint64_t claveNormal) const
+    {
+        return claveGrande((uint32_t)(claveNormal >> 40), (claveNormal & ((1ull << 40) - 1)) / porGrande);
+    }
+
+    void traducir(uint64_t clave)
+    {
+        if (tlb)
+            tlb->traducir(clave);
+    }
+
+    void marcarUsada(int marco) { usadas[marco / 64] |= 1ull << (marco % 64); }
+    bool estaUsada(int marco) const { return (usadas[marco / 64] >> (marco % 64)) & 1; }
+
+    // Bits del bloque que empieza en 'base' dentro de sus palabras de 'usadas'
+    uint64_t mascaraBloque(int base) const
+    {
+        if (porGrande >= 64)
+            return ~0ull;
+        return ((1ull << porGrande) - 1) << (base % 64);
+    }
+
+    void ocuparUnidad(int s, uint64_t clave, int marco)
+    {
+        unidades[s].clave = clave;
+        unidades[s].marco = marco;
+        slotEn[marco] = s;
+    }
+
+    // Página normal que deja la RAM o pasa a una grande
+    void soltarNormal(int s)
+    {
+        const Unidad &u = unidades[s];
+        regiones[claveRegion(u.clave)].residentes--;
+        slotDe.erase(u.clave);
+        libres.liberar(u.marco);
+        slotEn[u.marco] = -1;
+        slots.liberar(s);
+        if (tlb)
+            tlb->invalidar(u.clave);
+    }
+
+    // La política elige una víctima; false si no tiene ninguna
+    bool desalojarUna(uint64_t entrante)
+    {
+        int s = politica.desalojar(entrante);
+        if (s == -1)
+            return false;
+        desalojos++;
+        if (!esGrande(unidades[s].clave))
+        {
+            paginasEscritas++;
+            soltarNormal(s);
+            return true;
+        }
+
+        uint64_t claveG = unidades[s].clave;
+        int base = unidades[s].marco;
+        Region &reg = regiones[claveG];
+        reg.slotGrande = -1;
+        slots.liberar(s);
+        if (tlb)
+            tlb->invalidar(claveG);
+        if (!param.degradar)
+        {
+            paginasEscritas += porGrande;
+            for (int f = base; f < base + porGrande; f++)
+            {
+                libres.liberar(f);
+                slotEn[f] = -1;
+            }
+            return true;
+        }
+
+        // Degradar: las subpáginas usadas siguen en sus marcos como normales,
+        // tan frías como la grande que eligió la política
+        degradaciones++;
+        uint32_t proceso = (uint32_t)(claveG >> 40);
+        uint64_t primera = (claveG & ((1ull << 40) - 1) & ~BIT_GRANDE) * porGrande;
+        for (int i = 0; i < porGrande; i++)
+        {
+            int f = base + i;
+            if (!estaUsada(f))
+            {
+                libres.liberar(f);
+                slotEn[f] = -1;
+                liberadasSinUso++;
+                continue;
+            }
+            uint64_t clave = clavePagina(proceso, primera + i);
+            int t = slots.tomar();
+            ocuparUnidad(t, clave, f);
+            slotDe[clave] = t;
+            reg.residentes++;
+            politica.colocar(t, clave);
+        }
+        return true;
+    }
+
+    int marcoLibre(uint64_t entrante)
+    {
+        while (libres.libres() == 0)
+            if (!desalojarUna(entrante))
+                return -1;
+        return libres.tomar();
+    }
+
+    // Primer marco de un bloque para una página grande; desaloja hasta que
+    // haya marcos libres para un bloque y después compacta si hace falta
+    int bloqueLibre(uint64_t entrante)
+    {
+        while (libres.libres() < porGrande)
+            if (!desalojarUna(entrante))
+                return -1;
+        sumaFragmentacion += libres.fragmentacion(porGrande);
+        int b = libres.bloqueMasLibre(porGrande);
+        int base = b * porGrande;
+        // primero se reservan los libres del bloque, así las mudanzas caen afuera
+        bool compacta = false;
+        for (int f = base; f < base + porGrande; f++)
+            if (!libres.reservar(f))
+                compacta = true;
+        if (!compacta)
+            return base;
+        compactaciones++;
+        for (int f = base; f < base + porGrande; f++)
+        {
+            int s = slotEn[f];
+            if (s == -1)
+                continue;
+            int destino = libres.tomar();
+            unidades[s].marco = destino;
+            slotEn[destino] = s;
+            slotEn[f] = -1;
+            migradas++;
+        }
+        return base;
+    }
+
+    bool formarGrande(uint32_t proceso, uint64_t region, int sub, uint64_t claveG)
+    {
+        // las normales de la región que están en RAM salen de la política y se
+        // copian al bloque; se recuerdan como subpáginas usadas
+        std::vector<int> &movidas = subpaginas;
+        movidas.clear();
+        if (regiones[claveG].residentes > 0)
+            for (int i = 0; i < porGrande; i++)
+            {
+                auto it = slotDe.find(clavePagina(proceso, region * porGrande + i));
+                if (it == slotDe.end())
+                    continue;
+                politica.quitar(it->second);
+                soltarNormal(it->second);
+                movidas.push_back(i);
+            }
+
+        int base = bloqueLibre(claveG);
+        if (base == -1)
+            return false;
+        int s = slots.tomar();
+        for (int f = base; f < base + porGrande; f++)
+            slotEn[f] = s;
+        unidades[s].clave = claveG;
+        unidades[s].marco = base;
+        for (int f = base; f < base + porGrande; f++)
+            usadas[f / 64] &= ~(1ull << (f % 64));
+        for (int i : movidas)
+            marcarUsada(base + i);
+        marcarUsada(base + sub);
+        regiones[claveG].slotGrande = s;
+        politica.cargar(s, claveG);
+
+        grandesCreadas++;
+        promociones += !movidas.empty();
+        rellenadas += porGrande - 1 - movidas.size();
+        paginasLeidas += porGrande - movidas.size();
+        return true;
+    }
+
+    std::vector<int> subpaginas;
+};
+
+#endif
@@ -0,0 +1,443 @@
+#ifndef POLITICAS_H
+#define POLITICAS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "lru.h"
+
+// Política de reemplazo sobre los marcos de RAM. Todo marco ocupado está en
+// la política; 'pagina' identifica a la página (clavePagina()) para
+// las políticas que recuerdan páginas ya desalojadas.
+class Politica
+{
+public:
+    virtual ~Politica() {}
+    virtual const char *nombre() const = 0;
+    virtual const char *descripcion() const = 0;
+
+    virtual void colocar(int marco, uint64_t pagina) = 0; // al crear el proceso, sin acceso
+    virtual void cargar(int marco, uint64_t pagina) = 0;  // traída por un page fault
+    virtual void acceder(int marco) = 0;                  // HIT
+    virtual void quitar(int marco) = 0;                   // proceso finalizado
+
+    // Elige la víctima para hacerle lugar a 'entrante' y la saca; -1 si no hay
+    virtual int desalojar(uint64_t entrante) = 0;
+
+    // Solo para OPT: cuándo se vuelve a usar la página de la próxima
+    // colocar/cargar/acceder (posición en la traza, SIN_USO si nunca)
+    virtual void siguienteUso(uint64_t) {}
+    virtual bool necesitaFuturo() const { return false; }
+};
+
+static const uint64_t SIN_USO = UINT64_MAX;
+
+// 24 bits de proceso y 40 de número de página (alcanza para direcciones de
+// 52 bits con páginas de 4 KB, como las de una traza real)
+inline uint64_t clavePagina(uint32_t procesoId, uint64_t numeroPagina)
+{
+    return ((uint64_t)procesoId << 40) | (numeroPagina & ((1ull << 40) - 1));
+}
+
+// Páginas desalojadas que se recuerdan (2Q y ARC), de la más vieja a la más nueva
+class Fantasmas
+{
+public:
+    bool contiene(uint64_t p) const { return donde.count(p) != 0; }
+    size_t size() const { return orden.size(); }
+
+    void agregar(uint64_t p)
+    {
+        orden.push_back(p);
+        donde[p] = std::prev(orden.end());
+    }
+    void quitar(uint64_t p)
+    {
+        auto it = donde.find(p);
+        if (it == donde.end())
+            return;
+        orden.erase(it->second);
+        donde.erase(it);
+    }
+    void quitarMasVieja()
+    {
+        if (orden.empty())
+            return;
+        donde.erase(orden.front());
+        orden.pop_front();
+    }
+
+private:
+    std::list<uint64_t> orden;
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> donde;
+};
+
+// LRU: lista intrusiva de lru.h
+class PoliticaLRU : public Politica
+{
+public:
+    explicit PoliticaLRU(int marcos) : lista(marcos) {}
+    const char *nombre() const override { return "LRU"; }
+    const char *descripcion() const override { return "LRU (Least Recently Used)"; }
+    void colocar(int marco, uint64_t) override { lista.insertarFrio(marco); }
+    void cargar(int marco, uint64_t) override { lista.tocar(marco); }
+    void acceder(int marco) override { lista.tocar(marco); }
+    void quitar(int marco) override { lista.quitar(marco); }
+    int desalojar(uint64_t) override
+    {
+        int v = lista.victima();
+        if (v != -1)
+            lista.quitar(v);
+        return v;
+    }
+
+private:
+    ListaLRU lista;
+};
+
+// FIFO: la misma lista, pero solo se mueve al entrar a RAM
+class PoliticaFIFO : public Politica
+{
+public:
+    explicit PoliticaFIFO(int marcos) : lista(marcos) {}
+    const char *nombre() const override { return "FIFO"; }
+    const char *descripcion() const override { return "FIFO (First In, First Out)"; }
+    void colocar(int marco, uint64_t) override { lista.tocar(marco); }
+    void cargar(int marco, uint64_t) override { lista.tocar(marco); }
+    void acceder(int) override {}
+    void quitar(int marco) override { lista.quitar(marco); }
+    int desalojar(uint64_t) override
+    {
+        int v = lista.victima();
+        if (v != -1)
+            lista.quitar(v);
+        return v;
+    }
+
+private:
+    ListaLRU lista;
+};
+
+// CLOCK (segunda oportunidad): un bit de referencia por marco y una manecilla
+class PoliticaCLOCK : public Politica
+{
+public:
+    explicit PoliticaCLOCK(int marcos) : ref(marcos, 0), ocupado(marcos, 0), mano(0) {}
+    const char *nombre() const override { return "CLOCK"; }
+    const char *descripcion() const override { return "CLOCK (segunda oportunidad)"; }
+    void colocar(int marco, uint64_t) override { ocupado[marco] = 1, ref[marco] = 0; }
+    void cargar(int marco, uint64_t) override { ocupado[marco] = 1, ref[marco] = 1; }
+    void acceder(int marco) override { ref[marco] = 1; }
+    void quitar(int marco) override { ocupado[marco] = 0; }
+    int desalojar(uint64_t) override
+    {
+        size_t n = ref.size();
+        // a lo sumo dos vueltas: la primera puede apagar todos los bits
+        for (size_t paso = 0; paso < 2 * n; paso++)
+        {
+            int m = mano;
+            mano = (mano + 1) % (int)n;
+            if (!ocupado[m])
+                continue;
+            if (ref[m])
+            {
+                ref[m] = 0;
+                continue;
+            }
+            ocupado[m] = 0;
+            return m;
+        }
+        return -1;
+    }
+
+private:
+    std::vector<char> ref, ocupado;
+    int mano;
+};
+
+// 2Q (Johnson y Shasha): las páginas nuevas pasan por una cola FIFO A1in;
+// solo las que se vuelven a pedir después de salir de ella (y siguen en
+// A1out) entran a la LRU principal Am. Un recorrido secuencial no la ensucia.
+class Politica2Q : public Politica
+{
+public:
+    explicit Politica2Q(int marcos)
+        : a1in(marcos), am(marcos), enAm(marcos, 0), pagina(marcos, 0), nA1in(0), nAm(0),
+          kin(marcos / 4 > 0 ? marcos / 4 : 1), kout(marcos / 2 > 0 ? marcos / 2 : 1) {}
+    const char *nombre() const override { return "2Q"; }
+    const char *descripcion() const override { return "2Q (A1in FIFO + A1out + Am LRU)"; }
+
+    void colocar(int marco, uint64_t p) override
+    {
+        pagina[marco] = p;
+        enAm[marco] = 0;
+        a1in.tocar(marco);
+        nA1in++;
+    }
+    void cargar(int marco, uint64_t p) override
+    {
+        pagina[marco] = p;
+        if (a1out.contiene(p))
+        {
+            a1out.quitar(p);
+            enAm[marco] = 1;
+            am.tocar(marco);
+            nAm++;
+        }
+        else
+        {
+            enAm[marco] = 0;
+            a1in.tocar(marco);
+            nA1in++;
+        }
+    }
+    void acceder(int marco) override
+    {
+        if (enAm[marco])
+            am.tocar(marco);
+    }
+    void quitar(int marco) override
+    {
+        if (enAm[marco])
+            am.quitar(marco), nAm--;
+        else
+            a1in.quitar(marco), nA1in--;
+    }
+    int desalojar(uint64_t) override
+    {
+        if (nA1in > kin || (nAm == 0 && nA1in > 0))
+        {
+            int v = a1in.victima();
+            a1in.quitar(v);
+            nA1in--;
+            a1out.agregar(pagina[v]);
+            while ((int)a1out.size() > kout)
+                a1out.quitarMasVieja();
+            return v;
+        }
+        int v = am.victima();
+        if (v != -1)
+            am.quitar(v), nAm--;
+        return v;
+    }
+
+private:
+    ListaLRU a1in, am;
+    Fantasmas a1out;
+    std::vector<char> enAm;
+    std::vector<uint64_t> pagina;
+    int nA1in, nAm;
+    int kin, kout;
+};
+
+// ARC (Megiddo y Modha): T1 = vistas una vez, T2 = vistas dos o más; B1 y B2
+// recuerdan las desalojadas de cada una. Un acierto en B1 agranda el objetivo
+// p de T1, uno en B2 lo achica.
+class PoliticaARC : public Politica
+{
+public:
+    explicit PoliticaARC(int marcos)
+        : t1(marcos), t2(marcos), enT2(marcos, 0), pagina(marcos, 0), c(marcos), p(0),
+          nT1(0), nT2(0), adaptada(SIN_USO) {}
+    const char *nombre() const override { return "ARC"; }
+    const char *descripcion() const override { return "ARC (Adaptive Replacement Cache)"; }
+
+    void colocar(int marco, uint64_t pag) override
+    {
+        pagina[marco] = pag;
+        enT2[marco] = 0;
+        t1.insertarFrio(marco);
+        nT1++;
+        recortar();
+    }
+    void cargar(int marco, uint64_t pag) override
+    {
+        pagina[marco] = pag;
+        if (b1.contiene(pag) || b2.contiene(pag))
+        {
+            if (adaptada != pag)
+                adaptar(pag);
+            b1.quitar(pag);
+            b2.quitar(pag);
+            enT2[marco] = 1;
+            t2.tocar(marco);
+            nT2++;
+        }
+        else
+        {
+            enT2[marco] = 0;
+            t1.tocar(marco);
+            nT1++;
+            recortar();
+        }
+        adaptada = SIN_USO;
+    }
+    void acceder(int marco) override
+    {
+        if (!enT2[marco])
+        {
+            t1.quitar(marco);
+            nT1--;
+            enT2[marco] = 1;
+            nT2++;
+        }
+        t2.tocar(marco);
+    }
+    void quitar(int marco) override
+    {
+        if (enT2[marco])
+            t2.quitar(marco), nT2--;
+        else
+            t1.quitar(marco), nT1--;
+    }
+    int desalojar(uint64_t entrante) override
+    {
+        adaptar(entrante);
+        adaptada = entrante;
+
+        bool deT1 = nT1 > 0 && ((b2.contiene(entrante) && nT1 == p) || nT1 > p || nT2 == 0);
+        if (deT1)
+        {
+            int v = t1.victima();
+            t1.quitar(v);
+            nT1--;
+            b1.agregar(pagina[v]);
+            return v;
+        }
+        int v = t2.victima();
+        if (v == -1)
+            return -1;
+        t2.quitar(v);
+        nT2--;
+        b2.agregar(pagina[v]);
+        return v;
+    }
+
+private:
+    ListaLRU t1, t2;
+    Fantasmas b1, b2;
+    std::vector<char> enT2;
+    std::vector<uint64_t> pagina;
+    int c, p, nT1, nT2;
+    uint64_t adaptada; // página cuyo acierto en B1/B2 ya movió p en desalojar()
+
+    void adaptar(uint64_t pag)
+    {
+        int s1 = (int)b1.size(), s2 = (int)b2.size();
+        if (b1.contiene(pag))
+            p = std::min(c, p + std::max(1, s2 / s1));
+        else if (b2.contiene(pag))
+            p = std::max(0, p - std::max(1, s1 / s2));
+    }
+
+    // |T1| + |B1| <= c y el total (con fantasmas) <= 2c
+    void recortar()
+    {
+        while (nT1 + (int)b1.size() > c && b1.size() > 0)
+            b1.quitarMasVieja();
+        while (nT1 + nT2 + (int)(b1.size() + b2.size()) > 2 * c && b2.size() > 0)
+            b2.quitarMasVieja();
+    }
+};
+
+// OPT (Belady): desaloja la página que se va a usar más tarde. Necesita la
+// traza completa; el que la reproduce avisa con siguienteUso() antes de cada
+// colocar/cargar/acceder.
+class PoliticaOPT : public Politica
+{
+public:
+    explicit PoliticaOPT(int marcos)
+        : proximo(marcos, SIN_USO), version(marcos, 0), ocupado(marcos, 0), pendiente(SIN_USO), nOcupados(0) {}
+    const char *nombre() const override { return "OPT"; }
+    const char *descripcion() const override { return "OPT (Belady, con la traza completa)"; }
+    bool necesitaFuturo() const override { return true; }
+
+    void siguienteUso(uint64_t cuando) override { pendiente = cuando; }
+    void colocar(int marco, uint64_t) override { marcar(marco), nOcupados++; }
+    void cargar(int marco, uint64_t) override { marcar(marco), nOcupados++; }
+    void acceder(int marco) override { marcar(marco); }
+    void quitar(int marco) override
+    {
+        ocupado[marco] = 0;
+        version[marco]++;
+        nOcupados--;
+    }
+    int desalojar(uint64_t) override
+    {
+        // entradas viejas (marco reusado o quitado) se descartan al salir
+        while (!heap.empty())
+        {
+            Entrada e = heap.top();
+            heap.pop();
+            if (ocupado[e.marco] && version[e.marco] == e.version)
+            {
+                quitar(e.marco);
+                return e.marco;
+            }
+        }
+        return -1;
+    }
+
+private:
+    struct Entrada
+    {
+        uint64_t cuando;
+        int marco;
+        uint32_t version;
+        bool operator<(const Entrada &o) const { return cuando < o.cuando; }
+    };
+    std::priority_queue<Entrada> heap;
+    std::vector<uint64_t> proximo;
+    std::vector<uint32_t> version;
+    std::vector<char> ocupado;
+    uint64_t pendiente;
+    int nOcupados;
+
+    void marcar(int marco)
+    {
+        ocupado[marco] = 1;
+        proximo[marco] = pendiente;
+        heap.push({pendiente, marco, ++version[marco]});
+        pendiente = SIN_USO;
+        // con muchos accesos el heap se llena de entradas viejas: se rearma
+        if (heap.size() > 4 * (size_t)nOcupados + 1024)
+            rearmar();
+    }
+
+    void rearmar()
+    {
+        std::vector<Entrada> vivas;
+        for (size_t m = 0; m < ocupado.size(); m++)
+            if (ocupado[m])
+                vivas.push_back({proximo[m], (int)m, version[m]});
+        heap = std::priority_queue<Entrada>(std::less<Entrada>(), std::move(vivas));
+    }
+};
+
+static const char *const NOMBRES_POLITICAS[] = {"lru", "fifo", "clock", "2q", "arc", "opt"};
+
+// nullptr si el nombre no corresponde a ninguna política
+inline std::unique_ptr<Politica> crearPolitica(const std::string &nombre, int marcos)
+{
+    if (nombre == "lru")
+        return std::unique_ptr<Politica>(new PoliticaLRU(marcos));
+    if (nombre == "fifo")
+        return std::unique_ptr<Politica>(new PoliticaFIFO(marcos));
+    if (nombre == "clock")
+        return std::unique_ptr<Politica>(new PoliticaCLOCK(marcos));
+    if (nombre == "2q")
+        return std::unique_ptr<Politica>(new Politica2Q(marcos));
+    if (nombre == "arc")
+        return std::unique_ptr<Politica>(new PoliticaARC(marcos));
+    if (nombre == "opt")
+        return std::unique_ptr<Politica>(new PoliticaOPT(marcos));
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef PREBUSQUEDA_H
+#define PREBUSQUEDA_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Prebúsqueda (read-ahead): en un page fault se traen, además de la página
+// pedida, otras del mismo proceso que probablemente se usen pronto. Las
+// páginas traídas así entran a la política como si las hubiera traído un fault.
+//
+// El prebuscador ve los faults y el primer uso de cada página prebuscada:
+// ese primer uso dispara la ventana siguiente, así un recorrido no vuelve a
+// fallar mientras la prebúsqueda le gane.
+enum TipoPrebusqueda
+{
+    PREBUSQUEDA_NO,
+    PREBUSQUEDA_SECUENCIAL, // las 'ventana' páginas siguientes
+    PREBUSQUEDA_ZANCADA     // si el proceso repite el mismo salto, los 'ventana' siguientes con ese salto
+};
+
+static const char *const NOMBRES_PREBUSQUEDA[] = {"no", "secuencial", "zancada"};
+
+struct ParametrosPrebusqueda
+{
+    TipoPrebusqueda tipo = PREBUSQUEDA_NO;
+    int ventana = 8;
+};
+
+inline bool tipoPrebusquedaDesdeNombre(const std::string &nombre, TipoPrebusqueda &tipo)
+{
+    for (int i = 0; i < (int)(sizeof(NOMBRES_PREBUSQUEDA) / sizeof(NOMBRES_PREBUSQUEDA[0])); i++)
+        if (nombre == NOMBRES_PREBUSQUEDA[i])
+        {
+            tipo = (TipoPrebusqueda)i;
+            return true;
+        }
+    return false;
+}
+
+class Prebuscador
+{
+public:
+    // Los lleva quien trae y desaloja las páginas: útiles = usadas antes de
+    // salir de la RAM, desperdiciadas = desalojadas o liberadas sin usarse,
+    // desalojos = víctimas que hubo que sacar para hacerles lugar
+    uint64_t traidas = 0, utiles = 0, desperdiciadas = 0, desalojos = 0;
+
+    explicit Prebuscador(const ParametrosPrebusqueda &p) : param(p) {}
+
+    const ParametrosPrebusqueda &parametros() const { return param; }
+
+    // Fault o primer uso de una página prebuscada. Deja en 'candidatas' las
+    // páginas a traer; pueden pasarse del final del proceso, eso lo filtra
+    // quien llama.
+    void observar(uint32_t proceso, uint64_t pagina, std::vector<uint64_t> &candidatas)
+    {
+        candidatas.clear();
+        if (param.tipo == PREBUSQUEDA_NO)
+            return;
+        int64_t salto = 1;
+        if (param.tipo == PREBUSQUEDA_ZANCADA)
+        {
+            EstadoZancada &e = zancadas[proceso];
+            int64_t d = (int64_t)pagina - (int64_t)e.ultima;
+            bool confirmada = e.vista && d != 0 && d == e.salto;
+            e.salto = d;
+            e.ultima = pagina;
+            e.vista = true;
+            if (!confirmada)
+                return;
+            salto = d;
+        }
+        for (int k = 1; k <= param.ventana; k++)
+        {
+            int64_t c = (int64_t)pagina + k * salto;
+            if (c < 0)
+                break;
+            candidatas.push_back((uint64_t)c);
+        }
+    }
+
+    void olvidarProceso(uint32_t proceso) { zancadas.erase(proceso); }
+
+    // Prebuscadas que siguen en RAM sin haberse usado
+    uint64_t pendientes() const { return traidas - utiles - desperdiciadas; }
+    double precision() const { return utiles + desperdiciadas ? (double)utiles / (utiles + desperdiciadas) : 0; }
+
+private:
+    struct EstadoZancada
+    {
+        uint64_t ultima = 0;
+        int64_t salto = 0;
+        bool vista = false;
+    };
+
+    ParametrosPrebusqueda param;
+    std::unordered_map<uint32_t, EstadoZancada> zancadas;
+};
+
+#endif
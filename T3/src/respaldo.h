@@ -0,0 +1,327 @@
+#ifndef RESPALDO_H
+#define RESPALDO_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Memoria simulada con bytes de verdad: los marcos de RAM son una región
+// anónima de mmap y la SWAP es un archivo, un slot de 'bytesPagina' por
+// página. Un page fault es un trabajo de E/S: leer la página entrante de
+// su slot, escribir la saliente al suyo y copiar la entrante al marco.
+//
+// Los trabajos se juntan en lotes que atiende un grupo de hilos con
+// pread/pwrite. El simulador decide todo al instante y solo espera cuando
+// el lote se llena o cuando un trabajo nuevo toca un marco o un slot de
+// uno pendiente. Cada página lleva su clave en los primeros 8 bytes, así
+// que cada lectura verifica que se trajo la página correcta.
+struct ParametrosRespaldo
+{
+    std::string rutaSwap;  // vacía = sin respaldo real
+    int hilos = 4;         // hilos de E/S
+    int lote = 32;         // trabajos por lote
+    bool directo = false;  // O_DIRECT
+};
+
+class MemoriaRespaldada
+{
+public:
+    uint64_t lecturas = 0, escrituras = 0, lotes = 0;
+    uint64_t corruptas = 0, erroresIO = 0;
+    double segundosIO = 0;         // esperando lotes
+    std::vector<float> latencias;  // microsegundos de cada trabajo
+
+    MemoriaRespaldada() : ram(nullptr), fd(-1), numMarcos(0), bytesPag(0), tamLote(1),
+                          siguiente(0), terminados(0), generacion(0), salir(false), siguienteSlot(0) {}
+    ~MemoriaRespaldada() { cerrar(); }
+    MemoriaRespaldada(const MemoriaRespaldada &) = delete;
+    MemoriaRespaldada &operator=(const MemoriaRespaldada &) = delete;
+
+    // 'directo' abre la SWAP con O_DIRECT para saltarse la caché de páginas
+    bool abrir(int marcos, uint64_t bytesPagina, const ParametrosRespaldo &p, std::string &error)
+    {
+        cerrar();
+        numMarcos = marcos;
+        bytesPag = bytesPagina;
+        tamLote = std::max(p.lote, 1);
+        void *region = mmap(nullptr, (size_t)marcos * bytesPagina, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED)
+        {
+            error = std::string("mmap de la RAM falló: ") + strerror(errno);
+            return false;
+        }
+        ram = (char *)region;
+        fd = open(p.rutaSwap.c_str(), O_RDWR | O_CREAT | O_TRUNC | (p.directo ? O_DIRECT : 0), 0644);
+        if (fd < 0)
+        {
+            error = "no se pudo abrir la SWAP " + p.rutaSwap + ": " + strerror(errno);
+            cerrar();
+            return false;
+        }
+        salir = false;
+        for (int h = 0; h < std::max(p.hilos, 1); h++)
+            trabajadores.emplace_back(&MemoriaRespaldada::trabajar, this);
+        return true;
+    }
+
+    void cerrar()
+    {
+        if (!trabajadores.empty())
+        {
+            esperar();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                salir = true;
+            }
+            hayLote.notify_all();
+            for (auto &t : trabajadores)
+                t.join();
+            trabajadores.clear();
+        }
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+        if (ram)
+            munmap(ram, (size_t)numMarcos * bytesPag);
+        ram = nullptr;
+    }
+
+    bool abierta() const { return ram != nullptr; }
+    uint64_t bytesPagina() const { return bytesPag; }
+
+    // Page fault en 'marco': la página que lo ocupaba va a 'slotSalida' (-1 si
+    // no había o no se guarda) y la entrante sale de 'slotEntrada' (-1 si es
+    // nueva y se llena con ceros). Los dos slots pueden ser el mismo.
+    void fallo(int marco, int64_t slotSalida, int64_t slotEntrada, uint64_t claveEntrada)
+    {
+        encolar({marco, slotSalida, slotEntrada, claveEntrada});
+    }
+
+    // Página nueva que nace directamente en un slot de SWAP
+    void escribirSwap(int64_t slot, uint64_t clave) { encolar({-1, slot, -1, clave}); }
+
+    // Igual que fallo(), pero los slots los lleva esta clase por clave de página
+    void falloPorClave(int marco, bool hayDesalojo, uint64_t claveSalida, uint64_t claveEntrada)
+    {
+        int64_t entrada = -1, salida = -1;
+        auto it = slotDe.find(claveEntrada);
+        if (it != slotDe.end())
+        {
+            entrada = it->second;
+            slotsLibres.push_back(entrada);
+            slotDe.erase(it);
+        }
+        if (hayDesalojo)
+        {
+            salida = nuevoSlot();
+            slotDe[claveSalida] = salida;
+        }
+        fallo(marco, salida, entrada, claveEntrada);
+    }
+
+    // La página dejó de existir: su slot se puede reusar
+    void olvidar(uint64_t clave)
+    {
+        auto it = slotDe.find(clave);
+        if (it != slotDe.end())
+        {
+            slotsLibres.push_back(it->second);
+            slotDe.erase(it);
+        }
+    }
+
+    // Atiende el lote pendiente y vuelve cuando terminó
+    void esperar()
+    {
+        if (pendientes.empty())
+            return;
+        auto inicio = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            enCurso.swap(pendientes);
+            siguiente = 0;
+            terminados = 0;
+            generacion++;
+        }
+        hayLote.notify_all();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            loteListo.wait(lock, [&] { return terminados == trabajadores.size(); });
+        }
+        segundosIO += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        lotes++;
+        for (const Trabajo &t : enCurso)
+        {
+            lecturas += t.slotEntrada >= 0;
+            escrituras += t.slotSalida >= 0;
+            corruptas += t.corrupta;
+            erroresIO += t.errorIO;
+            latencias.push_back(t.microsegundos);
+        }
+        enCurso.clear();
+        pendientes.clear();
+    }
+
+    double megabytesMovidos() const { return (double)(lecturas + escrituras) * bytesPag / (1024.0 * 1024.0); }
+
+    // Percentil p (0..1) de las latencias, en microsegundos
+    double latencia(double p)
+    {
+        if (latencias.empty())
+            return 0;
+        size_t k = std::min(latencias.size() - 1, (size_t)(p * latencias.size()));
+        std::nth_element(latencias.begin(), latencias.begin() + k, latencias.end());
+        return latencias[k];
+    }
+
+private:
+    struct Trabajo
+    {
+        int marco;
+        int64_t slotSalida, slotEntrada;
+        uint64_t claveEntrada;
+        float microsegundos;
+        bool corrupta, errorIO;
+        Trabajo(int m, int64_t s, int64_t e, uint64_t c)
+            : marco(m), slotSalida(s), slotEntrada(e), claveEntrada(c), microsegundos(0), corrupta(false), errorIO(false) {}
+    };
+
+    char *ram;
+    int fd, numMarcos;
+    uint64_t bytesPag;
+    int tamLote;
+
+    std::vector<Trabajo> pendientes, enCurso;
+    std::vector<std::thread> trabajadores;
+    std::mutex mutex;
+    std::condition_variable hayLote, loteListo;
+    std::atomic<size_t> siguiente;
+    size_t terminados;
+    uint64_t generacion;
+    bool salir;
+
+    std::unordered_map<uint64_t, int64_t> slotDe; // páginas en SWAP (falloPorClave)
+    std::vector<int64_t> slotsLibres;
+    int64_t siguienteSlot;
+
+    int64_t nuevoSlot()
+    {
+        if (slotsLibres.empty())
+            return siguienteSlot++;
+        int64_t s = slotsLibres.back();
+        slotsLibres.pop_back();
+        return s;
+    }
+
+    // Dentro de un lote los trabajos corren en cualquier orden: si el nuevo
+    // toca un marco o un slot de uno pendiente, primero se vacía el lote
+    void encolar(const Trabajo &t)
+    {
+        for (const Trabajo &p : pendientes)
+            if ((t.marco >= 0 && p.marco == t.marco) || tocaSlot(p, t.slotSalida) || tocaSlot(p, t.slotEntrada))
+            {
+                esperar();
+                break;
+            }
+        pendientes.push_back(t);
+        if ((int)pendientes.size() >= tamLote)
+            esperar();
+    }
+
+    static bool tocaSlot(const Trabajo &p, int64_t slot)
+    {
+        return slot >= 0 && (p.slotSalida == slot || p.slotEntrada == slot);
+    }
+
+    void trabajar()
+    {
+        // página intermedia alineada (sirve para O_DIRECT): la entrante se lee
+        // acá antes de escribir la saliente, por si comparten slot
+        char *buffer = (char *)mmap(nullptr, bytesPag, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        uint64_t vista = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                hayLote.wait(lock, [&] { return salir || generacion != vista; });
+                if (salir)
+                    break;
+                vista = generacion;
+            }
+            for (size_t i; (i = siguiente.fetch_add(1)) < enCurso.size();)
+                atender(enCurso[i], buffer);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                terminados++;
+            }
+            loteListo.notify_one();
+        }
+        munmap(buffer, bytesPag);
+    }
+
+    void atender(Trabajo &t, char *buffer)
+    {
+        auto inicio = std::chrono::steady_clock::now();
+        if (t.marco < 0)
+        {
+            paginaNueva(buffer, t.claveEntrada);
+            t.errorIO = !transferir(false, buffer, t.slotSalida);
+        }
+        else
+        {
+            char *marco = ram + (size_t)t.marco * bytesPag;
+            if (t.slotEntrada >= 0)
+            {
+                t.errorIO |= !transferir(true, buffer, t.slotEntrada);
+                uint64_t clave;
+                memcpy(&clave, buffer, sizeof(clave));
+                t.corrupta = !t.errorIO && clave != t.claveEntrada;
+            }
+            if (t.slotSalida >= 0)
+                t.errorIO |= !transferir(false, marco, t.slotSalida);
+            if (t.slotEntrada >= 0)
+                memcpy(marco, buffer, bytesPag);
+            else
+                paginaNueva(marco, t.claveEntrada);
+        }
+        t.microsegundos = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    void paginaNueva(char *p, uint64_t clave)
+    {
+        memset(p, 0, bytesPag);
+        memcpy(p, &clave, sizeof(clave));
+    }
+
+    // Una página completa entre 'p' y el slot; false si la E/S falló
+    bool transferir(bool leer, char *p, int64_t slot)
+    {
+        off_t pos = (off_t)slot * (off_t)bytesPag;
+        for (uint64_t hecho = 0; hecho < bytesPag;)
+        {
+            ssize_t n = leer ? pread(fd, p + hecho, bytesPag - hecho, pos + hecho)
+                             : pwrite(fd, p + hecho, bytesPag - hecho, pos + hecho);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            hecho += (uint64_t)n;
+        }
+        return true;
+    }
+};
+
+#endif
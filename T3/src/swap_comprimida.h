@@ -0,0 +1,222 @@
+#ifndef SWAP_COMPRIMIDA_H
+#define SWAP_COMPRIMIDA_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+// Pool de páginas comprimidas entre la RAM y la SWAP, como zswap: una página
+// desalojada se comprime y queda en el pool, y si vuelve a fallar se
+// descomprime en vez de leerse de la SWAP. El pool tiene un presupuesto en
+// bytes que se le descuenta a la RAM; cuando no alcanza, devuelve páginas a
+// la SWAP según su propia política.
+//
+// Las páginas simuladas no tienen contenido que valga la pena comprimir (con
+// --swap-real son su clave y ceros), así que el tamaño comprimido sale de un
+// modelo: cada página tiene un tamaño fijo, derivado de su clave, que varía
+// alrededor de bytesPagina / razon, y una fracción 'incompresibles' no se
+// achica y va directo a la SWAP. Los tiempos también son un modelo.
+enum PoliticaPool
+{
+    POOL_LRU,    // devuelve la que entró hace más tiempo (la de zswap)
+    POOL_MAYORES // devuelve la más grande: libera más lugar por escritura
+};
+
+static const char *const NOMBRES_POOL[] = {"lru", "mayores"};
+
+struct ParametrosSwapComprimida
+{
+    int presupuestoMB = 0;       // 0 = sin pool
+    double razon = 3.0;          // razón de compresión promedio
+    double incompresibles = 0.1; // fracción de páginas que no se achican
+    PoliticaPool politica = POOL_LRU;
+    double usComprimir = 6, usDescomprimir = 1.5; // por cada 4 KB de página
+    double usSwap = 100;                          // leer o escribir una página en la SWAP
+};
+
+inline bool politicaPoolDesdeNombre(const std::string &nombre, PoliticaPool &politica)
+{
+    for (int i = 0; i < (int)(sizeof(NOMBRES_POOL) / sizeof(NOMBRES_POOL[0])); i++)
+        if (nombre == NOMBRES_POOL[i])
+        {
+            politica = (PoliticaPool)i;
+            return true;
+        }
+    return false;
+}
+
+class SwapComprimida
+{
+public:
+    // De dónde salió la página de un fault
+    enum Origen
+    {
+        ORIGEN_NUEVA, // nunca salió de la RAM: se llena con ceros
+        ORIGEN_POOL,
+        ORIGEN_SWAP
+    };
+
+    uint64_t aciertos = 0, fallos = 0, nuevas = 0;         // faults servidos por el pool / por la SWAP / sin datos
+    uint64_t guardadas = 0, rechazadas = 0, devueltas = 0; // al pool / directo a la SWAP / del pool a la SWAP
+    uint64_t lecturasSwap = 0, escriturasSwap = 0;
+    double usAciertos = 0, usFallos = 0, usDesalojos = 0;  // tiempo del modelo
+
+    SwapComprimida(const ParametrosSwapComprimida &p, uint64_t bytesPagina)
+        : param(p), bytesPag(bytesPagina), presupuesto((uint64_t)p.presupuestoMB * 1024 * 1024),
+          escala(bytesPagina / 4096.0), usados(0), reloj(0) {}
+
+    // El pool tiene que dejarle algo de RAM a las páginas
+    static bool validar(const ParametrosSwapComprimida &p, int ramMB, std::string &error)
+    {
+        if (p.presupuestoMB < 0 || p.presupuestoMB >= ramMB)
+            return error = "el pool comprimido tiene que ser menor que la RAM", false;
+        if (p.razon < 1)
+            return error = "la razón de compresión tiene que ser al menos 1", false;
+        if (p.incompresibles < 0 || p.incompresibles > 1)
+            return error = "la fracción de incompresibles va de 0 a 1", false;
+        if (p.usComprimir < 0 || p.usDescomprimir < 0 || p.usSwap < 0)
+            return error = "las latencias no pueden ser negativas", false;
+        return true;
+    }
+
+    const ParametrosSwapComprimida &parametros() const { return param; }
+    bool activo() const { return presupuesto > 0; }
+
+    // Página desalojada de la RAM. Devuelve los bytes que ocupa en el pool,
+    // o 0 si fue a la SWAP.
+    uint64_t guardar(uint64_t clave)
+    {
+        if (!activo())
+        {
+            escribir(clave);
+            return 0;
+        }
+        usDesalojos += param.usComprimir * escala;
+        uint64_t b = tamComprimido(clave);
+        if (b >= bytesPag || b > presupuesto)
+        {
+            rechazadas++;
+            escribir(clave);
+            return 0;
+        }
+        while (usados + b > presupuesto)
+            devolver();
+        uint64_t orden = ++reloj;
+        enPool[clave] = {b, orden};
+        cola.insert(entradaCola(clave, b, orden));
+        usados += b;
+        guardadas++;
+        return b;
+    }
+
+    // Page fault de 'clave': la página sale del pool o de la SWAP
+    Origen traer(uint64_t clave)
+    {
+        auto it = enPool.find(clave);
+        if (it != enPool.end())
+        {
+            aciertos++;
+            usAciertos += param.usDescomprimir * escala;
+            sacar(it);
+            return ORIGEN_POOL;
+        }
+        if (enSwap.erase(clave))
+        {
+            fallos++;
+            lecturasSwap++;
+            usFallos += param.usSwap;
+            return ORIGEN_SWAP;
+        }
+        nuevas++;
+        return ORIGEN_NUEVA;
+    }
+
+    // La página dejó de existir
+    void olvidar(uint64_t clave)
+    {
+        auto it = enPool.find(clave);
+        if (it != enPool.end())
+            sacar(it);
+        enSwap.erase(clave);
+    }
+
+    uint64_t bytesUsados() const { return usados; }
+    uint64_t paginasEnPool() const { return enPool.size(); }
+    uint64_t bytesPresupuesto() const { return presupuesto; }
+
+    // Razón de compresión de lo que está en el pool
+    double razonActual() const { return usados ? (double)enPool.size() * bytesPag / usados : 0; }
+    double tasaAciertos() const { return aciertos + fallos ? (double)aciertos / (aciertos + fallos) : 0; }
+    // Latencia promedio de un fault que tuvo que traer datos
+    double usPorFallo() const { return aciertos + fallos ? (usAciertos + usFallos) / (aciertos + fallos) : 0; }
+    double usTotal() const { return usAciertos + usFallos + usDesalojos; }
+
+    // Lo mismo sin pool: cada fault con datos habría sido una lectura y cada
+    // desalojo, una escritura
+    double usSinPool() const { return (double)(aciertos + fallos + guardadas + rechazadas) * param.usSwap; }
+
+private:
+    struct Entrada
+    {
+        uint64_t bytes, orden;
+    };
+
+    ParametrosSwapComprimida param;
+    uint64_t bytesPag, presupuesto;
+    double escala;
+    uint64_t usados, reloj;
+    std::unordered_map<uint64_t, Entrada> enPool;
+    // (prioridad, orden, clave): la primera es la próxima en volver a la SWAP
+    std::set<std::tuple<int64_t, uint64_t, uint64_t>> cola;
+    std::unordered_set<uint64_t> enSwap; // escritas en la SWAP y no vueltas a traer
+
+    std::tuple<int64_t, uint64_t, uint64_t> entradaCola(uint64_t clave, uint64_t bytes, uint64_t orden) const
+    {
+        return std::make_tuple(param.politica == POOL_MAYORES ? -(int64_t)bytes : 0, orden, clave);
+    }
+
+    void sacar(std::unordered_map<uint64_t, Entrada>::iterator it)
+    {
+        cola.erase(entradaCola(it->first, it->second.bytes, it->second.orden));
+        usados -= it->second.bytes;
+        enPool.erase(it);
+    }
+
+    void escribir(uint64_t clave)
+    {
+        escriturasSwap++;
+        usDesalojos += param.usSwap;
+        enSwap.insert(clave);
+    }
+
+    // La próxima de la cola se descomprime y se escribe en la SWAP
+    void devolver()
+    {
+        uint64_t clave = std::get<2>(*cola.begin());
+        sacar(enPool.find(clave));
+        devueltas++;
+        usDesalojos += param.usDescomprimir * escala;
+        escribir(clave);
+    }
+
+    // Tamaño comprimido fijo por página: splitmix64 de la clave
+    uint64_t tamComprimido(uint64_t clave) const
+    {
+        uint64_t h = clave + 0x9e3779b97f4a7c15ull;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        double u1 = (double)(h >> 40) / (1ull << 24);
+        double u2 = (double)(h & 0xffffff) / (1ull << 24);
+        if (u1 < param.incompresibles)
+            return bytesPag;
+        // entre la mitad y 1.5 veces el tamaño promedio
+        uint64_t b = (uint64_t)(bytesPag / param.razon * (0.5 + u2));
+        return b < 64 ? 64 : b;
+    }
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef TLB_H
+#define TLB_H
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// TLB asociativo por conjuntos delante de la tabla de páginas. Guarda
+// claves de clavePagina() (proceso en los 24 bits altos, página en los 40
+// bajos) y el conjunto sale de los bits bajos del número de página, como en
+// el hardware. Dentro del conjunto se reemplaza la vía usada hace más tiempo.
+//
+// Con ASID las entradas de varios procesos conviven; sin ASID el TLB se
+// vacía cada vez que se accede a un proceso distinto del anterior.
+struct ParametrosTLB
+{
+    int entradas = 64;           // 0 = sin TLB
+    int vias = 4;                // entradas por conjunto
+    bool conASID = true;         // si no, se vacía al cambiar de proceso
+    double ciclosAcierto = 1;    // búsqueda en el TLB
+    double ciclosRecorrido = 30; // recorrido de la tabla de páginas en un fallo
+};
+
+// "64 entradas, 4 vías, con ASID; alcance de 256 KB"
+inline std::string describirTLB(const ParametrosTLB &p, uint64_t paginaKB)
+{
+    std::ostringstream os;
+    os << p.entradas << " entradas, " << p.vias << " vías, "
+       << (p.conASID ? "con ASID" : "se vacía al cambiar de proceso")
+       << "; alcance de " << p.entradas * paginaKB << " KB";
+    return os.str();
+}
+
+class TLB
+{
+public:
+    uint64_t aciertos = 0, fallos = 0, vaciados = 0, invalidaciones = 0;
+
+    explicit TLB(const ParametrosTLB &p)
+        : param(p), numVias(p.vias), mascara((uint64_t)(p.entradas / p.vias) - 1), vias(p.entradas),
+          reloj(0), procesoActual(SIN_PROCESO) {}
+
+    // false si la geometría no sirve: los conjuntos tienen que ser potencia de 2
+    static bool validar(const ParametrosTLB &p, std::string &error)
+    {
+        if (p.entradas <= 0 || p.vias <= 0 || p.entradas % p.vias != 0)
+            return error = "las entradas del TLB tienen que ser un múltiplo de las vías", false;
+        int conjuntos = p.entradas / p.vias;
+        if (conjuntos & (conjuntos - 1))
+            return error = "entradas / vías del TLB tiene que ser potencia de 2", false;
+        if (p.ciclosAcierto < 0 || p.ciclosRecorrido < 0)
+            return error = "los ciclos del TLB no pueden ser negativos", false;
+        return true;
+    }
+
+    const ParametrosTLB &parametros() const { return param; }
+
+    // Busca la traducción y, si no está, la carga después del recorrido.
+    // true si fue acierto.
+    bool traducir(uint64_t clave)
+    {
+        if (!param.conASID && (clave >> 40) != procesoActual)
+        {
+            if (procesoActual != SIN_PROCESO)
+                vaciar();
+            procesoActual = clave >> 40;
+        }
+
+        Via *c = &vias[(size_t)(clave & mascara) * numVias];
+        uint64_t ahora = ++reloj; // en locales: las vías son uint64_t y el compilador
+                                  // no puede suponer que no pisan a los miembros
+        // sin saltos que dependan del contenido: acierto y víctima en una pasada
+        int acierto = -1, victima = 0;
+        uint64_t menor = UINT64_MAX;
+        for (int i = 0; i < numVias; i++)
+        {
+            uint64_t u = c[i].uso;
+            acierto = c[i].clave == clave ? i : acierto;
+            victima = u < menor ? i : victima;
+            menor = u < menor ? u : menor;
+        }
+        // en un acierto se reescribe la misma clave; así tampoco hay salto acá
+        bool acerto = acierto >= 0;
+        int i = acerto ? acierto : victima;
+        c[i].clave = clave;
+        c[i].uso = ahora;
+        aciertos += acerto;
+        fallos += !acerto;
+        return acerto;
+    }
+
+    // La página dejó la RAM o el proceso terminó: su traducción ya no vale
+    void invalidar(uint64_t clave)
+    {
+        Via *c = &vias[(size_t)(clave & mascara) * numVias];
+        for (int i = 0; i < numVias; i++)
+            if (c[i].clave == clave)
+            {
+                c[i] = Via();
+                invalidaciones++;
+                return;
+            }
+    }
+
+    void vaciar()
+    {
+        for (Via &v : vias)
+            v = Via();
+        vaciados++;
+    }
+
+    double tasaAciertos() const { return aciertos + fallos ? (double)aciertos / (aciertos + fallos) : 0; }
+
+    // Costo promedio de una traducción con el modelo de ciclos
+    double ciclosPorTraduccion() const
+    {
+        return param.ciclosAcierto + (1 - tasaAciertos()) * param.ciclosRecorrido;
+    }
+
+private:
+    static const uint64_t VACIA = UINT64_MAX, SIN_PROCESO = UINT64_MAX;
+
+    // 16 bytes por vía: un conjunto de 4 vías ocupa una línea de caché
+    struct Via
+    {
+        uint64_t clave = VACIA;
+        uint64_t uso = 0; // último acceso; 0 = vacía, la primera en reemplazarse
+    };
+
+    ParametrosTLB param;
+    int numVias;
+    uint64_t mascara;
+    std::vector<Via> vias; // el conjunto c ocupa [c * numVias, (c + 1) * numVias)
+    uint64_t reloj, procesoActual;
+};
+
+#endif
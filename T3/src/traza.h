@@ -0,0 +1,289 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include "marcos.h"
+#include "politicas.h"
+#include "prebusqueda.h"
+#include "respaldo.h"
+#include "swap_comprimida.h"
+#include "tlb.h"
+
+// Lo que le pasa a la RAM durante una corrida, en orden. Alcanza para
+// repetir la misma corrida con cualquier política.
+enum TipoEvento : uint8_t
+{
+    EV_COLOCAR = 0, // página creada: va a RAM si hay marco libre, si no a SWAP
+    EV_ACCESO = 1,  // acceso a la página (HIT o PAGE FAULT)
+    EV_LIBERAR = 2, // su proceso terminó
+    EV_COPIA = 3    // copia de una escritura (COW): va a RAM, desalojando si hace falta
+};
+
+struct EventoMemoria
+{
+    uint64_t pagina; // clavePagina(proceso, número)
+    uint8_t tipo;
+};
+
+// Para cada evento, posición del próximo acceso a la misma página (SIN_USO si no hay)
+inline std::vector<uint64_t> calcularProximosUsos(const std::vector<EventoMemoria> &eventos)
+{
+    std::vector<uint64_t> proximo(eventos.size(), SIN_USO);
+    std::unordered_map<uint64_t, uint64_t> siguiente;
+    for (size_t i = eventos.size(); i-- > 0;)
+    {
+        auto it = siguiente.find(eventos[i].pagina);
+        if (eventos[i].tipo == EV_LIBERAR)
+        {
+            if (it != siguiente.end())
+                siguiente.erase(it);
+            continue;
+        }
+        if (it != siguiente.end())
+            proximo[i] = it->second;
+        if (eventos[i].tipo == EV_ACCESO)
+            siguiente[eventos[i].pagina] = i;
+    }
+    return proximo;
+}
+
+struct ResultadoPolitica
+{
+    const char *nombre;
+    uint64_t accesos;
+    uint64_t faults;
+    uint64_t desalojos;
+    double segundos;
+
+    double tasaAciertos() const { return accesos ? 1.0 - (double)faults / accesos : 0.0; }
+    double nsPorAcceso() const { return accesos ? segundos * 1e9 / accesos : 0.0; }
+};
+
+// RAM de 'marcos' marcos con una política, sin datos: solo cuenta. La usan
+// la repetición de eventos y el modo traza. SWAP se supone suficiente.
+class ModeloRAM
+{
+public:
+    uint64_t accesos = 0, faults = 0, desalojos = 0;
+
+    ModeloRAM(int marcos, Politica &p)
+        : politica(p), libres(marcos), paginaEn(marcos, 0), prebuscada(marcos, 0),
+          tlb(nullptr), respaldo(nullptr), prebuscador(nullptr), zswap(nullptr)
+    {
+        marcoDe.reserve((size_t)marcos * 2);
+    }
+
+    // Con TLB cada acceso traduce primero y las páginas que dejan la RAM se invalidan
+    void usarTLB(TLB *t) { tlb = t; }
+    // Con respaldo cada fault mueve bytes de verdad entre la RAM y la SWAP
+    void usarRespaldo(MemoriaRespaldada *r) { respaldo = r; }
+    // Con prebuscador un fault también trae las páginas que este proponga
+    void usarPrebuscador(Prebuscador *p) { prebuscador = p; }
+    // Con pool comprimido las víctimas pasan por él antes de ir a la SWAP
+    void usarSwapComprimida(SwapComprimida *z) { zswap = z; }
+
+    // Página creada: a RAM solo si hay marco libre
+    void colocar(uint64_t pagina)
+    {
+        int m = libres.tomar();
+        if (m == -1)
+            return;
+        paginaEn[m] = pagina;
+        marcoDe[pagina] = m;
+        politica.colocar(m, pagina);
+        if (respaldo)
+            respaldo->falloPorClave(m, false, 0, pagina);
+    }
+
+    // Copia recién hecha: entra a RAM como en un fault, pero el acceso ya
+    // se contó en la página original. false si no hubo víctima.
+    bool copiar(uint64_t pagina)
+    {
+        int m = traer(pagina);
+        if (m == -1)
+            return false;
+        politica.cargar(m, pagina);
+        return true;
+    }
+
+    // false si la política no pudo elegir víctima
+    bool acceder(uint64_t pagina)
+    {
+        accesos++;
+        if (tlb)
+            tlb->traducir(pagina);
+        auto it = marcoDe.find(pagina);
+        if (it != marcoDe.end())
+        {
+            int m = it->second;
+            politica.acceder(m);
+            if (prebuscada[m])
+            {
+                // primer uso de una prebuscada: acertó y dispara la ventana siguiente
+                prebuscada[m] = 0;
+                prebuscador->utiles++;
+                prebuscar(pagina);
+            }
+            return true;
+        }
+
+        faults++;
+        int m = traer(pagina);
+        if (m == -1)
+            return false;
+        politica.cargar(m, pagina);
+        if (prebuscador)
+            prebuscar(pagina);
+        return true;
+    }
+
+    void liberar(uint64_t pagina)
+    {
+        if (respaldo)
+            respaldo->olvidar(pagina);
+        if (zswap)
+            zswap->olvidar(pagina);
+        auto it = marcoDe.find(pagina);
+        if (it == marcoDe.end())
+            return;
+        if (prebuscada[it->second])
+        {
+            prebuscada[it->second] = 0;
+            prebuscador->desperdiciadas++;
+        }
+        politica.quitar(it->second);
+        libres.liberar(it->second);
+        marcoDe.erase(it);
+        if (tlb)
+            tlb->invalidar(pagina);
+    }
+
+private:
+    Politica &politica;
+    AsignadorMarcos libres;
+    std::vector<uint64_t> paginaEn;
+    std::vector<uint8_t> prebuscada; // marco con una página prebuscada que todavía no se usó
+    std::unordered_map<uint64_t, int> marcoDe; // solo las páginas en RAM
+    TLB *tlb;
+    MemoriaRespaldada *respaldo;
+    Prebuscador *prebuscador;
+    SwapComprimida *zswap;
+    std::vector<uint64_t> candidatas;
+
+    // Marco para 'pagina', libre o desalojando; la política todavía no la conoce
+    int traer(uint64_t pagina)
+    {
+        int m = libres.tomar();
+        bool hayDesalojo = m == -1;
+        if (hayDesalojo)
+        {
+            m = politica.desalojar(pagina);
+            if (m == -1)
+                return -1;
+            marcoDe.erase(paginaEn[m]);
+            if (tlb)
+                tlb->invalidar(paginaEn[m]);
+            if (prebuscada[m])
+            {
+                prebuscada[m] = 0;
+                prebuscador->desperdiciadas++;
+            }
+            desalojos++;
+        }
+        if (respaldo)
+            respaldo->falloPorClave(m, hayDesalojo, paginaEn[m], pagina);
+        if (zswap)
+        {
+            // la entrante sale primero: deja lugar en el pool para la víctima
+            zswap->traer(pagina);
+            if (hayDesalojo)
+                zswap->guardar(paginaEn[m]);
+        }
+        paginaEn[m] = pagina;
+        marcoDe[pagina] = m;
+        return m;
+    }
+
+    // Las candidatas del mismo proceso que no estén en RAM se cargan como en
+    // un fault. Con colocar() la LRU las pondría como las más frías y cada
+    // prebuscada desalojaría a la anterior.
+    void prebuscar(uint64_t pagina)
+    {
+        uint32_t proceso = (uint32_t)(pagina >> 40);
+        prebuscador->observar(proceso, pagina & ((1ull << 40) - 1), candidatas);
+        for (uint64_t c : candidatas)
+        {
+            uint64_t clave = clavePagina(proceso, c);
+            if (marcoDe.count(clave))
+                continue;
+            uint64_t antes = desalojos;
+            int m = traer(clave);
+            prebuscador->desalojos += desalojos - antes;
+            if (m == -1)
+                return;
+            politica.cargar(m, clave);
+            prebuscada[m] = 1;
+            prebuscador->traidas++;
+        }
+    }
+};
+
+// Repite los eventos sobre una RAM de 'marcos' marcos con la política dada.
+// La corrida original ya terminó si SWAP no alcanzaba.
+inline ResultadoPolitica reproducirEventos(const std::vector<EventoMemoria> &eventos, int marcos,
+                                           Politica &politica, const std::vector<uint64_t> *proximos)
+{
+    ModeloRAM ram(marcos, politica);
+    auto inicio = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < eventos.size(); i++)
+    {
+        const EventoMemoria &e = eventos[i];
+        if (e.tipo == EV_LIBERAR)
+        {
+            ram.liberar(e.pagina);
+            continue;
+        }
+        if (proximos)
+            politica.siguienteUso((*proximos)[i]);
+        if (e.tipo == EV_COLOCAR)
+            ram.colocar(e.pagina);
+        else if (!(e.tipo == EV_COPIA ? ram.copiar(e.pagina) : ram.acceder(e.pagina)))
+            break;
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return {politica.nombre(), ram.accesos, ram.faults, ram.desalojos, segundos};
+}
+
+// Todas las políticas (OPT con los próximos usos) sobre los mismos eventos, en una tabla
+inline std::vector<ResultadoPolitica> compararPoliticas(const std::vector<EventoMemoria> &eventos, int marcos)
+{
+    std::vector<uint64_t> proximos = calcularProximosUsos(eventos);
+    std::vector<ResultadoPolitica> resultados;
+    for (const char *nombre : NOMBRES_POLITICAS)
+    {
+        std::unique_ptr<Politica> p = crearPolitica(nombre, marcos);
+        resultados.push_back(reproducirEventos(eventos, marcos, *p, p->necesitaFuturo() ? &proximos : nullptr));
+    }
+    return resultados;
+}
+
+inline void imprimirComparacion(const std::vector<ResultadoPolitica> &resultados, std::ostream &salida = std::cout)
+{
+    char linea[128];
+    snprintf(linea, sizeof(linea), "%-9s %12s %12s %12s %10s %10s\n", "política", "accesos", "faults", "desalojos", "aciertos", "ns/acceso");
+    salida << linea;
+    for (const ResultadoPolitica &r : resultados)
+    {
+        snprintf(linea, sizeof(linea), "%-8s %12llu %12llu %12llu %9.2f%% %10.1f\n", r.nombre,
+                 (unsigned long long)r.accesos, (unsigned long long)r.faults,
+                 (unsigned long long)r.desalojos, r.tasaAciertos() * 100, r.nsPorAcceso());
+        salida << linea;
+    }
+}
+
+#endif